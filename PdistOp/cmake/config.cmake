@@ -35,6 +35,9 @@ endif()
 if (NOT DEFINED ASCEND_PACK_SHARED_LIBRARY)
     set(ASCEND_PACK_SHARED_LIBRARY False CACHE BOOL "")
 endif()
+if (NOT DEFINED ENABLE_PDIST_PROFILE)
+    set(ENABLE_PDIST_PROFILE False CACHE BOOL "")
+endif()
 set(ASCEND_TENSOR_COMPILER_PATH ${ASCEND_CANN_PACKAGE_PATH}/compiler)
 set(ASCEND_CCEC_COMPILER_PATH ${ASCEND_TENSOR_COMPILER_PATH}/ccec_compiler/bin)
 set(ASCEND_AUTOGEN_PATH ${CMAKE_BINARY_DIR}/autogen)
@@ -20,4 +20,10 @@ REGISTER_CUSTOM_OP("Pdist")
     .FrameworkType(TENSORFLOW)   // type: CAFFE, TENSORFLOW
     .OriginOpType("Pdist")      // name in tf module
     .ParseParamsByOperatorFn(AutoMappingByOpFn);
+
+// Pdist 的反向: (x, y, grad_y) -> grad_x
+REGISTER_CUSTOM_OP("PdistGrad")
+    .FrameworkType(TENSORFLOW)
+    .OriginOpType("PdistGrad")
+    .ParseParamsByOperatorFn(AutoMappingByOpFn);
 }  // namespace domi
@@ -0,0 +1,252 @@
+/**
+ * @file pdist_async.cpp
+ * @brief Asynchronous stream-pool Pdist executor implementation
+ */
+
+#include "pdist_async.h"
+
+#include <utility>
+#include "aclnn_pdist.h"
+
+namespace pdist {
+
+namespace {
+
+std::future<aclError> ReadyFuture(aclError status) {
+    std::promise<aclError> promise;
+    promise.set_value(status);
+    return promise.get_future();
+}
+
+// 按需扩大 lane 独占的 device buffer；lane 空闲时旧 buffer 已不被 device 访问
+aclError EnsureDeviceBuffer(void*& buffer, uint64_t& capacity, uint64_t size) {
+    if (size <= capacity) {
+        return ACL_SUCCESS;
+    }
+    if (buffer != nullptr) {
+        aclrtFree(buffer);
+        buffer = nullptr;
+        capacity = 0;
+    }
+    PDIST_CHECK(aclrtMalloc(&buffer, size, ACL_MEM_MALLOC_HUGE_FIRST));
+    capacity = size;
+    return ACL_SUCCESS;
+}
+
+} // namespace
+
+PdistAsyncExecutor::PdistAsyncExecutor(const AsyncConfig& config, aclDataType dtype, uint64_t m, float p)
+    : config_(config), dtype_(dtype), elementSize_(ElementSize(dtype)), m_(m), p_(p), initStatus_(ACL_SUCCESS),
+      context_(nullptr), stopReport_(false) {
+    initStatus_ = Init();
+}
+
+PdistAsyncExecutor::~PdistAsyncExecutor() {
+    Release();
+}
+
+aclError PdistAsyncExecutor::Init() {
+    if (elementSize_ == 0 || m_ == 0 || config_.streamNum == 0) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    PDIST_CHECK(aclrtSetDevice(config_.deviceId));
+    PDIST_CHECK(aclrtGetCurrentContext(&context_));
+
+    // 回调线程先启动，stream 创建后订阅到该线程，aclrtLaunchCallback 的回调都在这里执行
+    reportThread_ = std::thread([this]() { ReportLoop(); });
+    const uint64_t reportThreadId = static_cast<uint64_t>(reportThread_.native_handle());
+
+    for (uint32_t s = 0; s < config_.streamNum; ++s) {
+        std::unique_ptr<Lane> lane(new Lane());
+        lane->owner = this;
+        lane->stream = nullptr;
+        lane->xDev = nullptr;
+        lane->yDev = nullptr;
+        lane->workspace = nullptr;
+        lane->xBytes = 0;
+        lane->yBytes = 0;
+        lane->workspaceSize = 0;
+        lane->tensors[0] = nullptr;
+        lane->tensors[1] = nullptr;
+        PDIST_CHECK(aclrtCreateStream(&lane->stream));
+        aclError ret = aclrtSubscribeReport(reportThreadId, lane->stream);
+        if (ret != ACL_SUCCESS) {
+            aclrtDestroyStream(lane->stream);
+            return ret;
+        }
+        freeLanes_.push_back(lane.get());
+        lanes_.push_back(std::move(lane));
+    }
+    return ACL_SUCCESS;
+}
+
+void PdistAsyncExecutor::Release() {
+    WaitAll();
+    if (reportThread_.joinable()) {
+        const uint64_t reportThreadId = static_cast<uint64_t>(reportThread_.native_handle());
+        for (size_t k = 0; k < lanes_.size(); ++k) {
+            aclrtUnSubscribeReport(reportThreadId, lanes_[k]->stream);
+        }
+        stopReport_ = true;
+        reportThread_.join();
+    }
+    for (size_t k = 0; k < lanes_.size(); ++k) {
+        Lane& lane = *lanes_[k];
+        if (lane.workspace != nullptr) aclrtFree(lane.workspace);
+        if (lane.xDev != nullptr) aclrtFree(lane.xDev);
+        if (lane.yDev != nullptr) aclrtFree(lane.yDev);
+        aclrtDestroyStream(lane.stream);
+    }
+    lanes_.clear();
+    freeLanes_.clear();
+}
+
+void PdistAsyncExecutor::ReportLoop() {
+    aclrtSetCurrentContext(context_);
+    while (!stopReport_) {
+        // 超时只表示这段时间内没有完成的任务，继续轮询
+        aclrtProcessReport(config_.reportTimeoutMs);
+    }
+}
+
+aclError PdistAsyncExecutor::RegisterHostBuffer(void* ptr, size_t bytes) {
+    if (ptr == nullptr || bytes == 0) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    std::lock_guard<std::mutex> lock(rangeMutex_);
+    HostRange range = {static_cast<const uint8_t*>(ptr), bytes};
+    ranges_.push_back(range);
+    return ACL_SUCCESS;
+}
+
+aclError PdistAsyncExecutor::UnregisterHostBuffer(void* ptr) {
+    std::lock_guard<std::mutex> lock(rangeMutex_);
+    for (size_t k = 0; k < ranges_.size(); ++k) {
+        if (ranges_[k].begin == static_cast<const uint8_t*>(ptr)) {
+            ranges_.erase(ranges_.begin() + k);
+            return ACL_SUCCESS;
+        }
+    }
+    return ACL_ERROR_INVALID_PARAM;
+}
+
+bool PdistAsyncExecutor::IsRegistered(const void* ptr, size_t bytes) {
+    const uint8_t* begin = static_cast<const uint8_t*>(ptr);
+    std::lock_guard<std::mutex> lock(rangeMutex_);
+    for (size_t k = 0; k < ranges_.size(); ++k) {
+        const HostRange& range = ranges_[k];
+        if (begin >= range.begin && bytes <= range.bytes &&
+            static_cast<size_t>(begin - range.begin) <= range.bytes - bytes) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PdistAsyncExecutor::Lane* PdistAsyncExecutor::AcquireLane() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    laneFree_.wait(lock, [this]() { return !freeLanes_.empty(); });
+    Lane* lane = freeLanes_.back();
+    freeLanes_.pop_back();
+    return lane;
+}
+
+std::future<aclError> PdistAsyncExecutor::Submit(const AsyncRequest& request, const AsyncCallback& callback) {
+    aclError status = initStatus_;
+    if (status == ACL_SUCCESS) {
+        bool valid = request.xHost != nullptr && request.yHost != nullptr && request.n >= 2 &&
+                     IsRegistered(request.xHost, request.n * m_ * elementSize_) &&
+                     IsRegistered(request.yHost, CondensedSize(request.n) * elementSize_);
+        status = valid ? ACL_SUCCESS : ACL_ERROR_INVALID_PARAM;
+    }
+    if (status != ACL_SUCCESS) {
+        if (callback) {
+            callback(status, request);
+        }
+        return ReadyFuture(status);
+    }
+
+    Lane* lane = AcquireLane();
+    lane->request = request;
+    lane->callback = callback;
+    lane->promise = std::promise<aclError>();
+    std::future<aclError> future = lane->promise.get_future();
+
+    // Submit 可能来自任意线程，入队前绑定执行器所在 device 的 context
+    status = aclrtSetCurrentContext(context_);
+    if (status == ACL_SUCCESS) {
+        status = Enqueue(*lane);
+    }
+    if (status != ACL_SUCCESS) {
+        // 部分任务可能已入队: 等它们结束后 lane 的 buffer 才能再次使用
+        aclrtSynchronizeStream(lane->stream);
+        Complete(*lane, status);
+    }
+    return future;
+}
+
+aclError PdistAsyncExecutor::Enqueue(Lane& lane) {
+    const uint64_t n = lane.request.n;
+    const uint64_t xBytes = n * m_ * elementSize_;
+    const uint64_t yBytes = CondensedSize(n) * elementSize_;
+    PDIST_CHECK(EnsureDeviceBuffer(lane.xDev, lane.xBytes, xBytes));
+    PDIST_CHECK(EnsureDeviceBuffer(lane.yDev, lane.yBytes, yBytes));
+
+    // 1. H2D: 源为已登记的 pinned 内存，调用线程不等待拷贝
+    PDIST_CHECK(aclrtMemcpyAsync(lane.xDev, lane.xBytes, lane.request.xHost, xBytes, ACL_MEMCPY_HOST_TO_DEVICE,
+                                 lane.stream));
+
+    // 2. Kernel
+    int64_t xShape[] = {static_cast<int64_t>(n), static_cast<int64_t>(m_)};
+    int64_t yShape[] = {static_cast<int64_t>(CondensedSize(n))};
+    lane.tensors[0] = aclCreateTensor(xShape, 2, dtype_, nullptr, 0, aclFormat::ACL_FORMAT_ND, xShape, 2, lane.xDev);
+    lane.tensors[1] = aclCreateTensor(yShape, 1, dtype_, nullptr, 0, aclFormat::ACL_FORMAT_ND, yShape, 1, lane.yDev);
+    uint64_t workspaceSize = 0;
+    aclOpExecutor* executor = nullptr;
+    char nanPolicy[] = "propagate";
+    PDIST_CHECK(aclnnPdistGetWorkspaceSize(lane.tensors[0], nullptr, p_, nanPolicy, lane.tensors[1], nullptr,
+                                           &workspaceSize, &executor));
+    PDIST_CHECK(EnsureDeviceBuffer(lane.workspace, lane.workspaceSize, workspaceSize));
+    PDIST_CHECK(aclnnPdist(lane.workspace, workspaceSize, executor, lane.stream));
+
+    // 3. D2H，之后挂完成回调: stream 上此前的任务全部结束后才会执行
+    PDIST_CHECK(aclrtMemcpyAsync(lane.request.yHost, yBytes, lane.yDev, yBytes, ACL_MEMCPY_DEVICE_TO_HOST,
+                                 lane.stream));
+    PDIST_CHECK(aclrtLaunchCallback(OnStreamDone, &lane, ACL_CALLBACK_NO_BLOCK, lane.stream));
+    return ACL_SUCCESS;
+}
+
+void PdistAsyncExecutor::OnStreamDone(void* userData) {
+    Lane* lane = static_cast<Lane*>(userData);
+    lane->owner->Complete(*lane, ACL_SUCCESS);
+}
+
+void PdistAsyncExecutor::Complete(Lane& lane, aclError status) {
+    for (int t = 0; t < 2; ++t) {
+        if (lane.tensors[t] != nullptr) {
+            aclDestroyTensor(lane.tensors[t]);
+            lane.tensors[t] = nullptr;
+        }
+    }
+    // 先取出本次请求的状态再归还 lane，归还后 lane 可能立即被另一个 Submit 复用
+    AsyncRequest request = lane.request;
+    AsyncCallback callback = std::move(lane.callback);
+    std::promise<aclError> promise = std::move(lane.promise);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        freeLanes_.push_back(&lane);
+    }
+    laneFree_.notify_all();
+
+    if (callback) {
+        callback(status, request);
+    }
+    promise.set_value(status);
+}
+
+void PdistAsyncExecutor::WaitAll() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    laneFree_.wait(lock, [this]() { return freeLanes_.size() == lanes_.size(); });
+}
+
+} // namespace pdist
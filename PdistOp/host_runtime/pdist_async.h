@@ -0,0 +1,119 @@
+/**
+ * @file pdist_async.h
+ * @brief Asynchronous, stream-ordered Pdist host API: each request enqueues H2D, aclnnPdist and
+ *        D2H on a stream from a pool and completes through a future and an optional callback, so
+ *        the calling thread never synchronises and independent requests overlap.
+ */
+
+#ifndef PDIST_ASYNC_H
+#define PDIST_ASYNC_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "acl/acl.h"
+#include "aclnn/acl_meta.h"
+#include "pdist_runtime_common.h"
+
+namespace pdist {
+
+// 一次请求: x 为 n x m 的行主序输入，y 接收 CondensedSize(n) 个元素的压缩输出
+// 两者都须位于 RegisterHostBuffer 登记过的 pinned 内存中 (aclrtMallocHost 分配)，DMA 才能真正异步
+struct AsyncRequest {
+    const void* xHost;
+    void* yHost;
+    uint64_t n;
+};
+
+// 完成回调在执行器的回调线程中调用 (早于 future 就绪)，不应长时间阻塞；池满时在回调里 Submit 会死锁
+typedef std::function<void(aclError status, const AsyncRequest& request)> AsyncCallback;
+
+struct AsyncConfig {
+    int32_t deviceId;
+    // stream 池大小，即同时在途的请求数上限；池满时 Submit 等待最早的一个请求完成
+    uint32_t streamNum;
+    // 回调线程调用 aclrtProcessReport 的超时 (毫秒)，决定关闭时的最长等待
+    int32_t reportTimeoutMs;
+
+    AsyncConfig() : deviceId(0), streamNum(4), reportTimeoutMs(100) {}
+};
+
+class PDIST_API PdistAsyncExecutor {
+public:
+    PdistAsyncExecutor(const AsyncConfig& config, aclDataType dtype, uint64_t m, float p);
+    // 等待全部在途请求完成后释放 stream 与 device buffer
+    ~PdistAsyncExecutor();
+
+    PdistAsyncExecutor(const PdistAsyncExecutor&) = delete;
+    PdistAsyncExecutor& operator=(const PdistAsyncExecutor&) = delete;
+
+    // 登记 / 注销调用方持有的 pinned host buffer；请求中的地址范围必须落在某个已登记的 buffer 内
+    aclError RegisterHostBuffer(void* ptr, size_t bytes);
+    aclError UnregisterHostBuffer(void* ptr);
+
+    // 在空闲 stream 上入队 H2D / kernel / D2H 后立即返回 (池满时先等待)；可从多个线程调用
+    // 参数错误或入队失败时 future 直接就绪为对应错误码，callback 同样会被调用一次
+    std::future<aclError> Submit(const AsyncRequest& request, const AsyncCallback& callback = AsyncCallback());
+
+    // 等待此前提交的全部请求完成
+    void WaitAll();
+
+private:
+    // 一个 stream 及其独占的 device buffer，从 Submit 到完成回调期间为忙
+    struct Lane {
+        PdistAsyncExecutor* owner;
+        aclrtStream stream;
+        void* xDev;
+        void* yDev;
+        void* workspace;
+        uint64_t xBytes;
+        uint64_t yBytes;
+        uint64_t workspaceSize;
+        aclTensor* tensors[2];
+        AsyncRequest request;
+        AsyncCallback callback;
+        std::promise<aclError> promise;
+    };
+
+    struct HostRange {
+        const uint8_t* begin;
+        size_t bytes;
+    };
+
+    aclError Init();
+    void Release();
+    bool IsRegistered(const void* ptr, size_t bytes);
+    Lane* AcquireLane();
+    aclError Enqueue(Lane& lane);
+    void Complete(Lane& lane, aclError status);
+    void ReportLoop();
+    static void OnStreamDone(void* userData);
+
+    AsyncConfig config_;
+    aclDataType dtype_;
+    size_t elementSize_;
+    uint64_t m_;
+    float p_;
+    aclError initStatus_;
+    aclrtContext context_;
+
+    std::vector<std::unique_ptr<Lane>> lanes_;
+    std::vector<Lane*> freeLanes_;
+    std::mutex mutex_;
+    std::condition_variable laneFree_;
+
+    std::mutex rangeMutex_;
+    std::vector<HostRange> ranges_;
+
+    std::thread reportThread_;
+    std::atomic<bool> stopReport_;
+};
+
+} // namespace pdist
+
+#endif // PDIST_ASYNC_H
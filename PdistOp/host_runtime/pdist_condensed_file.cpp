@@ -0,0 +1,189 @@
+/**
+ * @file pdist_condensed_file.cpp
+ * @brief Memory-mapped on-disk format for condensed Pdist outputs
+ */
+
+#include "pdist_condensed_file.h"
+
+#include <fcntl.h>
+#include <limits>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace pdist {
+
+namespace {
+const char CONDENSED_FILE_MAGIC[8] = {'P', 'D', 'I', 'S', 'T', 'C', 'F', '1'};
+} // namespace
+
+CondensedFileWriter::~CondensedFileWriter() {
+    Close();
+}
+
+aclError CondensedFileWriter::Create(const char* path, uint64_t n, aclDataType dtype, float p, uint32_t metric) {
+    if (path == nullptr || ElementSize(dtype) == 0 || fd_ >= 0) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    n_ = n;
+    elementSize_ = ElementSize(dtype);
+    uint64_t dataBytes = CondensedSize(n) * elementSize_;
+    mapBytes_ = static_cast<size_t>(CONDENSED_FILE_DATA_OFFSET + dataBytes);
+
+    fd_ = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        return ACL_ERROR_FAILURE;
+    }
+    if (ftruncate(fd_, static_cast<off_t>(mapBytes_)) != 0) {
+        Close();
+        return ACL_ERROR_FAILURE;
+    }
+    map_ = mmap(nullptr, mapBytes_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        Close();
+        return ACL_ERROR_BAD_ALLOC;
+    }
+
+    CondensedFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, CONDENSED_FILE_MAGIC, sizeof(header.magic));
+    header.version = CONDENSED_FILE_VERSION;
+    header.dtype = static_cast<uint32_t>(dtype);
+    header.n = n;
+    header.metric = metric;
+    header.p = p;
+    header.dataOffset = CONDENSED_FILE_DATA_OFFSET;
+    header.dataBytes = dataBytes;
+    std::memcpy(map_, &header, sizeof(header));
+    return ACL_SUCCESS;
+}
+
+aclError CondensedFileWriter::Write(uint64_t offset, const void* src, uint64_t count) {
+    if (map_ == nullptr || src == nullptr || offset + count > CondensedSize(n_)) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    std::memcpy(static_cast<uint8_t*>(Data()) + offset * elementSize_, src, count * elementSize_);
+    return ACL_SUCCESS;
+}
+
+aclError CondensedFileWriter::WriteFromDevice(uint64_t offset, const void* devSrc, uint64_t count,
+                                              uint64_t chunkElems) {
+    if (map_ == nullptr || devSrc == nullptr || chunkElems == 0 || offset + count > CondensedSize(n_)) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    uint8_t* dst = static_cast<uint8_t*>(Data()) + offset * elementSize_;
+    const uint8_t* src = static_cast<const uint8_t*>(devSrc);
+    // 同步 aclrtMemcpy 允许目的地址为普通 (pageable) 内存，映射区按分块依次缺页落盘
+    for (uint64_t done = 0; done < count; done += chunkElems) {
+        uint64_t elems = (count - done < chunkElems) ? (count - done) : chunkElems;
+        size_t bytes = static_cast<size_t>(elems * elementSize_);
+        aclError ret = aclrtMemcpy(dst + done * elementSize_, bytes, src + done * elementSize_, bytes,
+                                   ACL_MEMCPY_DEVICE_TO_HOST);
+        if (ret != ACL_SUCCESS) {
+            return ret;
+        }
+    }
+    return ACL_SUCCESS;
+}
+
+aclError CondensedFileWriter::Close() {
+    aclError ret = ACL_SUCCESS;
+    if (map_ != nullptr) {
+        if (msync(map_, mapBytes_, MS_SYNC) != 0) {
+            ret = ACL_ERROR_FAILURE;
+        }
+        munmap(map_, mapBytes_);
+        map_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    return ret;
+}
+
+CondensedFileReader::~CondensedFileReader() {
+    Close();
+}
+
+aclError CondensedFileReader::Open(const char* path) {
+    if (path == nullptr || fd_ >= 0) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    fd_ = open(path, O_RDONLY);
+    if (fd_ < 0) {
+        return ACL_ERROR_FAILURE;
+    }
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(CondensedFileHeader)) {
+        Close();
+        return ACL_ERROR_FAILURE;
+    }
+    mapBytes_ = static_cast<size_t>(st.st_size);
+    map_ = mmap(nullptr, mapBytes_, PROT_READ, MAP_SHARED, fd_, 0);
+    if (map_ == MAP_FAILED) {
+        map_ = nullptr;
+        Close();
+        return ACL_ERROR_BAD_ALLOC;
+    }
+
+    // 校验文件头，数据区大小必须与 n / dtype 一致
+    std::memcpy(&header_, map_, sizeof(header_));
+    size_t es = ElementSize(static_cast<aclDataType>(header_.dtype));
+    bool valid = std::memcmp(header_.magic, CONDENSED_FILE_MAGIC, sizeof(header_.magic)) == 0 &&
+                 header_.version == CONDENSED_FILE_VERSION && es != 0 &&
+                 header_.dataBytes == CondensedSize(header_.n) * es &&
+                 header_.dataOffset + header_.dataBytes <= mapBytes_;
+    if (!valid) {
+        Close();
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    // 典型访问是零散的 d(i, j)，关闭预读
+    madvise(map_, mapBytes_, MADV_RANDOM);
+    return ACL_SUCCESS;
+}
+
+void CondensedFileReader::Close() {
+    if (map_ != nullptr) {
+        munmap(map_, mapBytes_);
+        map_ = nullptr;
+    }
+    header_.n = 0;
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+aclError CondensedFileReader::At(uint64_t i, uint64_t j, float* value) const {
+    if (value == nullptr || map_ == nullptr || i >= header_.n || j >= header_.n) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    if (i == j) {
+        *value = 0.0f;
+        return ACL_SUCCESS;
+    }
+    if (i > j) {
+        uint64_t t = i;
+        i = j;
+        j = t;
+    }
+    uint64_t idx = CondensedIndex(header_.n, i, j);
+    if (header_.dtype == ACL_FLOAT16) {
+        uint16_t h;
+        std::memcpy(&h, static_cast<const uint8_t*>(Data()) + idx * sizeof(uint16_t), sizeof(h));
+        *value = HalfToFloat(h);
+        return ACL_SUCCESS;
+    }
+    std::memcpy(value, static_cast<const uint8_t*>(Data()) + idx * sizeof(float), sizeof(float));
+    return ACL_SUCCESS;
+}
+
+float CondensedFileReader::At(uint64_t i, uint64_t j) const {
+    float v = std::numeric_limits<float>::quiet_NaN();
+    At(i, j, &v);
+    return v;
+}
+
+} // namespace pdist
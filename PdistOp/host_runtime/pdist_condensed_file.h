@@ -0,0 +1,86 @@
+/**
+ * @file pdist_condensed_file.h
+ * @brief Memory-mapped on-disk format for condensed Pdist outputs (writer + random-access reader)
+ *
+ * File layout: a 64-byte CondensedFileHeader, zero padding up to dataOffset (page aligned), then the
+ * n * (n - 1) / 2 distances in the standard condensed order used by KernelPdist.
+ */
+
+#ifndef PDIST_CONDENSED_FILE_H
+#define PDIST_CONDENSED_FILE_H
+
+#include "pdist_runtime_common.h"
+
+namespace pdist {
+
+constexpr uint32_t CONDENSED_FILE_VERSION = 1;
+constexpr uint64_t CONDENSED_FILE_DATA_OFFSET = 4096;
+
+struct CondensedFileHeader {
+    char magic[8];       // "PDISTCF1"
+    uint32_t version;
+    uint32_t dtype;      // aclDataType
+    uint64_t n;          // 输入行数
+    uint32_t metric;     // PdistMetric
+    float p;
+    uint64_t dataOffset; // 数据区起始偏移
+    uint64_t dataBytes;  // 数据区字节数
+    uint8_t reserved[16];
+};
+static_assert(sizeof(CondensedFileHeader) == 64, "CondensedFileHeader must stay 64 bytes");
+
+// 写端: 创建文件并整体 mmap，D2H 的每个分块直接落到映射区，host 不持有完整输出
+class PDIST_API CondensedFileWriter {
+public:
+    CondensedFileWriter() : fd_(-1), map_(nullptr), mapBytes_(0), n_(0), elementSize_(0) {}
+    ~CondensedFileWriter();
+
+    aclError Create(const char* path, uint64_t n, aclDataType dtype, float p,
+                    uint32_t metric = PDIST_METRIC_MINKOWSKI);
+    // 将 host 上 count 个元素写到压缩下标 offset 处
+    aclError Write(uint64_t offset, const void* src, uint64_t count);
+    // 将 device 上 count 个元素按 chunkElems 分块直接 D2H 到映射区 offset 处
+    aclError WriteFromDevice(uint64_t offset, const void* devSrc, uint64_t count,
+                             uint64_t chunkElems = (1ULL << 24));
+    // 刷盘并解除映射
+    aclError Close();
+
+    void* Data() const { return (map_ == nullptr) ? nullptr : static_cast<uint8_t*>(map_) + CONDENSED_FILE_DATA_OFFSET; }
+    uint64_t Rows() const { return n_; }
+    size_t ElementBytes() const { return elementSize_; }
+
+private:
+    int fd_;
+    void* map_;
+    size_t mapBytes_;
+    uint64_t n_;
+    size_t elementSize_;
+};
+
+// 读端: 只读 mmap，按需缺页，不做整体加载
+class PDIST_API CondensedFileReader {
+public:
+    CondensedFileReader() : fd_(-1), map_(nullptr), mapBytes_(0), header_() {}
+    ~CondensedFileReader();
+
+    aclError Open(const char* path);
+    void Close();
+
+    const CondensedFileHeader& Header() const { return header_; }
+    const void* Data() const { return (map_ == nullptr) ? nullptr : static_cast<const uint8_t*>(map_) + header_.dataOffset; }
+    // 随机访问 d(i, j)，i 与 j 可任意顺序，i == j 时为 0
+    // 未打开或 i / j 不小于 Header().n 时返回 ACL_ERROR_INVALID_PARAM，*value 不变
+    aclError At(uint64_t i, uint64_t j, float* value) const;
+    // 同上，前置条件: 已成功 Open 且 i, j < Header().n；不满足时返回 NaN
+    float At(uint64_t i, uint64_t j) const;
+
+private:
+    int fd_;
+    void* map_;
+    size_t mapBytes_;
+    CondensedFileHeader header_;
+};
+
+} // namespace pdist
+
+#endif // PDIST_CONDENSED_FILE_H
@@ -0,0 +1,96 @@
+/**
+ * @file pdist_incremental.cpp
+ * @brief Incremental Pdist implementation
+ */
+
+#include "pdist_incremental.h"
+
+#include <cstring>
+
+namespace pdist {
+
+namespace {
+
+// 输入 / 配置的参数检查 (PdistStreamRunner::Init 会拒绝的配置也在这里提前拒绝)
+bool AppendArgsValid(const void* xOld, uint64_t nOld, const void* xNew, uint64_t m, aclDataType dtype,
+                     const StreamConfig& config) {
+    return (xOld != nullptr || nOld == 0) && xNew != nullptr && m > 0 && ElementSize(dtype) != 0 &&
+           config.panelRows >= 2 && config.streamNum > 0;
+}
+
+} // namespace
+
+void ConcatRowSource::CopyRows(uint64_t begin, uint64_t count, void* dst) const {
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    if (begin < nOld_) {
+        uint64_t oldCount = (nOld_ - begin < count) ? (nOld_ - begin) : count;
+        old_.CopyRows(begin, oldCount, out);
+        out += oldCount * rowBytes_;
+        begin += oldCount;
+        count -= oldCount;
+    }
+    if (count > 0) {
+        new_.CopyRows(begin - nOld_, count, out);
+    }
+}
+
+std::vector<PanelTile> BuildAppendTiles(uint64_t nOld, uint64_t k, uint64_t panelRows) {
+    std::vector<PanelTile> tiles;
+    if (panelRows == 0) {
+        return tiles;
+    }
+    // 按行面板遍历，使同一 x_i 面板的 tile 相邻，便于 slot 复用已上传的 x_i
+    for (uint64_t ib = 0; ib < nOld; ib += panelRows) {
+        uint64_t iCount = (nOld - ib < panelRows) ? (nOld - ib) : panelRows;
+        for (uint64_t jb = 0; jb < k; jb += panelRows) {
+            uint64_t jCount = (k - jb < panelRows) ? (k - jb) : panelRows;
+            PanelTile cross = {ib, iCount, nOld + jb, jCount, false};
+            tiles.push_back(cross);
+        }
+    }
+    std::vector<PanelTile> fresh = BuildTriangleTiles(k, panelRows);
+    for (size_t t = 0; t < fresh.size(); ++t) {
+        fresh[t].rowBegin += nOld;
+        fresh[t].colBegin += nOld;
+        tiles.push_back(fresh[t]);
+    }
+    return tiles;
+}
+
+void ExpandCondensed(const void* yOld, uint64_t nOld, uint64_t nNew, size_t elementSize, void* yOut) {
+    const uint8_t* src = static_cast<const uint8_t*>(yOld);
+    uint8_t* dst = static_cast<uint8_t*>(yOut);
+    // 从最后一行往前搬: 每行的目的位置不小于源位置，原地扩展时不会覆盖尚未搬运的数据
+    for (uint64_t r = nOld; r > 1; --r) {
+        uint64_t i = r - 2;
+        uint64_t len = nOld - 1 - i;
+        std::memmove(dst + CondensedRowOffset(nNew, i) * elementSize,
+                     src + CondensedRowOffset(nOld, i) * elementSize, len * elementSize);
+    }
+}
+
+aclError PdistAppendDelta(const void* xOld, uint64_t nOld, const void* xNew, uint64_t k, uint64_t m,
+                          aclDataType dtype, float p, const StreamConfig& config, PanelSink& sink) {
+    if (!AppendArgsValid(xOld, nOld, xNew, m, dtype, config)) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    ConcatRowSource source(xOld, nOld, xNew, k, m, ElementSize(dtype));
+    PdistStreamRunner runner(config, dtype, m, p);
+    return runner.Run(source, BuildAppendTiles(nOld, k, config.panelRows), sink);
+}
+
+aclError PdistAppend(const void* xOld, uint64_t nOld, const void* yOld, const void* xNew, uint64_t k, uint64_t m,
+                     aclDataType dtype, float p, const StreamConfig& config, void* yOut) {
+    // 全部参数先检查完再改写 yOut: yOut 可能就是 yOld，参数错误时调用方的旧结果须保持不变
+    if (yOut == nullptr || (yOld == nullptr && nOld > 1) || !AppendArgsValid(xOld, nOld, xNew, m, dtype, config)) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    uint64_t nNew = nOld + k;
+    if (nOld > 1) {
+        ExpandCondensed(yOld, nOld, nNew, ElementSize(dtype), yOut);
+    }
+    CondensedBufferSink sink(nNew, yOut);
+    return PdistAppendDelta(xOld, nOld, xNew, k, m, dtype, p, config, sink);
+}
+
+} // namespace pdist
@@ -0,0 +1,50 @@
+/**
+ * @file pdist_incremental.h
+ * @brief Incremental Pdist: appends k new rows to an existing result by computing only the
+ *        old x new cross block and the new x new triangle (O(n * k) instead of O(n^2)).
+ */
+
+#ifndef PDIST_INCREMENTAL_H
+#define PDIST_INCREMENTAL_H
+
+#include <vector>
+#include "pdist_stream.h"
+
+namespace pdist {
+
+// 把 xOld (nOld 行) 与 xNew (k 行) 视为拼接后的一个 (nOld + k) 行输入，不做实际拼接
+class PDIST_API ConcatRowSource : public RowSource {
+public:
+    ConcatRowSource(const void* xOld, uint64_t nOld, const void* xNew, uint64_t k, uint64_t m, size_t elementSize)
+        : old_(xOld, nOld, m, elementSize), new_(xNew, k, m, elementSize), nOld_(nOld), k_(k),
+          rowBytes_(m * elementSize) {}
+    uint64_t Rows() const override { return nOld_ + k_; }
+    void CopyRows(uint64_t begin, uint64_t count, void* dst) const override;
+
+private:
+    HostRowSource old_;
+    HostRowSource new_;
+    uint64_t nOld_;
+    uint64_t k_;
+    uint64_t rowBytes_;
+};
+
+// 新增行涉及的全部 tile (全局行号): old x new 交叉块 + new x new 三角
+PDIST_API std::vector<PanelTile> BuildAppendTiles(uint64_t nOld, uint64_t k, uint64_t panelRows);
+
+// 将 nOld 行的压缩输出按 nNew 行的布局重新排布，新增位置保持原值
+// yOut 可以与 yOld 相同 (原地扩展)，此时 buffer 需能容纳 CondensedSize(nNew) 个元素
+PDIST_API void ExpandCondensed(const void* yOld, uint64_t nOld, uint64_t nNew, size_t elementSize, void* yOut);
+
+// 只计算增量部分，结果以拼接后的全局行号交给 sink
+PDIST_API aclError PdistAppendDelta(const void* xOld, uint64_t nOld, const void* xNew, uint64_t k, uint64_t m,
+                                    aclDataType dtype, float p, const StreamConfig& config, PanelSink& sink);
+
+// 由旧结果 yOld 与新增行得到 (nOld + k) 行的完整压缩输出 yOut
+// 参数不合法时返回 ACL_ERROR_INVALID_PARAM 且不改动 yOut；device 侧执行失败时 yOut 的内容不确定
+PDIST_API aclError PdistAppend(const void* xOld, uint64_t nOld, const void* yOld, const void* xNew, uint64_t k,
+                               uint64_t m, aclDataType dtype, float p, const StreamConfig& config, void* yOut);
+
+} // namespace pdist
+
+#endif // PDIST_INCREMENTAL_H
@@ -0,0 +1,173 @@
+/**
+ * @file pdist_pool.cpp
+ * @brief Pinned host / device memory pool implementation
+ */
+
+#include "pdist_pool.h"
+
+#include <cstring>
+
+namespace pdist {
+
+PdistMemoryPool::PdistMemoryPool(size_t maxCachedBytes) : maxCachedBytes_(maxCachedBytes) {
+    cachedBytes_[POOL_HOST_PINNED] = 0;
+    cachedBytes_[POOL_DEVICE] = 0;
+}
+
+PdistMemoryPool::~PdistMemoryPool() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TrimLocked();
+    // 未归还的块也一并释放，避免进程内泄漏 pinned 内存
+    for (auto it = live_.begin(); it != live_.end(); ++it) {
+        FreeBlock(it->second.kind, it->first);
+    }
+    live_.clear();
+}
+
+size_t PdistMemoryPool::SizeClass(size_t bytes) {
+    const size_t minClass = 512;
+    if (bytes <= minClass) {
+        return minClass;
+    }
+    size_t pow2 = minClass;
+    while (pow2 < bytes) {
+        pow2 <<= 1;
+    }
+    // bytes 落在 (pow2 / 2, pow2]，按 pow2 / 8 对齐，浪费不超过 25%
+    size_t step = pow2 >> 3;
+    return (bytes + step - 1) / step * step;
+}
+
+void PdistMemoryPool::FreeBlock(PoolMemoryKind kind, void* ptr) {
+    if (kind == POOL_HOST_PINNED) {
+        aclrtFreeHost(ptr);
+    } else {
+        aclrtFree(ptr);
+    }
+}
+
+aclError PdistMemoryPool::Acquire(PoolMemoryKind kind, size_t bytes, void** ptr) {
+    if (ptr == nullptr || (kind != POOL_HOST_PINNED && kind != POOL_DEVICE)) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    *ptr = nullptr;
+    if (bytes == 0) {
+        return ACL_SUCCESS;
+    }
+    const size_t classBytes = SizeClass(bytes);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = freeBlocks_[kind].find(classBytes);
+        if (it != freeBlocks_[kind].end() && !it->second.empty()) {
+            *ptr = it->second.back();
+            it->second.pop_back();
+            cachedBytes_[kind] -= classBytes;
+            Block block = {kind, classBytes};
+            live_[*ptr] = block;
+            return ACL_SUCCESS;
+        }
+    }
+
+    // 分配放在锁外，其它线程的复用不会被较慢的 aclrtMallocHost 阻塞
+    void* mem = nullptr;
+    if (kind == POOL_HOST_PINNED) {
+        PDIST_CHECK(aclrtMallocHost(&mem, classBytes));
+    } else {
+        PDIST_CHECK(aclrtMalloc(&mem, classBytes, ACL_MEM_MALLOC_HUGE_FIRST));
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Block block = {kind, classBytes};
+    live_[mem] = block;
+    *ptr = mem;
+    return ACL_SUCCESS;
+}
+
+void PdistMemoryPool::Release(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = live_.find(ptr);
+    if (it == live_.end()) {
+        return;
+    }
+    Block block = it->second;
+    live_.erase(it);
+    if (maxCachedBytes_ != 0 && cachedBytes_[block.kind] + block.classBytes > maxCachedBytes_) {
+        FreeBlock(block.kind, ptr);
+        return;
+    }
+    freeBlocks_[block.kind][block.classBytes].push_back(ptr);
+    cachedBytes_[block.kind] += block.classBytes;
+}
+
+void PdistMemoryPool::Trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TrimLocked();
+}
+
+void PdistMemoryPool::TrimLocked() {
+    for (uint32_t kind = POOL_HOST_PINNED; kind <= POOL_DEVICE; ++kind) {
+        for (auto it = freeBlocks_[kind].begin(); it != freeBlocks_[kind].end(); ++it) {
+            for (size_t k = 0; k < it->second.size(); ++k) {
+                FreeBlock(static_cast<PoolMemoryKind>(kind), it->second[k]);
+            }
+        }
+        freeBlocks_[kind].clear();
+        cachedBytes_[kind] = 0;
+    }
+}
+
+size_t PdistMemoryPool::CachedBytes(PoolMemoryKind kind) {
+    if (kind != POOL_HOST_PINNED && kind != POOL_DEVICE) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cachedBytes_[kind];
+}
+
+aclError AcquireCallBuffers(PdistMemoryPool& pool, uint64_t n, uint64_t m, aclDataType dtype,
+                            PdistCallBuffers* buffers) {
+    const size_t es = ElementSize(dtype);
+    if (buffers == nullptr || es == 0 || n == 0 || m == 0) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    std::memset(buffers, 0, sizeof(PdistCallBuffers));
+    buffers->xBytes = n * m * es;
+    buffers->yBytes = CondensedSize(n) * es;
+
+    aclError ret = pool.Acquire(POOL_HOST_PINNED, buffers->xBytes, &buffers->xHost);
+    if (ret == ACL_SUCCESS) ret = pool.Acquire(POOL_HOST_PINNED, buffers->yBytes, &buffers->yHost);
+    if (ret == ACL_SUCCESS) ret = pool.Acquire(POOL_DEVICE, buffers->xBytes, &buffers->xDev);
+    if (ret == ACL_SUCCESS) ret = pool.Acquire(POOL_DEVICE, buffers->yBytes, &buffers->yDev);
+    if (ret != ACL_SUCCESS) {
+        ReleaseCallBuffers(pool, buffers);
+    }
+    return ret;
+}
+
+aclError AcquireWorkspace(PdistMemoryPool& pool, uint64_t workspaceSize, PdistCallBuffers* buffers) {
+    if (buffers == nullptr) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    pool.Release(buffers->workspace);
+    buffers->workspace = nullptr;
+    buffers->workspaceSize = 0;
+    PDIST_CHECK(pool.Acquire(POOL_DEVICE, workspaceSize, &buffers->workspace));
+    buffers->workspaceSize = workspaceSize;
+    return ACL_SUCCESS;
+}
+
+void ReleaseCallBuffers(PdistMemoryPool& pool, PdistCallBuffers* buffers) {
+    if (buffers == nullptr) {
+        return;
+    }
+    pool.Release(buffers->xHost);
+    pool.Release(buffers->yHost);
+    pool.Release(buffers->xDev);
+    pool.Release(buffers->yDev);
+    pool.Release(buffers->workspace);
+    std::memset(buffers, 0, sizeof(PdistCallBuffers));
+}
+
+} // namespace pdist
@@ -0,0 +1,87 @@
+/**
+ * @file pdist_pool.h
+ * @brief Reusable pinned host / device memory pool for repeated aclnnPdist calls
+ *
+ * Blocks are bucketed by size class (four classes per power of two), so calls whose shapes fall
+ * into the same class reuse one aclrtMallocHost / aclrtMalloc allocation instead of allocating,
+ * page-locking and freeing per call.
+ */
+
+#ifndef PDIST_POOL_H
+#define PDIST_POOL_H
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "acl/acl.h"
+#include "pdist_runtime_common.h"
+
+namespace pdist {
+
+enum PoolMemoryKind : uint32_t {
+    POOL_HOST_PINNED = 0,
+    POOL_DEVICE = 1,
+};
+
+class PDIST_API PdistMemoryPool {
+public:
+    // maxCachedBytes: 空闲块总量上限 (按 host / device 分别统计)，超出时归还的块直接释放；0 表示不限
+    explicit PdistMemoryPool(size_t maxCachedBytes = 0);
+    // 释放全部空闲块与未归还的块；device 块须确保相关 stream 已同步
+    ~PdistMemoryPool();
+
+    PdistMemoryPool(const PdistMemoryPool&) = delete;
+    PdistMemoryPool& operator=(const PdistMemoryPool&) = delete;
+
+    // 取一块至少 bytes 字节的内存，优先复用同一尺寸类的空闲块；bytes 为 0 时返回 nullptr
+    aclError Acquire(PoolMemoryKind kind, size_t bytes, void** ptr);
+    // 归还 Acquire 得到的块 (nullptr 忽略)；device 块只能在使用它的任务完成后归还
+    void Release(void* ptr);
+    // 释放全部空闲块，已借出的块不受影响
+    void Trim();
+
+    size_t CachedBytes(PoolMemoryKind kind);
+
+    // bytes 向上取整后的尺寸类: (2^(k-1), 2^k] 按 2^(k-3) 对齐，即每个 2 的幂区间 4 个尺寸类，最小 512 字节
+    static size_t SizeClass(size_t bytes);
+
+private:
+    struct Block {
+        PoolMemoryKind kind;
+        size_t classBytes;
+    };
+
+    static void FreeBlock(PoolMemoryKind kind, void* ptr);
+    void TrimLocked();
+
+    size_t maxCachedBytes_;
+    std::mutex mutex_;
+    std::unordered_map<void*, Block> live_;
+    std::map<size_t, std::vector<void*>> freeBlocks_[2];
+    size_t cachedBytes_[2];
+};
+
+// 一次 aclnnPdist 调用所需的 staging / device buffer: n x m 输入与 CondensedSize(n) 输出
+// workspace 大小要在 aclnnPdistGetWorkspaceSize 之后才知道，另用 AcquireWorkspace 取得
+struct PdistCallBuffers {
+    void* xHost;
+    void* yHost;
+    void* xDev;
+    void* yDev;
+    void* workspace;
+    size_t xBytes;
+    size_t yBytes;
+    uint64_t workspaceSize;
+};
+
+// 按 n / m / dtype 从池中取全部输入输出 buffer，失败时已取得的块会归还
+PDIST_API aclError AcquireCallBuffers(PdistMemoryPool& pool, uint64_t n, uint64_t m, aclDataType dtype,
+                                      PdistCallBuffers* buffers);
+PDIST_API aclError AcquireWorkspace(PdistMemoryPool& pool, uint64_t workspaceSize, PdistCallBuffers* buffers);
+// 归还全部 buffer 并清空指针；调用前须同步执行该调用的 stream
+PDIST_API void ReleaseCallBuffers(PdistMemoryPool& pool, PdistCallBuffers* buffers);
+
+} // namespace pdist
+
+#endif // PDIST_POOL_H
@@ -0,0 +1,80 @@
+/**
+ * @file pdist_profile.cpp
+ * @brief Host decoder for KernelPdist profiling counters
+ */
+
+#include "pdist_profile.h"
+
+namespace pdist {
+
+namespace {
+double CyclesToUs(uint64_t cycles) {
+    return static_cast<double>(cycles) * 1.0e6 / PDIST_PROFILE_CYCLE_HZ;
+}
+
+double Percent(uint64_t part, uint64_t whole) {
+    return (whole == 0) ? 0.0 : 100.0 * static_cast<double>(part) / static_cast<double>(whole);
+}
+} // namespace
+
+aclError ResetPdistProfile(void* workspace, uint64_t workspaceSize, aclrtStream stream) {
+    if (workspace == nullptr || workspaceSize < PDIST_PROFILE_REGION_BYTES) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    uint8_t* region = static_cast<uint8_t*>(workspace) + (workspaceSize - PDIST_PROFILE_REGION_BYTES);
+    return aclrtMemsetAsync(region, PDIST_PROFILE_REGION_BYTES, 0, PDIST_PROFILE_REGION_BYTES, stream);
+}
+
+aclError ReadPdistProfile(const void* workspace, uint64_t workspaceSize, std::vector<PdistProfileRecord>& records) {
+    records.clear();
+    if (workspace == nullptr || workspaceSize < PDIST_PROFILE_REGION_BYTES) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    std::vector<PdistProfileRecord> raw(PDIST_PROFILE_MAX_CORES);
+    const uint8_t* region = static_cast<const uint8_t*>(workspace) + (workspaceSize - PDIST_PROFILE_REGION_BYTES);
+    aclError ret = aclrtMemcpy(raw.data(), PDIST_PROFILE_REGION_BYTES, region, PDIST_PROFILE_REGION_BYTES,
+                               ACL_MEMCPY_DEVICE_TO_HOST);
+    if (ret != ACL_SUCCESS) {
+        return ret;
+    }
+    for (size_t c = 0; c < raw.size(); ++c) {
+        if (raw[c].magic == PDIST_PROFILE_MAGIC) {
+            records.push_back(raw[c]);
+        }
+    }
+    return ACL_SUCCESS;
+}
+
+void PrintPdistProfile(const std::vector<PdistProfileRecord>& records, FILE* out) {
+    if (records.empty()) {
+        fprintf(out, "[PROFILE] no records (kernel not built with PDIST_PROFILE?)\n");
+        return;
+    }
+    fprintf(out, "[PROFILE] %4s %8s %12s %12s %12s %12s %12s %7s\n", "core", "rows", "pairs", "copyIn(us)",
+            "compute(us)", "writeBk(us)", "total(us)", "stall%");
+    uint64_t maxTotal = 0;
+    uint64_t sumTotal = 0;
+    uint64_t sumCopyIn = 0;
+    uint64_t maxPairs = 0;
+    uint64_t sumPairs = 0;
+    for (size_t c = 0; c < records.size(); ++c) {
+        const PdistProfileRecord& r = records[c];
+        fprintf(out, "[PROFILE] %4u %8llu %12llu %12.1f %12.1f %12.1f %12.1f %6.1f%%\n", r.coreId,
+                static_cast<unsigned long long>(r.rows), static_cast<unsigned long long>(r.pairs),
+                CyclesToUs(r.copyInCycles), CyclesToUs(r.computeCycles), CyclesToUs(r.copyOutCycles),
+                CyclesToUs(r.totalCycles), Percent(r.copyInCycles, r.totalCycles));
+        maxTotal = (r.totalCycles > maxTotal) ? r.totalCycles : maxTotal;
+        maxPairs = (r.pairs > maxPairs) ? r.pairs : maxPairs;
+        sumTotal += r.totalCycles;
+        sumCopyIn += r.copyInCycles;
+        sumPairs += r.pairs;
+    }
+    double meanTotal = static_cast<double>(sumTotal) / records.size();
+    double meanPairs = static_cast<double>(sumPairs) / records.size();
+    // 负载不均衡度: 最慢核 / 平均核，1.0 表示完全均衡
+    fprintf(out, "[PROFILE] cores=%zu  time imbalance (max/mean)=%.3f  pair imbalance=%.3f  copy-in stall=%.1f%%\n",
+            records.size(), (meanTotal > 0) ? maxTotal / meanTotal : 0.0,
+            (meanPairs > 0) ? maxPairs / meanPairs : 0.0, Percent(sumCopyIn, sumTotal));
+}
+
+} // namespace pdist
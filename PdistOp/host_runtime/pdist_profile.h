@@ -0,0 +1,51 @@
+/**
+ * @file pdist_profile.h
+ * @brief Host decoder for the per-core counters written by a -DPDIST_PROFILE build of KernelPdist
+ *
+ * The kernel stores one PdistProfileRecord per core at the start of the user workspace, which is the
+ * last PDIST_PROFILE_REGION_BYTES of the workspace returned by aclnnPdistGetWorkspaceSize.
+ */
+
+#ifndef PDIST_PROFILE_HOST_H
+#define PDIST_PROFILE_HOST_H
+
+#include <cstdio>
+#include <vector>
+#include "pdist_runtime_common.h"
+
+namespace pdist {
+
+// 需与 op_kernel/pdist_profile.h 保持一致
+constexpr uint32_t PDIST_PROFILE_MAX_CORES = 64;
+constexpr uint32_t PDIST_PROFILE_MAGIC = 0x50524F46;
+// GetSystemCycle 的计数频率 (ascend910b 系统计数器为 50 MHz)
+constexpr double PDIST_PROFILE_CYCLE_HZ = 50.0e6;
+
+struct PdistProfileRecord {
+    uint64_t copyInCycles;  // 等待 GM -> UB 搬入
+    uint64_t computeCycles; // Vector 计算 (含规约)
+    uint64_t copyOutCycles; // 结果写回 GM
+    uint64_t totalCycles;   // 本核 Process 总耗时
+    uint64_t pairs;         // 处理的距离对数
+    uint64_t rows;          // 处理的 i 行数
+    uint32_t coreId;
+    uint32_t magic;         // PDIST_PROFILE_MAGIC 表示该核已写入
+    uint64_t reserved;
+};
+static_assert(sizeof(PdistProfileRecord) == 64, "PdistProfileRecord must match the kernel record size");
+
+constexpr uint64_t PDIST_PROFILE_REGION_BYTES = PDIST_PROFILE_MAX_CORES * sizeof(PdistProfileRecord);
+
+// launch 前清零记录区 (异步，挂在 stream 上)，避免读到上一次或未初始化的数据
+PDIST_API aclError ResetPdistProfile(void* workspace, uint64_t workspaceSize, aclrtStream stream);
+
+// stream 同步后调用: 拷回记录区，只保留本次写入的核
+PDIST_API aclError ReadPdistProfile(const void* workspace, uint64_t workspaceSize,
+                                    std::vector<PdistProfileRecord>& records);
+
+// 打印每核的阶段耗时与负载均衡情况
+PDIST_API void PrintPdistProfile(const std::vector<PdistProfileRecord>& records, FILE* out);
+
+} // namespace pdist
+
+#endif // PDIST_PROFILE_HOST_H
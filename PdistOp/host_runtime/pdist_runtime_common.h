@@ -0,0 +1,89 @@
+/**
+ * @file pdist_runtime_common.h
+ * @brief Shared definitions for the Pdist host runtime library (condensed layout helpers)
+ */
+
+#ifndef PDIST_RUNTIME_COMMON_H
+#define PDIST_RUNTIME_COMMON_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "acl/acl.h"
+
+#define PDIST_API __attribute__((visibility("default")))
+
+// ACL 调用失败时直接返回其错误码 (运行时库各实现文件共用)
+#define PDIST_CHECK(expr)                 \
+    do {                                  \
+        aclError ret_ = (expr);           \
+        if (ret_ != ACL_SUCCESS) {        \
+            return ret_;                  \
+        }                                 \
+    } while (0)
+
+namespace pdist {
+
+// 距离度量编号，写入落盘文件头；目前算子只提供 Minkowski-p
+enum PdistMetric : uint32_t {
+    PDIST_METRIC_MINKOWSKI = 0,
+};
+
+// n 行输入对应的压缩 (condensed) 输出长度: n * (n - 1) / 2
+inline uint64_t CondensedSize(uint64_t n) {
+    return (n < 2) ? 0 : n * (n - 1) / 2;
+}
+
+// 第 i 行在压缩输出中的起始位置，即 d(i, i + 1) 的下标
+inline uint64_t CondensedRowOffset(uint64_t n, uint64_t i) {
+    return (2 * n - 1 - i) * i / 2;
+}
+
+// d(i, j) (i < j) 在压缩输出中的下标，与 KernelPdist 的 outIdx 公式一致
+inline uint64_t CondensedIndex(uint64_t n, uint64_t i, uint64_t j) {
+    return CondensedRowOffset(n, i) + (j - i - 1);
+}
+
+// 运行时库支持的输入/输出元素大小，不支持的类型返回 0
+inline size_t ElementSize(aclDataType dtype) {
+    switch (dtype) {
+        case ACL_FLOAT:
+            return 4;
+        case ACL_FLOAT16:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+// IEEE 754 half -> float，供不依赖 ACL 的 host 读取路径使用
+inline float HalfToFloat(uint16_t h) {
+    uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+    uint32_t exp = (h >> 10) & 0x1Fu;
+    uint32_t mant = h & 0x3FFu;
+    uint32_t bits;
+    if (exp == 0) {
+        if (mant == 0) {
+            bits = sign;
+        } else {
+            // 非规格化数: 规格化后再拼接
+            exp = 127 - 15 + 1;
+            while ((mant & 0x400u) == 0) {
+                mant <<= 1;
+                --exp;
+            }
+            bits = sign | (exp << 23) | ((mant & 0x3FFu) << 13);
+        }
+    } else if (exp == 0x1Fu) {
+        bits = sign | 0x7F800000u | (mant << 13);
+    } else {
+        bits = sign | ((exp + 127 - 15) << 23) | (mant << 13);
+    }
+    float f;
+    std::memcpy(&f, &bits, sizeof(f));
+    return f;
+}
+
+} // namespace pdist
+
+#endif // PDIST_RUNTIME_COMMON_H
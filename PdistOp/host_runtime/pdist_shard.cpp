@@ -0,0 +1,119 @@
+/**
+ * @file pdist_shard.cpp
+ * @brief Multi-device Pdist sharding implementation
+ */
+
+#include "pdist_shard.h"
+
+#include <thread>
+
+namespace pdist {
+
+namespace {
+// 每个 device 至少分到的 tile 数，保证连续切分的粒度足够细
+constexpr uint64_t MIN_TILES_PER_DEVICE = 4;
+constexpr uint64_t MIN_SHARD_PANEL_ROWS = 256;
+
+aclError ResolveDevices(const ShardConfig& config, std::vector<int32_t>& devices) {
+    devices = config.deviceIds;
+    if (!devices.empty()) {
+        return ACL_SUCCESS;
+    }
+    uint32_t count = 0;
+    aclError ret = aclrtGetDeviceCount(&count);
+    if (ret != ACL_SUCCESS) {
+        return ret;
+    }
+    for (uint32_t d = 0; d < count; ++d) {
+        devices.push_back(static_cast<int32_t>(d));
+    }
+    return devices.empty() ? ACL_ERROR_INVALID_PARAM : ACL_SUCCESS;
+}
+
+aclError RunShards(const RowSource& source, uint64_t m, aclDataType dtype, float p, const ShardConfig& config,
+                   PanelSink& sink) {
+    std::vector<int32_t> devices;
+    aclError ret = ResolveDevices(config, devices);
+    if (ret != ACL_SUCCESS) {
+        return ret;
+    }
+    uint32_t deviceNum = static_cast<uint32_t>(devices.size());
+    uint64_t panelRows = ShardPanelRows(source.Rows(), deviceNum, config.panelRows);
+    std::vector<std::vector<PanelTile>> shards = PartitionTiles(BuildTriangleTiles(source.Rows(), panelRows), deviceNum);
+
+    // 每个 device 一个线程，各自持有 stream 与 buffer
+    std::vector<aclError> results(deviceNum, ACL_SUCCESS);
+    std::vector<std::thread> workers;
+    for (uint32_t d = 0; d < deviceNum; ++d) {
+        if (shards[d].empty()) {
+            continue;
+        }
+        workers.push_back(std::thread([&, d]() {
+            StreamConfig streamConfig;
+            streamConfig.deviceId = devices[d];
+            streamConfig.panelRows = panelRows;
+            streamConfig.streamNum = config.streamsPerDevice;
+            PdistStreamRunner runner(streamConfig, dtype, m, p);
+            results[d] = runner.Run(source, shards[d], sink);
+        }));
+    }
+    for (size_t t = 0; t < workers.size(); ++t) {
+        workers[t].join();
+    }
+    for (uint32_t d = 0; d < deviceNum; ++d) {
+        if (results[d] != ACL_SUCCESS) {
+            return results[d];
+        }
+    }
+    return ACL_SUCCESS;
+}
+} // namespace
+
+std::vector<std::vector<PanelTile>> PartitionTiles(const std::vector<PanelTile>& tiles, uint32_t parts) {
+    std::vector<std::vector<PanelTile>> shards(parts == 0 ? 1 : parts);
+    uint64_t total = 0;
+    for (size_t t = 0; t < tiles.size(); ++t) {
+        total += TilePairs(tiles[t]);
+    }
+    // 第 k 段在累计工作量越过 (k + 1) * total / parts 时结束
+    uint64_t acc = 0;
+    size_t part = 0;
+    for (size_t t = 0; t < tiles.size(); ++t) {
+        shards[part].push_back(tiles[t]);
+        acc += TilePairs(tiles[t]);
+        while (part + 1 < shards.size() && acc * shards.size() >= total * (part + 1)) {
+            ++part;
+        }
+    }
+    return shards;
+}
+
+uint64_t ShardPanelRows(uint64_t n, uint32_t deviceNum, uint64_t panelRows) {
+    uint64_t wanted = MIN_TILES_PER_DEVICE * deviceNum;
+    while (panelRows > MIN_SHARD_PANEL_ROWS) {
+        uint64_t panels = (n + panelRows - 1) / panelRows;
+        if (panels * (panels + 1) / 2 >= wanted) {
+            break;
+        }
+        panelRows /= 2;
+    }
+    return panelRows;
+}
+
+aclError PdistSharded(const RowSource& source, uint64_t m, aclDataType dtype, float p, const ShardConfig& config,
+                      PanelSink& sink) {
+    LockedPanelSink locked(sink);
+    return RunShards(source, m, dtype, p, config, locked);
+}
+
+aclError PdistSharded(const void* x, uint64_t n, uint64_t m, aclDataType dtype, float p, const ShardConfig& config,
+                      void* yHost) {
+    if (x == nullptr || yHost == nullptr || ElementSize(dtype) == 0) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    HostRowSource source(x, n, m, ElementSize(dtype));
+    CondensedBufferSink sink(n, yHost);
+    return RunShards(source, m, dtype, p, config, sink);
+}
+
+} // namespace pdist
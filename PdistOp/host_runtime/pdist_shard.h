@@ -0,0 +1,63 @@
+/**
+ * @file pdist_shard.h
+ * @brief Multi-device Pdist: splits the triangular pair space into balanced tile ranges and runs
+ *        each range on its own NPU concurrently.
+ */
+
+#ifndef PDIST_SHARD_H
+#define PDIST_SHARD_H
+
+#include <mutex>
+#include <vector>
+#include "pdist_stream.h"
+
+namespace pdist {
+
+struct ShardConfig {
+    // 参与计算的 device 列表，为空时使用全部可见 device
+    std::vector<int32_t> deviceIds;
+    // tile 边长上限；tile 数不足以均衡时会自动缩小
+    uint64_t panelRows;
+    uint32_t streamsPerDevice;
+
+    ShardConfig() : panelRows(4096), streamsPerDevice(2) {}
+};
+
+// tile 包含的距离对数，作为切分时的工作量估计
+inline uint64_t TilePairs(const PanelTile& tile) {
+    return tile.diagonal ? CondensedSize(tile.rowCount) : tile.rowCount * tile.colCount;
+}
+
+// 将 tile 序列切成 parts 段连续区间，使每段的距离对数尽量相等
+// 连续切分保证每个 device 写回的是压缩输出中相邻的几段，局部性更好
+PDIST_API std::vector<std::vector<PanelTile>> PartitionTiles(const std::vector<PanelTile>& tiles, uint32_t parts);
+
+// 缩小 panelRows 直到 tile 数足够在 deviceNum 个 device 间均衡切分
+PDIST_API uint64_t ShardPanelRows(uint64_t n, uint32_t deviceNum, uint64_t panelRows);
+
+// 多线程共享同一个 sink 时的串行化包装
+class PDIST_API LockedPanelSink : public PanelSink {
+public:
+    explicit LockedPanelSink(PanelSink& inner) : inner_(inner) {}
+    aclError Consume(const PanelResult& result) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return inner_.Consume(result);
+    }
+
+private:
+    PanelSink& inner_;
+    std::mutex mutex_;
+};
+
+// 多 device 并发计算，结果交给 sink (sink 会被多个线程调用，内部已加锁串行化)
+PDIST_API aclError PdistSharded(const RowSource& source, uint64_t m, aclDataType dtype, float p,
+                                const ShardConfig& config, PanelSink& sink);
+
+// 多 device 并发计算并拼装到 host 压缩输出 yHost (CondensedSize(n) 个元素)
+// 各 device 写入的区间互不重叠，无需加锁
+PDIST_API aclError PdistSharded(const void* x, uint64_t n, uint64_t m, aclDataType dtype, float p,
+                                const ShardConfig& config, void* yHost);
+
+} // namespace pdist
+
+#endif // PDIST_SHARD_H
@@ -0,0 +1,314 @@
+/**
+ * @file pdist_stream.cpp
+ * @brief Streaming (out-of-core) Pdist driver implementation
+ */
+
+#include "pdist_stream.h"
+
+#include <cstring>
+#include "aclnn_pdist.h"
+#include "aclnn_pdist_cross.h"
+
+namespace pdist {
+
+void ScatterPanelToCondensed(const PanelResult& result, uint64_t n, void* condensed) {
+    const PanelTile& tile = result.tile;
+    const size_t es = result.elementSize;
+    const uint8_t* src = static_cast<const uint8_t*>(result.data);
+    uint8_t* dst = static_cast<uint8_t*>(condensed);
+
+    for (uint64_t r = 0; r < tile.rowCount; ++r) {
+        uint64_t i = tile.rowBegin + r;
+        if (tile.diagonal) {
+            // 面板内第 r 行: d(i, i+1) ... d(i, rowEnd-1)
+            uint64_t len = tile.rowCount - 1 - r;
+            if (len == 0) {
+                continue;
+            }
+            std::memcpy(dst + CondensedIndex(n, i, i + 1) * es,
+                        src + CondensedRowOffset(tile.rowCount, r) * es, len * es);
+        } else {
+            std::memcpy(dst + CondensedIndex(n, i, tile.colBegin) * es,
+                        src + r * tile.colCount * es, tile.colCount * es);
+        }
+    }
+}
+
+aclError CondensedBufferSink::Consume(const PanelResult& result) {
+    ScatterPanelToCondensed(result, n_, condensed_);
+    return ACL_SUCCESS;
+}
+
+aclError CondensedFileSink::Consume(const PanelResult& result) {
+    if (writer_.Data() == nullptr || result.elementSize != writer_.ElementBytes()) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    ScatterPanelToCondensed(result, writer_.Rows(), writer_.Data());
+    return ACL_SUCCESS;
+}
+
+void HostRowSource::CopyRows(uint64_t begin, uint64_t count, void* dst) const {
+    std::memcpy(dst, x_ + begin * rowBytes_, count * rowBytes_);
+}
+
+std::vector<PanelTile> BuildTriangleTiles(uint64_t n, uint64_t panelRows) {
+    std::vector<PanelTile> tiles;
+    if (panelRows == 0) {
+        return tiles;
+    }
+    for (uint64_t ib = 0; ib < n; ib += panelRows) {
+        uint64_t iCount = (n - ib < panelRows) ? (n - ib) : panelRows;
+        if (iCount > 1) {
+            PanelTile diag = {ib, iCount, ib, iCount, true};
+            tiles.push_back(diag);
+        }
+        for (uint64_t jb = ib + iCount; jb < n; jb += panelRows) {
+            uint64_t jCount = (n - jb < panelRows) ? (n - jb) : panelRows;
+            PanelTile cross = {ib, iCount, jb, jCount, false};
+            tiles.push_back(cross);
+        }
+    }
+    return tiles;
+}
+
+PdistStreamRunner::PdistStreamRunner(const StreamConfig& config, aclDataType dtype, uint64_t m, float p)
+    : config_(config), dtype_(dtype), elementSize_(ElementSize(dtype)), m_(m), p_(p), initialized_(false) {}
+
+PdistStreamRunner::~PdistStreamRunner() {
+    Release();
+}
+
+aclError PdistStreamRunner::Init() {
+    if (initialized_) {
+        return ACL_SUCCESS;
+    }
+    if (elementSize_ == 0 || m_ == 0 || config_.panelRows < 2 || config_.streamNum == 0) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    // 中途失败时释放已分配的部分，runner 保持未初始化，下次 Run 重新分配
+    aclError ret = CreateResources();
+    if (ret != ACL_SUCCESS) {
+        Release();
+        return ret;
+    }
+    initialized_ = true;
+    return ACL_SUCCESS;
+}
+
+aclError PdistStreamRunner::CreateResources() {
+    PDIST_CHECK(aclrtSetDevice(config_.deviceId));
+
+    for (uint32_t s = 0; s < config_.streamNum; ++s) {
+        aclrtStream stream = nullptr;
+        PDIST_CHECK(aclrtCreateStream(&stream));
+        streams_.push_back(stream);
+    }
+
+    const size_t panelBytes = config_.panelRows * m_ * elementSize_;
+    const size_t outBytes = config_.panelRows * config_.panelRows * elementSize_;
+    // 每个 stream 两个 slot: 一个在 device 上执行时，另一个在 host 侧交付结果并准备下一批输入
+    slots_.resize(2 * streams_.size());
+    for (size_t k = 0; k < slots_.size(); ++k) {
+        Slot& slot = slots_[k];
+        std::memset(&slot, 0, sizeof(Slot));
+        slot.stream = streams_[k % streams_.size()];
+        slot.cachedRowCount = 0;
+        PDIST_CHECK(aclrtCreateEvent(&slot.done));
+        PDIST_CHECK(aclrtMallocHost(&slot.xiHost, panelBytes));
+        PDIST_CHECK(aclrtMallocHost(&slot.xjHost, panelBytes));
+        PDIST_CHECK(aclrtMallocHost(&slot.yHost, outBytes));
+        PDIST_CHECK(aclrtMalloc(&slot.xiDev, panelBytes, ACL_MEM_MALLOC_HUGE_FIRST));
+        PDIST_CHECK(aclrtMalloc(&slot.xjDev, panelBytes, ACL_MEM_MALLOC_HUGE_FIRST));
+        PDIST_CHECK(aclrtMalloc(&slot.yDev, outBytes, ACL_MEM_MALLOC_HUGE_FIRST));
+    }
+    return ACL_SUCCESS;
+}
+
+void PdistStreamRunner::Release() {
+    // 也用于 Init 失败后的清理: 只释放已创建的 stream / slot 资源
+    // 先等待所有在途任务，避免释放仍被 device 访问的 buffer
+    for (size_t s = 0; s < streams_.size(); ++s) {
+        aclrtSynchronizeStream(streams_[s]);
+    }
+    for (size_t k = 0; k < slots_.size(); ++k) {
+        Slot& slot = slots_[k];
+        for (int t = 0; t < 3; ++t) {
+            if (slot.tensors[t] != nullptr) aclDestroyTensor(slot.tensors[t]);
+        }
+        if (slot.workspace != nullptr) aclrtFree(slot.workspace);
+        if (slot.xiDev != nullptr) aclrtFree(slot.xiDev);
+        if (slot.xjDev != nullptr) aclrtFree(slot.xjDev);
+        if (slot.yDev != nullptr) aclrtFree(slot.yDev);
+        if (slot.xiHost != nullptr) aclrtFreeHost(slot.xiHost);
+        if (slot.xjHost != nullptr) aclrtFreeHost(slot.xjHost);
+        if (slot.yHost != nullptr) aclrtFreeHost(slot.yHost);
+        if (slot.done != nullptr) aclrtDestroyEvent(slot.done);
+    }
+    slots_.clear();
+    for (size_t s = 0; s < streams_.size(); ++s) {
+        aclrtDestroyStream(streams_[s]);
+    }
+    streams_.clear();
+    initialized_ = false;
+}
+
+aclError PdistStreamRunner::EnsureWorkspace(Slot& slot, uint64_t size) {
+    if (size <= slot.workspaceSize) {
+        return ACL_SUCCESS;
+    }
+    // slot 已经 Drain 过，旧 workspace 不再被 device 使用
+    if (slot.workspace != nullptr) {
+        aclrtFree(slot.workspace);
+        slot.workspace = nullptr;
+        slot.workspaceSize = 0;
+    }
+    PDIST_CHECK(aclrtMalloc(&slot.workspace, size, ACL_MEM_MALLOC_HUGE_FIRST));
+    slot.workspaceSize = size;
+    return ACL_SUCCESS;
+}
+
+aclError PdistStreamRunner::Launch(Slot& slot, const RowSource& source, const PanelTile& tile) {
+    const size_t rowBytes = m_ * elementSize_;
+    const size_t panelBytes = config_.panelRows * rowBytes;
+    const size_t outBytes = config_.panelRows * config_.panelRows * elementSize_;
+
+    // 1. H2D: 同一 slot 连续处理同一行面板时复用已在 device 上的 x_i
+    if (slot.cachedRowCount != tile.rowCount || slot.cachedRowBegin != tile.rowBegin) {
+        source.CopyRows(tile.rowBegin, tile.rowCount, slot.xiHost);
+        PDIST_CHECK(aclrtMemcpyAsync(slot.xiDev, panelBytes, slot.xiHost, tile.rowCount * rowBytes,
+                                     ACL_MEMCPY_HOST_TO_DEVICE, slot.stream));
+        slot.cachedRowBegin = tile.rowBegin;
+        slot.cachedRowCount = tile.rowCount;
+    }
+    if (!tile.diagonal) {
+        source.CopyRows(tile.colBegin, tile.colCount, slot.xjHost);
+        PDIST_CHECK(aclrtMemcpyAsync(slot.xjDev, panelBytes, slot.xjHost, tile.colCount * rowBytes,
+                                     ACL_MEMCPY_HOST_TO_DEVICE, slot.stream));
+    }
+
+    // 2. Kernel: 对角面板走 aclnnPdist，非对角面板走 aclnnPdistCross
+    int64_t xiShape[] = {static_cast<int64_t>(tile.rowCount), static_cast<int64_t>(m_)};
+    int64_t xjShape[] = {static_cast<int64_t>(tile.colCount), static_cast<int64_t>(m_)};
+    uint64_t workspaceSize = 0;
+    aclOpExecutor* executor = nullptr;
+    size_t yElems = 0;
+    slot.tensors[0] = aclCreateTensor(xiShape, 2, dtype_, nullptr, 0, aclFormat::ACL_FORMAT_ND, xiShape, 2,
+                                      slot.xiDev);
+    if (tile.diagonal) {
+        int64_t yShape[] = {static_cast<int64_t>(CondensedSize(tile.rowCount))};
+        yElems = static_cast<size_t>(yShape[0]);
+        slot.tensors[2] = aclCreateTensor(yShape, 1, dtype_, nullptr, 0, aclFormat::ACL_FORMAT_ND, yShape, 1,
+                                          slot.yDev);
+        char nanPolicy[] = "propagate";
+        PDIST_CHECK(aclnnPdistGetWorkspaceSize(slot.tensors[0], nullptr, p_, nanPolicy, slot.tensors[2], nullptr,
+                                               &workspaceSize, &executor));
+        PDIST_CHECK(EnsureWorkspace(slot, workspaceSize));
+        PDIST_CHECK(aclnnPdist(slot.workspace, workspaceSize, executor, slot.stream));
+    } else {
+        int64_t yShape[] = {static_cast<int64_t>(tile.rowCount), static_cast<int64_t>(tile.colCount)};
+        yElems = tile.rowCount * tile.colCount;
+        slot.tensors[1] = aclCreateTensor(xjShape, 2, dtype_, nullptr, 0, aclFormat::ACL_FORMAT_ND, xjShape, 2,
+                                          slot.xjDev);
+        slot.tensors[2] = aclCreateTensor(yShape, 2, dtype_, nullptr, 0, aclFormat::ACL_FORMAT_ND, yShape, 2,
+                                          slot.yDev);
+        PDIST_CHECK(aclnnPdistCrossGetWorkspaceSize(slot.tensors[0], slot.tensors[1], p_, slot.tensors[2],
+                                                    &workspaceSize, &executor));
+        PDIST_CHECK(EnsureWorkspace(slot, workspaceSize));
+        PDIST_CHECK(aclnnPdistCross(slot.workspace, workspaceSize, executor, slot.stream));
+    }
+
+    // 3. D2H 到 pinned buffer，完成后由 Drain 交给 sink
+    PDIST_CHECK(aclrtMemcpyAsync(slot.yHost, outBytes, slot.yDev, yElems * elementSize_,
+                                 ACL_MEMCPY_DEVICE_TO_HOST, slot.stream));
+    PDIST_CHECK(aclrtRecordEvent(slot.done, slot.stream));
+    slot.tile = tile;
+    slot.pending = true;
+    return ACL_SUCCESS;
+}
+
+aclError PdistStreamRunner::Drain(Slot& slot, PanelSink& sink) {
+    if (!slot.pending) {
+        return ACL_SUCCESS;
+    }
+    slot.pending = false;
+    PDIST_CHECK(aclrtSynchronizeEvent(slot.done));
+    for (int t = 0; t < 3; ++t) {
+        if (slot.tensors[t] != nullptr) {
+            aclDestroyTensor(slot.tensors[t]);
+            slot.tensors[t] = nullptr;
+        }
+    }
+    PanelResult result = {slot.tile, slot.yHost, elementSize_};
+    return sink.Consume(result);
+}
+
+aclError PdistStreamRunner::Run(const RowSource& source, const std::vector<PanelTile>& tiles, PanelSink& sink) {
+    for (size_t t = 0; t < tiles.size(); ++t) {
+        const PanelTile& tile = tiles[t];
+        bool sizeOk = tile.rowCount > 0 && tile.rowCount <= config_.panelRows && tile.colCount > 0 &&
+                      tile.colCount <= config_.panelRows;
+        bool layoutOk = tile.diagonal ? (tile.rowBegin == tile.colBegin && tile.rowCount == tile.colCount)
+                                      : (tile.rowBegin + tile.rowCount <= tile.colBegin);
+        if (!sizeOk || !layoutOk || tile.colBegin + tile.colCount > source.Rows()) {
+            return ACL_ERROR_INVALID_PARAM;
+        }
+    }
+    PDIST_CHECK(Init());
+    // 缓存的 x_i 面板属于上一次 Run 的 RowSource，不能跨调用复用
+    for (size_t k = 0; k < slots_.size(); ++k) {
+        slots_[k].cachedRowCount = 0;
+    }
+    aclError ret = RunTiles(source, tiles, sink);
+    if (ret != ACL_SUCCESS) {
+        Abort();
+    }
+    return ret;
+}
+
+aclError PdistStreamRunner::RunTiles(const RowSource& source, const std::vector<PanelTile>& tiles, PanelSink& sink) {
+    // 轮转分配 slot: 相邻 tile 落在不同 stream 上，同一 stream 的两个 slot 交替使用
+    const size_t slotNum = slots_.size();
+    for (size_t t = 0; t < tiles.size(); ++t) {
+        Slot& slot = slots_[t % slotNum];
+        PDIST_CHECK(Drain(slot, sink));
+        if (tiles[t].diagonal && tiles[t].rowCount < 2) {
+            continue;
+        }
+        PDIST_CHECK(Launch(slot, source, tiles[t]));
+    }
+    // 按提交顺序交付剩余结果
+    for (size_t k = 0; k < slotNum; ++k) {
+        PDIST_CHECK(Drain(slots_[(tiles.size() + k) % slotNum], sink));
+    }
+    return ACL_SUCCESS;
+}
+
+void PdistStreamRunner::Abort() {
+    // 等待在途任务后丢弃未交付的面板，避免下次 Run 把它们交给新的 sink
+    for (size_t s = 0; s < streams_.size(); ++s) {
+        aclrtSynchronizeStream(streams_[s]);
+    }
+    for (size_t k = 0; k < slots_.size(); ++k) {
+        Slot& slot = slots_[k];
+        for (int t = 0; t < 3; ++t) {
+            if (slot.tensors[t] != nullptr) {
+                aclDestroyTensor(slot.tensors[t]);
+                slot.tensors[t] = nullptr;
+            }
+        }
+        slot.pending = false;
+        slot.cachedRowCount = 0;
+    }
+}
+
+aclError PdistStream(const void* x, uint64_t n, uint64_t m, aclDataType dtype, float p, const StreamConfig& config,
+                     PanelSink& sink) {
+    if (x == nullptr || ElementSize(dtype) == 0) {
+        return ACL_ERROR_INVALID_PARAM;
+    }
+    HostRowSource source(x, n, m, ElementSize(dtype));
+    PdistStreamRunner runner(config, dtype, m, p);
+    return runner.Run(source, BuildTriangleTiles(n, config.panelRows), sink);
+}
+
+} // namespace pdist
@@ -0,0 +1,169 @@
+/**
+ * @file pdist_stream.h
+ * @brief Streaming (out-of-core) Pdist driver: splits x into row panels and runs panel pairs on
+ *        multiple streams, so problems larger than device memory run in bounded device memory.
+ */
+
+#ifndef PDIST_STREAM_H
+#define PDIST_STREAM_H
+
+#include <functional>
+#include <vector>
+#include "acl/acl.h"
+#include "aclnn/acl_meta.h"
+#include "pdist_condensed_file.h"
+#include "pdist_runtime_common.h"
+
+namespace pdist {
+
+// 一个面板对: 行区间 [rowBegin, rowBegin + rowCount) x 列区间 [colBegin, colBegin + colCount)
+// diagonal 为 true 时行列区间相同，由 aclnnPdist 计算，输出为 rowCount 行的压缩三角;
+// 否则要求行区间整体位于列区间之前，由 aclnnPdistCross 计算，输出为 rowCount x colCount 的稠密块
+struct PanelTile {
+    uint64_t rowBegin;
+    uint64_t rowCount;
+    uint64_t colBegin;
+    uint64_t colCount;
+    bool diagonal;
+};
+
+// 交给 Sink 的单个面板结果，data 仅在 Consume 调用期间有效
+struct PanelResult {
+    PanelTile tile;
+    const void* data;
+    size_t elementSize;
+};
+
+class PDIST_API PanelSink {
+public:
+    virtual ~PanelSink() {}
+    virtual aclError Consume(const PanelResult& result) = 0;
+};
+
+class PDIST_API CallbackPanelSink : public PanelSink {
+public:
+    typedef std::function<aclError(const PanelResult&)> Callback;
+
+    explicit CallbackPanelSink(const Callback& callback) : callback_(callback) {}
+    aclError Consume(const PanelResult& result) override { return callback_(result); }
+
+private:
+    Callback callback_;
+};
+
+// 将面板结果按标准压缩布局散写到 n 行问题的输出中 (每个面板行在输出中都是连续的一段)
+PDIST_API void ScatterPanelToCondensed(const PanelResult& result, uint64_t n, void* condensed);
+
+// 直接写入调用方提供的 host 压缩输出 (CondensedSize(n) 个元素)
+class PDIST_API CondensedBufferSink : public PanelSink {
+public:
+    CondensedBufferSink(uint64_t n, void* condensed) : n_(n), condensed_(condensed) {}
+    aclError Consume(const PanelResult& result) override;
+
+private:
+    uint64_t n_;
+    void* condensed_;
+};
+
+// 将结果写入 mmap 的落盘文件 (见 pdist_condensed_file.h)，host 内存占用与 n 无关
+class PDIST_API CondensedFileSink : public PanelSink {
+public:
+    aclError Open(const char* path, uint64_t n, aclDataType dtype, float p) {
+        return writer_.Create(path, n, dtype, p);
+    }
+    aclError Consume(const PanelResult& result) override;
+    aclError Close() { return writer_.Close(); }
+
+private:
+    CondensedFileWriter writer_;
+};
+
+// 输入行的来源，按需把若干连续行拷到 staging buffer，x 不必整体常驻 host 内存
+class PDIST_API RowSource {
+public:
+    virtual ~RowSource() {}
+    virtual uint64_t Rows() const = 0;
+    virtual void CopyRows(uint64_t begin, uint64_t count, void* dst) const = 0;
+};
+
+// 行主序连续存放的 host 输入 (也可以是 mmap 的文件)
+class PDIST_API HostRowSource : public RowSource {
+public:
+    HostRowSource(const void* x, uint64_t n, uint64_t m, size_t elementSize)
+        : x_(static_cast<const uint8_t*>(x)), n_(n), rowBytes_(m * elementSize) {}
+    uint64_t Rows() const override { return n_; }
+    void CopyRows(uint64_t begin, uint64_t count, void* dst) const override;
+
+private:
+    const uint8_t* x_;
+    uint64_t n_;
+    uint64_t rowBytes_;
+};
+
+struct StreamConfig {
+    int32_t deviceId;
+    // 面板行数 B: 每个 slot 占用 (2 * B * m + B * B) 个元素的 device 内存
+    uint64_t panelRows;
+    // 每个 stream 分配两个 slot，H2D / kernel / D2H 在 slot 间双缓冲
+    uint32_t streamNum;
+
+    StreamConfig() : deviceId(0), panelRows(4096), streamNum(2) {}
+};
+
+// 按 panelRows 切分 n 行，生成上三角的全部面板对 (行优先，对角面板在前)
+PDIST_API std::vector<PanelTile> BuildTriangleTiles(uint64_t n, uint64_t panelRows);
+
+class PDIST_API PdistStreamRunner {
+public:
+    PdistStreamRunner(const StreamConfig& config, aclDataType dtype, uint64_t m, float p);
+    ~PdistStreamRunner();
+
+    // 依次计算 tiles 中的每个面板对，并把结果交给 sink (sink 在调用线程中被调用)
+    aclError Run(const RowSource& source, const std::vector<PanelTile>& tiles, PanelSink& sink);
+
+private:
+    struct Slot {
+        aclrtStream stream;
+        aclrtEvent done;
+        void* xiHost;
+        void* xjHost;
+        void* yHost;
+        void* xiDev;
+        void* xjDev;
+        void* yDev;
+        void* workspace;
+        uint64_t workspaceSize;
+        aclTensor* tensors[3];
+        PanelTile tile;
+        uint64_t cachedRowBegin;
+        uint64_t cachedRowCount;
+        bool pending;
+    };
+
+    aclError Init();
+    aclError CreateResources();
+    void Release();
+    aclError RunTiles(const RowSource& source, const std::vector<PanelTile>& tiles, PanelSink& sink);
+    // 出错后同步全部 stream，清除 pending 与 tensor
+    void Abort();
+    aclError Launch(Slot& slot, const RowSource& source, const PanelTile& tile);
+    aclError Drain(Slot& slot, PanelSink& sink);
+    aclError EnsureWorkspace(Slot& slot, uint64_t size);
+
+    StreamConfig config_;
+    aclDataType dtype_;
+    size_t elementSize_;
+    uint64_t m_;
+    float p_;
+    bool initialized_;
+    std::vector<aclrtStream> streams_;
+    std::vector<Slot> slots_;
+};
+
+// 一站式接口: 对 host 上的 x (n x m) 计算完整 pdist，结果逐面板交给 sink
+PDIST_API aclError PdistStream(const void* x, uint64_t n, uint64_t m, aclDataType dtype, float p,
+                               const StreamConfig& config, PanelSink& sink);
+
+} // namespace pdist
+
+#endif // PDIST_STREAM_H
@@ -3,12 +3,51 @@
  * @brief Host-side tiling implementation for Pdist operator (Cyclic Tiling Optimized)
  */
 
+#include <cstring>
 #include "pdist_tiling.h"
+#include "pdist_tuning.h"
 #include "register/op_def_registry.h"
 #include "tiling/platform/platform_ascendc.h"
 
 namespace optiling {
 
+// 从 x 的视图 strides (元素) 取行跨度: 列跨度须为 1，行跨度须不小于 m (特征切片 x[:, c0:c0 + m] 等)
+// 未携带 strides (连续 tensor) 时行跨度为 0，即按 m 处理
+static bool GetPdistRowStride(const gert::Stride* stride, uint32_t m, uint32_t& rowStride) {
+    rowStride = 0;
+    if (stride == nullptr || stride->GetDimNum() == 0) {
+        return true;
+    }
+    if (stride->GetDimNum() != 2) {
+        return false;
+    }
+    int64_t rowS = stride->GetStride(0);
+    int64_t colS = stride->GetStride(1);
+    // 列跨度不为 1 (转置视图等) 时一行不再是连续段，无法用按行的 DataCopy 搬运
+    if (colS != 1 || rowS < static_cast<int64_t>(m) || rowS > UINT32_MAX) {
+        return false;
+    }
+    rowStride = static_cast<uint32_t>(rowS);
+    return true;
+}
+
+// nan_policy 属性取值 -> PdistNanPolicy；未设置时为 propagate，取值不认识时失败
+static bool GetPdistNanPolicy(const char* name, uint32_t& policy) {
+    policy = PDIST_NAN_PROPAGATE;
+    if (name == nullptr || std::strcmp(name, "propagate") == 0) {
+        return true;
+    }
+    if (std::strcmp(name, "ignore-dimension") == 0) {
+        policy = PDIST_NAN_IGNORE_DIM;
+        return true;
+    }
+    if (std::strcmp(name, "mark-row") == 0) {
+        policy = PDIST_NAN_MARK_ROW;
+        return true;
+    }
+    return false;
+}
+
 // 辅助函数：计算 Ceil(a, b)
 static ge::graphStatus TilingFunc(gert::TilingContext* context) {
     PdistTilingData tiling;
@@ -17,10 +56,34 @@ static ge::graphStatus TilingFunc(gert::TilingContext* context) {
     const gert::RuntimeAttrs* attrs = context->GetAttrs();
     const float* p_ptr = attrs->GetAttrPointer<float>(0);
     float p = (p_ptr != nullptr) ? *p_ptr : 2.0f;
+    uint32_t nanPolicy = PDIST_NAN_PROPAGATE;
+    if (!GetPdistNanPolicy(attrs->GetAttrPointer<char>(1), nanPolicy)) {
+        return ge::GRAPH_FAILED;
+    }
 
     const gert::StorageShape* x_shape = context->GetInputShape(0);
     uint32_t n = x_shape->GetStorageShape().GetDim(0);
     uint32_t m = x_shape->GetStorageShape().GetDim(1);
+    // m = 0 时没有可比较的维度，kChunk 按 0 对齐后切段会除零，直接拒绝
+    if (m == 0) {
+        return ge::GRAPH_FAILED;
+    }
+    // 可选 indices: 只比较 x 中被选中的行，点数 n 取 indices 的长度 (kernel 按索引直接寻址 x 的行)
+    uint32_t indexSize = 0;
+    const gert::StorageShape* indices_shape = context->GetOptionalInputShape(1);
+    if (indices_shape != nullptr) {
+        int64_t count = indices_shape->GetStorageShape().GetShapeSize();
+        if (count > UINT32_MAX) {
+            return ge::GRAPH_FAILED;
+        }
+        n = static_cast<uint32_t>(count);
+        indexSize = (context->GetOptionalInputDesc(1)->GetDataType() == ge::DT_INT64) ? 8 : 4;
+    }
+    // x 以视图方式传入 (IgnoreContiguous)，按 aclTensor 的 strides 直接读取原矩阵，不再由框架先拷成连续
+    uint32_t rowStride = 0;
+    if (!GetPdistRowStride(context->GetInputStride(0), m, rowStride)) {
+        return ge::GRAPH_FAILED;
+    }
 
     // 2. 获取平台信息
     auto platformInfo = context->GetPlatformInfo();
@@ -28,57 +91,40 @@ static ge::graphStatus TilingFunc(gert::TilingContext* context) {
         return ge::GRAPH_FAILED;
     }
     auto ascendcPlatform = platform_ascendc::PlatformAscendC(platformInfo);
-    
-    // 3. 计算对齐后的 m (tileLength)
-    // 硬件要求 DataCopy 地址 32 字节对齐
-    // FP16: 32 bytes = 16 elements
-    // FP32: 32 bytes = 8 elements
-    // 为了稳妥，统一按 32 字节对齐向上取整
-    uint32_t align = 32; 
-    uint32_t typeSize = 0;
-    auto dtype = context->GetInputDesc(0)->GetDataType();
-    if (dtype == ge::DT_FLOAT) {
-        typeSize = 4;
-    } else {
-        typeSize = 2; // FP16
-    }
-    
-    // 计算每行占用的字节数，并向上取整到 32 字节倍数
-    uint32_t rowSize = m * typeSize;
-    uint32_t alignedRowSize = (rowSize + align - 1) / align * align;
-    uint32_t tileLength = alignedRowSize / typeSize; // 对齐后的元素个数
-
-    // 4. 决定核数 (BlockDim)
-    uint32_t aicoreNum = ascendcPlatform.GetCoreNumAic();
-    uint32_t usedCoreNum = aicoreNum;
 
-    // 小数据量优化：如果 N 很小，没必要用多核，避免通信开销
-    if (n < aicoreNum) {
-        usedCoreNum = 1;
+    // 3. 计算切分 (规则见 pdist_tiling_plan.h，CPU 仿真复用同一份)
+    PdistTilingInput in;
+    in.n = n;
+    in.m = m;
+    in.p = p;
+    in.typeSize = (context->GetInputDesc(0)->GetDataType() == ge::DT_FLOAT) ? 4 : 2; // FP32 / FP16
+    in.coreNumAic = ascendcPlatform.GetCoreNumAic();
+    in.coreNumAiv = ascendcPlatform.GetCoreNumAiv();
+    ascendcPlatform.GetCoreMemSize(platform_ascendc::CoreMemType::UB, in.ubSize);
+    ascendcPlatform.GetCoreMemSize(platform_ascendc::CoreMemType::L2, in.l2Size);
+    in.rowStride = rowStride;
+    in.indexSize = indexSize;
+    in.nanPolicy = nanPolicy;
+    // 可选输出 valid 未连接时不写位图 (kernel 侧地址为空)
+    in.validityOut = (context->GetOutputShape(1) != nullptr) ? 1 : 0;
+    // 分块参数优先级: 调优工具强制指定 > 离线调优表 > 启发式
+    PdistBlockParams tuned;
+    bool hasTuned = GetPdistTilingOverride(tuned) || LookupPdistTuning(in, tuned);
+    PdistTilingPlan plan = PlanPdistTiling(in, hasTuned ? &tuned : nullptr);
+    FillPdistTilingData(plan, tiling);
+    if (plan.tilingKey == PDIST_TILING_KEY_GRAM && !FillPdistCubeTiling(plan, in.typeSize, ascendcPlatform, tiling)) {
+        // Cube tiling 求解失败时退回 Vector kernel
+        plan = PlanPdistTiling(in, hasTuned ? &tuned : nullptr, false);
+        FillPdistTilingData(plan, tiling);
     }
-    
-    // 设置使用的核数
-    context->SetBlockDim(usedCoreNum);
-
-    // 5. 关键优化：Cyclic Tiling (循环分配) 参数计算
-    // 我们不再算每个核处理多少行 (rowsPerBlock)，而是让每个核跳着处理
-    // 策略：Core i 处理行索引为: i, i + usedCoreNum, i + 2*usedCoreNum ...
-    // 
-    // 这种模式下，Host 端只需要传基础参数，具体的循环逻辑由 Kernel 自己算
-    // 为了兼容之前的结构体，我们复用字段：
-    // usedCoreNum -> 传给 kernel，作为 stride (步长)
-    // 
-    // 注意：这里需要稍微调整一下 Kernel 的逻辑，所以 Host 这边传参要改一下含义
-    // 现在的逻辑变得极其简单：Host 只需要把 N, M, P, CoreNum 传下去就行了
-    
-    tiling.set_n(n);
-    tiling.set_m(m);
-    tiling.set_p(p);
-    tiling.set_tileLength(tileLength);
-    tiling.set_usedCoreNum(usedCoreNum); // 新增：告诉 Kernel 总共有多少个核在跑
 
-    // 计算 TilingKey (保持默认 1)
-    tiling.set_tilingKey(1);
+    // 4. 设置使用的核数 (纯 Vector kernel 按 AIV 核数，混合 kernel 按 AIC 核数) 与 kernel 分支
+    context->SetBlockDim(plan.blockDim);
+    context->SetTilingKey(plan.tilingKey);
+
+    // 5. Workspace: 系统 workspace (含 Matmul 所需) + Gram 路径的范数 / 环形缓冲 + (Profiling 构建时) 每核计数记录区
+    size_t* currentWorkspace = context->GetWorkspaceSizes(1);
+    currentWorkspace[0] = ascendcPlatform.GetLibApiWorkSpaceSize() + plan.userWorkspaceSize;
 
     // 6. 序列化数据
     tiling.SaveToBuffer(context->GetRawTilingData()->GetData(), context->GetRawTilingData()->GetCapacity());
@@ -98,10 +144,22 @@ static ge::graphStatus InferShape(gert::InferShapeContext* context) {
     }
     
     int64_t n = x1_shape->GetDim(0);
+    // 带 indices 时输出按 indices 的顺序编号
+    const gert::Shape* indices_shape = context->GetOptionalInputShape(1);
+    if (indices_shape != nullptr) {
+        n = indices_shape->GetShapeSize();
+    }
     int64_t outputSize = n * (n - 1) / 2;
     
     y_shape->SetDimNum(1);
     y_shape->SetDim(0, outputSize);
+
+    // 可选输出 valid: 每行 1 位的有效性位图
+    gert::Shape* valid_shape = context->GetOutputShape(1);
+    if (valid_shape != nullptr) {
+        valid_shape->SetDimNum(1);
+        valid_shape->SetDim(0, static_cast<int64_t>(optiling::PdistValidityBytes(static_cast<uint32_t>(n))));
+    }
     return GRAPH_SUCCESS;
 }
 } // namespace ge
@@ -110,22 +168,45 @@ namespace ops {
 class Pdist : public OpDef {
 public:
     explicit Pdist(const char* name) : OpDef(name) {
+        // 非连续视图 (行跨度大于 m) 直接交给 kernel，由 strided DataCopy 读取，避免框架插入的拷贝
         this->Input("x")
             .ParamType(REQUIRED)
-            .DataType({ge::DT_FLOAT, ge::DT_FLOAT16})
-            .Format({ge::FORMAT_ND, ge::FORMAT_ND})
-            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND});
+            .DataType({ge::DT_FLOAT, ge::DT_FLOAT, ge::DT_FLOAT16, ge::DT_FLOAT16})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND})
+            .IgnoreContiguous();
+
+        // 可选: 只比较 x[indices[r]] 这些行 (取值需在 [0, x.shape[0]) 内)，省去单独的 gather
+        this->Input("indices")
+            .ParamType(OPTIONAL)
+            .DataType({ge::DT_INT32, ge::DT_INT64, ge::DT_INT32, ge::DT_INT64})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND});
         
         this->Output("y")
             .ParamType(REQUIRED)
-            .DataType({ge::DT_FLOAT, ge::DT_FLOAT16})
-            .Format({ge::FORMAT_ND, ge::FORMAT_ND})
-            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND});
+            .DataType({ge::DT_FLOAT, ge::DT_FLOAT, ge::DT_FLOAT16, ge::DT_FLOAT16})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND});
+
+        // 可选: 第 r 行全部为有限值时字节 r / 8 的第 r % 8 位 (低位在前) 为 1，与 nan_policy 无关，
+        // 调用方据此定位坏行，不再需要在 Host 侧预先扫描 x
+        this->Output("valid")
+            .ParamType(OPTIONAL)
+            .DataType({ge::DT_UINT8, ge::DT_UINT8, ge::DT_UINT8, ge::DT_UINT8})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND, ge::FORMAT_ND});
 
         this->Attr("p")
             .AttrType(OPTIONAL)
             .Float(2.0);
 
+        // 行中 NaN / ±Inf 的处理: "propagate" (默认，按 IEEE 规则进入距离)、
+        // "ignore-dimension" (一对行中任一侧非有限的维度不计入该 pair)、"mark-row" (坏行参与的 pair 输出 NaN)
+        this->Attr("nan_policy")
+            .AttrType(OPTIONAL)
+            .String("propagate");
+
         this->SetInferShape(ge::InferShape);
         this->AICore().SetTiling(optiling::TilingFunc);
         this->AICore().AddConfig("ascend910b");
@@ -0,0 +1,122 @@
+/**
+ * @file pdist_cross.cpp
+ * @brief Host-side tiling implementation for PdistCross operator (off-diagonal panel of Pdist)
+ */
+
+#include "pdist_cross_tiling.h"
+#include "register/op_def_registry.h"
+#include "tiling/platform/platform_ascendc.h"
+
+namespace optiling {
+
+static ge::graphStatus TilingFunc(gert::TilingContext* context) {
+    PdistCrossTilingData tiling;
+
+    // 1. 获取输入参数
+    const gert::RuntimeAttrs* attrs = context->GetAttrs();
+    const float* p_ptr = attrs->GetAttrPointer<float>(0);
+    float p = (p_ptr != nullptr) ? *p_ptr : 2.0f;
+
+    const gert::StorageShape* x1_shape = context->GetInputShape(0);
+    const gert::StorageShape* x2_shape = context->GetInputShape(1);
+    uint32_t rows1 = x1_shape->GetStorageShape().GetDim(0);
+    uint32_t rows2 = x2_shape->GetStorageShape().GetDim(0);
+    uint32_t m = x1_shape->GetStorageShape().GetDim(1);
+    if (x2_shape->GetStorageShape().GetDim(1) != m) {
+        return ge::GRAPH_FAILED;
+    }
+    // m = 0 时没有可比较的维度，kChunk 按 0 对齐后切段会除零，直接拒绝
+    if (m == 0) {
+        return ge::GRAPH_FAILED;
+    }
+
+    // 2. 获取平台信息
+    auto platformInfo = context->GetPlatformInfo();
+    if (platformInfo == nullptr) {
+        return ge::GRAPH_FAILED;
+    }
+    auto ascendcPlatform = platform_ascendc::PlatformAscendC(platformInfo);
+
+    // 3. 计算切分 (规则见 pdist_cross_tiling.h，与 Pdist 的分块 Vector kernel 一致，CPU 仿真复用同一份)
+    PdistTilingInput in;
+    in.n = rows1;
+    in.m = m;
+    in.p = p;
+    in.typeSize = (context->GetInputDesc(0)->GetDataType() == ge::DT_FLOAT) ? 4 : 2; // FP32 / FP16
+    in.coreNumAic = ascendcPlatform.GetCoreNumAic();
+    in.coreNumAiv = ascendcPlatform.GetCoreNumAiv();
+    ascendcPlatform.GetCoreMemSize(platform_ascendc::CoreMemType::UB, in.ubSize);
+    in.l2Size = 0;
+    in.rowStride = 0;
+    in.indexSize = 0;
+    in.nanPolicy = PDIST_NAN_PROPAGATE;
+    in.validityOut = 0;
+    PdistTilingPlan plan = PlanPdistCrossTiling(in, rows2);
+    FillPdistCrossTilingData(plan, rows2, tiling);
+
+    // 4. 纯 Vector kernel (KERNEL_TYPE_AIV_ONLY)，blockDim 按 AIV 核数；tilingKey 选择按 p 特化的实例
+    context->SetBlockDim(plan.blockDim);
+    context->SetTilingKey(plan.tilingKey);
+
+    size_t* currentWorkspace = context->GetWorkspaceSizes(1);
+    currentWorkspace[0] = ascendcPlatform.GetLibApiWorkSpaceSize();
+
+    tiling.SaveToBuffer(context->GetRawTilingData()->GetData(), context->GetRawTilingData()->GetCapacity());
+    context->GetRawTilingData()->SetDataSize(tiling.GetDataSize());
+
+    return ge::GRAPH_SUCCESS;
+}
+
+} // namespace optiling
+
+namespace ge {
+static ge::graphStatus InferShapeCross(gert::InferShapeContext* context) {
+    const gert::Shape* x1_shape = context->GetInputShape(0);
+    const gert::Shape* x2_shape = context->GetInputShape(1);
+    gert::Shape* y_shape = context->GetOutputShape(0);
+    if (x1_shape == nullptr || x2_shape == nullptr || y_shape == nullptr) {
+        return ge::GRAPH_FAILED;
+    }
+
+    // 输出为 rows1 x rows2 的稠密块 (行主序)
+    y_shape->SetDimNum(2);
+    y_shape->SetDim(0, x1_shape->GetDim(0));
+    y_shape->SetDim(1, x2_shape->GetDim(0));
+    return GRAPH_SUCCESS;
+}
+} // namespace ge
+
+namespace ops {
+class PdistCross : public OpDef {
+public:
+    explicit PdistCross(const char* name) : OpDef(name) {
+        this->Input("x1")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT, ge::DT_FLOAT16})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND});
+
+        this->Input("x2")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT, ge::DT_FLOAT16})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND});
+
+        this->Output("y")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT, ge::DT_FLOAT16})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND});
+
+        this->Attr("p")
+            .AttrType(OPTIONAL)
+            .Float(2.0);
+
+        this->SetInferShape(ge::InferShapeCross);
+        this->AICore().SetTiling(optiling::TilingFunc);
+        this->AICore().AddConfig("ascend910b");
+    }
+};
+
+OP_ADD(PdistCross);
+} // namespace ops
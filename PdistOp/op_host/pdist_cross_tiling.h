@@ -0,0 +1,84 @@
+#ifndef PDIST_CROSS_TILING_H
+#define PDIST_CROSS_TILING_H
+#include "register/tilingdata_base.h"
+#include "pdist_tiling_plan.h"
+
+namespace optiling {
+BEGIN_TILING_DATA_DEF(PdistCrossTilingData)
+  TILING_DATA_FIELD_DEF(uint32_t, rows1);
+  TILING_DATA_FIELD_DEF(uint32_t, rows2);
+  TILING_DATA_FIELD_DEF(uint32_t, m);
+  TILING_DATA_FIELD_DEF(float, p);
+  TILING_DATA_FIELD_DEF(uint32_t, tileLength);
+  TILING_DATA_FIELD_DEF(uint32_t, usedCoreNum);
+  TILING_DATA_FIELD_DEF(uint32_t, tilingKey);
+  TILING_DATA_FIELD_DEF(uint32_t, pClass);
+  TILING_DATA_FIELD_DEF(uint32_t, blockRows);
+  TILING_DATA_FIELD_DEF(uint32_t, blockCols);
+  TILING_DATA_FIELD_DEF(uint32_t, kChunk);
+  TILING_DATA_FIELD_DEF(uint32_t, chunkNum);
+  TILING_DATA_FIELD_DEF(uint32_t, bufferNum);
+  TILING_DATA_FIELD_DEF(uint32_t, tileNum);
+END_TILING_DATA_DEF;
+
+REGISTER_TILING_DATA_CLASS(PdistCross, PdistCrossTilingData)
+
+// PdistCross 复用 Pdist 的分块 Vector kernel 结构: x1 (rows1 行) 按 Bi 行、x2 (rows2 行) 按 Bj 行切成矩形 tile 网格，
+// 没有下三角，全部 tile 计算量相同；tile 按行主序编号，每核取连续的一段，单段时 x1 块在相邻 tile 间常驻 UB
+// in.n 为 rows1，分块参数与 UB 占用规则同 PlanPdistTiling (tilingKey 取 PdistVectorTilingKey)
+inline PdistTilingPlan PlanPdistCrossTiling(const PdistTilingInput& in, uint32_t rows2) {
+    PdistTilingPlan plan = {};
+    plan.n = in.n;
+    plan.m = in.m;
+    plan.p = in.p;
+    plan.pClass = PdistPClassOf(in.p);
+    plan.rowStride = in.m;
+    plan.schedMode = PDIST_SCHED_STATIC;
+    plan.tileLength = PdistAlignElems(in.m, in.typeSize);
+    plan.tilingKey = PdistVectorTilingKey(in.p);
+    plan.kernelType = PDIST_KERNEL_AIV_ONLY;
+    uint32_t coreNum = (in.coreNumAiv > 0) ? in.coreNumAiv : 1;
+
+    PdistBlockParams bp = PdistDefaultBlockParams(in);
+    uint32_t jBlockNum = (rows2 + bp.blockCols - 1) / bp.blockCols;
+    // tile 数不足每核两块时缩小 Bi
+    while (bp.blockRows > 1 &&
+           static_cast<uint64_t>((in.n + bp.blockRows - 1) / bp.blockRows) * jBlockNum < 2ULL * coreNum) {
+        bp.blockRows /= 2;
+    }
+    if (bp.kChunk > plan.tileLength) {
+        bp.kChunk = plan.tileLength;
+    }
+    plan.blockRows = bp.blockRows;
+    plan.blockCols = bp.blockCols;
+    plan.kChunk = bp.kChunk;
+    plan.chunkNum = (in.m + bp.kChunk - 1) / bp.kChunk;
+    plan.bufferNum = bp.bufferNum;
+
+    uint64_t tileNum = static_cast<uint64_t>((in.n + bp.blockRows - 1) / bp.blockRows) * jBlockNum;
+    plan.tileNum = (tileNum > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(tileNum);
+    plan.usedCoreNum = (tileNum == 0) ? 1 : ((tileNum < coreNum) ? static_cast<uint32_t>(tileNum) : coreNum);
+    plan.blockDim = plan.usedCoreNum;
+    plan.userWorkspaceSize = 0;
+    return plan;
+}
+
+// 将规划结果写入 TilingData (TilingFunc 与 CPU 仿真共用)
+inline void FillPdistCrossTilingData(const PdistTilingPlan& plan, uint32_t rows2, PdistCrossTilingData& tiling) {
+    tiling.set_rows1(plan.n);
+    tiling.set_rows2(rows2);
+    tiling.set_m(plan.m);
+    tiling.set_p(plan.p);
+    tiling.set_tileLength(plan.tileLength);
+    tiling.set_usedCoreNum(plan.usedCoreNum);
+    tiling.set_tilingKey(plan.tilingKey);
+    tiling.set_pClass(plan.pClass);
+    tiling.set_blockRows(plan.blockRows);
+    tiling.set_blockCols(plan.blockCols);
+    tiling.set_kChunk(plan.kChunk);
+    tiling.set_chunkNum(plan.chunkNum);
+    tiling.set_bufferNum(plan.bufferNum);
+    tiling.set_tileNum(plan.tileNum);
+}
+}
+#endif // PDIST_CROSS_TILING_H
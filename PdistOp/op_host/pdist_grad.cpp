@@ -0,0 +1,121 @@
+/**
+ * @file pdist_grad.cpp
+ * @brief Host-side tiling implementation for PdistGrad operator (backward of Pdist)
+ *
+ * Inputs are the forward input x, the forward output y (condensed distances) and grad_y; the output
+ * is grad_x with the shape of x. Upper-triangle (i, j) block pairs are split across AIV cores; each
+ * core adds its partial row gradients into a float accumulator in GM with atomic adds.
+ */
+
+#include "pdist_grad_tiling.h"
+#include "register/op_def_registry.h"
+#include "tiling/platform/platform_ascendc.h"
+
+namespace optiling {
+
+static ge::graphStatus TilingFunc(gert::TilingContext* context) {
+    PdistGradTilingData tiling;
+
+    // 1. 获取输入参数
+    const gert::RuntimeAttrs* attrs = context->GetAttrs();
+    const float* p_ptr = attrs->GetAttrPointer<float>(0);
+    float p = (p_ptr != nullptr) ? *p_ptr : 2.0f;
+
+    const gert::StorageShape* x_shape = context->GetInputShape(0);
+    const gert::StorageShape* y_shape = context->GetInputShape(1);
+    const gert::StorageShape* grad_shape = context->GetInputShape(2);
+    uint32_t n = x_shape->GetStorageShape().GetDim(0);
+    uint32_t m = x_shape->GetStorageShape().GetDim(1);
+    // m = 0 时没有可比较的维度，kChunk 按 0 对齐后切段会除零，直接拒绝
+    if (m == 0) {
+        return ge::GRAPH_FAILED;
+    }
+    // y 与 grad_y 都是 n * (n - 1) / 2 的压缩上三角
+    int64_t pairs = static_cast<int64_t>(n) * (n > 0 ? n - 1 : 0) / 2;
+    if (y_shape->GetStorageShape().GetShapeSize() != pairs || grad_shape->GetStorageShape().GetShapeSize() != pairs) {
+        return ge::GRAPH_FAILED;
+    }
+    uint32_t typeSize = (context->GetInputDesc(0)->GetDataType() == ge::DT_FLOAT) ? 4 : 2; // FP32 / FP16
+
+    // 2. 获取平台信息
+    auto platformInfo = context->GetPlatformInfo();
+    if (platformInfo == nullptr) {
+        return ge::GRAPH_FAILED;
+    }
+    auto ascendcPlatform = platform_ascendc::PlatformAscendC(platformInfo);
+    uint64_t ubSize = 0;
+    ascendcPlatform.GetCoreMemSize(platform_ascendc::CoreMemType::UB, ubSize);
+
+    // 3. 计算切分: 与正向相同只枚举上三角块，块在核间 Cyclic 分配
+    FillPdistGradTilingData(n, m, p, typeSize, ubSize, ascendcPlatform.GetCoreNumAiv(), tiling);
+    context->SetBlockDim(tiling.get_usedCoreNum());
+    context->SetTilingKey(tiling.get_tilingKey());
+
+    // 4. Workspace: 系统 workspace + FP16 时的 float 梯度累加区 (n x m)，最后再转成 half 写入 grad_x
+    size_t* currentWorkspace = context->GetWorkspaceSizes(1);
+    currentWorkspace[0] = ascendcPlatform.GetLibApiWorkSpaceSize() + PdistGradUserWorkspaceBytes(n, m, typeSize);
+
+    tiling.SaveToBuffer(context->GetRawTilingData()->GetData(), context->GetRawTilingData()->GetCapacity());
+    context->GetRawTilingData()->SetDataSize(tiling.GetDataSize());
+
+    return ge::GRAPH_SUCCESS;
+}
+
+} // namespace optiling
+
+namespace ge {
+static ge::graphStatus InferShapeGrad(gert::InferShapeContext* context) {
+    const gert::Shape* x_shape = context->GetInputShape(0);
+    gert::Shape* grad_x_shape = context->GetOutputShape(0);
+    if (x_shape == nullptr || grad_x_shape == nullptr) {
+        return ge::GRAPH_FAILED;
+    }
+
+    // grad_x 与 x 同形
+    *grad_x_shape = *x_shape;
+    return GRAPH_SUCCESS;
+}
+} // namespace ge
+
+namespace ops {
+class PdistGrad : public OpDef {
+public:
+    explicit PdistGrad(const char* name) : OpDef(name) {
+        // 正向输入
+        this->Input("x")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT, ge::DT_FLOAT16})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND});
+
+        // 正向输出 (压缩距离)，用于 p = 2 / 通用 p 的归一化与 p = inf 的最大维度判定
+        this->Input("y")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT, ge::DT_FLOAT16})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND});
+
+        this->Input("grad_y")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT, ge::DT_FLOAT16})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND});
+
+        this->Output("grad_x")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT, ge::DT_FLOAT16})
+            .Format({ge::FORMAT_ND, ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND, ge::FORMAT_ND});
+
+        this->Attr("p")
+            .AttrType(OPTIONAL)
+            .Float(2.0);
+
+        this->SetInferShape(ge::InferShapeGrad);
+        this->AICore().SetTiling(optiling::TilingFunc);
+        this->AICore().AddConfig("ascend910b");
+    }
+};
+
+OP_ADD(PdistGrad);
+} // namespace ops
@@ -0,0 +1,89 @@
+#ifndef PDIST_GRAD_TILING_H
+#define PDIST_GRAD_TILING_H
+#include "register/tilingdata_base.h"
+#include "pdist_tiling_plan.h"
+
+namespace optiling {
+// 反向 kernel 的 i / j 块行数 (行列相同) 与 m 维每段元素数上限 (需与 op_kernel/pdist_grad.cpp 的 buffer 划分一致)
+constexpr uint32_t PDIST_GRAD_BLOCK = 16;
+constexpr uint32_t PDIST_GRAD_MAX_K_CHUNK = 1024;
+
+BEGIN_TILING_DATA_DEF(PdistGradTilingData)
+  TILING_DATA_FIELD_DEF(uint32_t, n);
+  TILING_DATA_FIELD_DEF(uint32_t, m);
+  TILING_DATA_FIELD_DEF(float, p);
+  TILING_DATA_FIELD_DEF(uint32_t, usedCoreNum);
+  TILING_DATA_FIELD_DEF(uint32_t, tilingKey);
+  TILING_DATA_FIELD_DEF(uint32_t, pClass);
+  TILING_DATA_FIELD_DEF(uint32_t, blockRows);
+  TILING_DATA_FIELD_DEF(uint32_t, kChunk);
+  TILING_DATA_FIELD_DEF(uint32_t, chunkNum);
+  TILING_DATA_FIELD_DEF(uint32_t, tileNum);
+END_TILING_DATA_DEF;
+
+REGISTER_TILING_DATA_CLASS(PdistGrad, PdistGradTilingData)
+
+// 单核 UB 占用: i / j 块行 (输入类型，FP16 另有 float 副本)、i / j 行的 float 梯度累加器、
+// 逐 pair 的三个 kChunk 临时行，以及块内 pair 的 grad_y / y 系数 (B x B)
+inline uint64_t PdistGradUbBytes(uint32_t block, uint32_t kChunk, uint32_t typeSize) {
+    uint64_t rowElems = static_cast<uint64_t>(block) * kChunk;
+    uint64_t tileElems = static_cast<uint64_t>(block) * block;
+    uint64_t bytes = 2 * rowElems * typeSize + 2 * rowElems * sizeof(float) + 3ULL * kChunk * sizeof(float) +
+                     3 * tileElems * sizeof(float);
+    if (typeSize != sizeof(float)) {
+        bytes += 2 * rowElems * sizeof(float) + 2 * tileElems * typeSize;
+    }
+    return bytes;
+}
+
+// 在 UB 容量内取最大的 kChunk (32B 对齐)
+inline uint32_t PdistGradKChunk(uint32_t m, uint32_t typeSize, uint64_t ubSize) {
+    uint64_t ub = (ubSize != 0) ? ubSize : PDIST_DEFAULT_UB_SIZE;
+    uint32_t align = 32 / typeSize;
+    uint32_t kChunk = PdistAlignElems((m < PDIST_GRAD_MAX_K_CHUNK) ? m : PDIST_GRAD_MAX_K_CHUNK, typeSize);
+    while (kChunk > align && PdistGradUbBytes(PDIST_GRAD_BLOCK, kChunk, typeSize) + PDIST_UB_RESERVED_BYTES > ub) {
+        kChunk = PdistAlignElems(kChunk / 2, typeSize);
+    }
+    return kChunk;
+}
+
+// 上三角 (含对角) 的 (i 块, j 块) 数
+inline uint32_t PdistGradTileNum(uint32_t n) {
+    uint32_t nb = (n + PDIST_GRAD_BLOCK - 1) / PDIST_GRAD_BLOCK;
+    return nb * (nb + 1) / 2;
+}
+
+// 块在核间 Cyclic 分配，块数不足核数时只用 tileNum 个核 (TilingFunc 与 CPU 仿真共用)
+inline uint32_t PdistGradCoreNum(uint32_t tileNum, uint32_t coreNumAiv) {
+    if (tileNum < coreNumAiv) {
+        return (tileNum == 0) ? 1 : tileNum;
+    }
+    return coreNumAiv;
+}
+
+// user workspace: FP16 时的 float 梯度累加区 (n x m)，最后再转成 half 写入 grad_x
+inline uint64_t PdistGradUserWorkspaceBytes(uint32_t n, uint32_t m, uint32_t typeSize) {
+    if (typeSize == sizeof(float)) {
+        return 0;
+    }
+    return (static_cast<uint64_t>(n) * m * sizeof(float) + 511) / 512 * 512;
+}
+
+// 计算切分并写入 TilingData (TilingFunc 与 CPU 仿真共用)；blockDim 取 usedCoreNum
+inline void FillPdistGradTilingData(uint32_t n, uint32_t m, float p, uint32_t typeSize, uint64_t ubSize,
+                                    uint32_t coreNumAiv, PdistGradTilingData& tiling) {
+    uint32_t kChunk = PdistGradKChunk(m, typeSize, ubSize);
+    uint32_t tileNum = PdistGradTileNum(n);
+    tiling.set_n(n);
+    tiling.set_m(m);
+    tiling.set_p(p);
+    tiling.set_usedCoreNum(PdistGradCoreNum(tileNum, coreNumAiv));
+    tiling.set_tilingKey(1);
+    tiling.set_pClass(PdistPClassOf(p));
+    tiling.set_blockRows(PDIST_GRAD_BLOCK);
+    tiling.set_kChunk(kChunk);
+    tiling.set_chunkNum((m + kChunk - 1) / kChunk);
+    tiling.set_tileNum(tileNum);
+}
+}
+#endif // PDIST_GRAD_TILING_H
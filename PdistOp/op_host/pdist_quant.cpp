@@ -0,0 +1,150 @@
+/**
+ * @file pdist_quant.cpp
+ * @brief Host-side tiling implementation for PdistQuant operator (int8 input with per-row scale / zero point)
+ *
+ * x[i] = scale[i] * (q[i] - zero_point[i]). Tiling is the same plan as Pdist with a 1-byte element:
+ * p = 2 runs the Gram kernel with an int8 Cube matmul (int32 accumulation), other p run the vector
+ * kernel on rows dequantised in UB. The output is always float.
+ */
+
+#include "pdist_tiling.h"
+#include "register/op_def_registry.h"
+#include "tiling/platform/platform_ascendc.h"
+
+namespace optiling {
+
+static ge::graphStatus TilingFunc(gert::TilingContext* context) {
+    PdistTilingData tiling;
+
+    // 1. 获取输入参数
+    const gert::RuntimeAttrs* attrs = context->GetAttrs();
+    const float* p_ptr = attrs->GetAttrPointer<float>(0);
+    float p = (p_ptr != nullptr) ? *p_ptr : 2.0f;
+
+    const gert::StorageShape* x_shape = context->GetInputShape(0);
+    const gert::StorageShape* scale_shape = context->GetInputShape(1);
+    const gert::StorageShape* zp_shape = context->GetOptionalInputShape(2);
+    uint32_t n = x_shape->GetStorageShape().GetDim(0);
+    uint32_t m = x_shape->GetStorageShape().GetDim(1);
+    // m = 0 时没有可比较的维度，kChunk 按 0 对齐后切段会除零，直接拒绝
+    if (m == 0) {
+        return ge::GRAPH_FAILED;
+    }
+    // scale / zero_point 每行一个
+    if (scale_shape == nullptr || scale_shape->GetStorageShape().GetShapeSize() != n) {
+        return ge::GRAPH_FAILED;
+    }
+    if (zp_shape != nullptr && zp_shape->GetStorageShape().GetShapeSize() != n) {
+        return ge::GRAPH_FAILED;
+    }
+
+    // 2. 获取平台信息
+    auto platformInfo = context->GetPlatformInfo();
+    if (platformInfo == nullptr) {
+        return ge::GRAPH_FAILED;
+    }
+    auto ascendcPlatform = platform_ascendc::PlatformAscendC(platformInfo);
+
+    // 3. 计算切分: 与 Pdist 同一套规则，元素为 1 字节 (调优表只覆盖浮点输入，这里直接用启发式)
+    PdistTilingInput in;
+    in.n = n;
+    in.m = m;
+    in.p = p;
+    in.typeSize = 1;
+    in.coreNumAic = ascendcPlatform.GetCoreNumAic();
+    in.coreNumAiv = ascendcPlatform.GetCoreNumAiv();
+    ascendcPlatform.GetCoreMemSize(platform_ascendc::CoreMemType::UB, in.ubSize);
+    ascendcPlatform.GetCoreMemSize(platform_ascendc::CoreMemType::L2, in.l2Size);
+    in.rowStride = 0; // 连续输入，不带 indices
+    in.indexSize = 0;
+    in.nanPolicy = PDIST_NAN_PROPAGATE; // int8 码值恒为有限值
+    in.validityOut = 0;
+    PdistTilingPlan plan = PlanPdistTiling(in);
+    FillPdistTilingData(plan, tiling);
+    if (plan.tilingKey == PDIST_TILING_KEY_GRAM && !FillPdistCubeTiling(plan, in.typeSize, ascendcPlatform, tiling)) {
+        // int8 Cube tiling 求解失败时退回 Vector kernel
+        plan = PlanPdistTiling(in, nullptr, false);
+        FillPdistTilingData(plan, tiling);
+    }
+
+    // 4. 设置使用的核数与 kernel 分支
+    context->SetBlockDim(plan.blockDim);
+    context->SetTilingKey(plan.tilingKey);
+
+    // 5. Workspace: 系统 workspace + Gram 路径的每行系数 / 环形缓冲 + (Profiling 构建时) 每核计数记录区
+    size_t* currentWorkspace = context->GetWorkspaceSizes(1);
+    currentWorkspace[0] = ascendcPlatform.GetLibApiWorkSpaceSize() + plan.userWorkspaceSize;
+
+    // 6. 序列化数据
+    tiling.SaveToBuffer(context->GetRawTilingData()->GetData(), context->GetRawTilingData()->GetCapacity());
+    context->GetRawTilingData()->SetDataSize(tiling.GetDataSize());
+
+    return ge::GRAPH_SUCCESS;
+}
+
+} // namespace optiling
+
+namespace ge {
+static ge::graphStatus InferShapeQuant(gert::InferShapeContext* context) {
+    const gert::Shape* x_shape = context->GetInputShape(0);
+    gert::Shape* y_shape = context->GetOutputShape(0);
+    if (x_shape == nullptr || y_shape == nullptr) {
+        return ge::GRAPH_FAILED;
+    }
+
+    int64_t n = x_shape->GetDim(0);
+    y_shape->SetDimNum(1);
+    y_shape->SetDim(0, n * (n - 1) / 2);
+    return GRAPH_SUCCESS;
+}
+
+static ge::graphStatus InferDataTypeQuant(gert::InferDataTypeContext* context) {
+    // 输出为反量化后的 float 距离
+    context->SetOutputDataType(0, ge::DT_FLOAT);
+    return GRAPH_SUCCESS;
+}
+} // namespace ge
+
+namespace ops {
+class PdistQuant : public OpDef {
+public:
+    explicit PdistQuant(const char* name) : OpDef(name) {
+        this->Input("x")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_INT8})
+            .Format({ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND});
+
+        // 每行的反量化系数: x[i] = scale[i] * (q[i] - zero_point[i])
+        this->Input("scale")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT})
+            .Format({ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND});
+
+        // 不提供时按对称量化 (zero_point = 0)
+        this->Input("zero_point")
+            .ParamType(OPTIONAL)
+            .DataType({ge::DT_INT32})
+            .Format({ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND});
+
+        this->Output("y")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT})
+            .Format({ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND});
+
+        this->Attr("p")
+            .AttrType(OPTIONAL)
+            .Float(2.0);
+
+        this->SetInferShape(ge::InferShapeQuant);
+        this->SetInferDataType(ge::InferDataTypeQuant);
+        this->AICore().SetTiling(optiling::TilingFunc);
+        this->AICore().AddConfig("ascend910b");
+    }
+};
+
+OP_ADD(PdistQuant);
+} // namespace ops
@@ -0,0 +1,114 @@
+/**
+ * @file pdist_sparse.cpp
+ * @brief Host-side tiling implementation for PdistSparse operator (CSR input: indptr, indices, values)
+ *
+ * Rows are n sparse vectors in CSR form with column indices sorted within each row. The kernel merges
+ * the two index lists of every pair, so work and memory scale with nnz instead of n * m.
+ */
+
+#include "pdist_sparse_tiling.h"
+#include "register/op_def_registry.h"
+#include "tiling/platform/platform_ascendc.h"
+
+namespace optiling {
+
+static ge::graphStatus TilingFunc(gert::TilingContext* context) {
+    PdistSparseTilingData tiling;
+
+    // 1. 获取输入参数
+    const gert::RuntimeAttrs* attrs = context->GetAttrs();
+    const float* p_ptr = attrs->GetAttrPointer<float>(0);
+    float p = (p_ptr != nullptr) ? *p_ptr : 2.0f;
+
+    const gert::StorageShape* indptr_shape = context->GetInputShape(0);
+    const gert::StorageShape* indices_shape = context->GetInputShape(1);
+    const gert::StorageShape* values_shape = context->GetInputShape(2);
+    int64_t ptrLen = indptr_shape->GetStorageShape().GetShapeSize();
+    int64_t nnz = values_shape->GetStorageShape().GetShapeSize();
+    // indptr 为 n + 1 个 int32，indices / values 一一对应
+    if (ptrLen < 1 || indices_shape->GetStorageShape().GetShapeSize() != nnz || nnz > INT32_MAX) {
+        return ge::GRAPH_FAILED;
+    }
+    uint32_t n = static_cast<uint32_t>(ptrLen - 1);
+
+    // 2. 获取平台信息
+    auto platformInfo = context->GetPlatformInfo();
+    if (platformInfo == nullptr) {
+        return ge::GRAPH_FAILED;
+    }
+    auto ascendcPlatform = platform_ascendc::PlatformAscendC(platformInfo);
+
+    // 3. 决定核数: 纯 Vector kernel (按行蛇形分配)，行数 n - 1 不足核数时只用 n - 1 个核
+    FillPdistSparseTilingData(n, static_cast<uint32_t>(nnz), p, ascendcPlatform.GetCoreNumAiv(), tiling);
+    context->SetBlockDim(tiling.get_usedCoreNum());
+    context->SetTilingKey(tiling.get_tilingKey());
+
+    // 4. Workspace: 系统 workspace + p = 2 时每行的平方范数
+    size_t* currentWorkspace = context->GetWorkspaceSizes(1);
+    currentWorkspace[0] = ascendcPlatform.GetLibApiWorkSpaceSize() + PdistSparseUserWorkspaceBytes(n, p);
+
+    tiling.SaveToBuffer(context->GetRawTilingData()->GetData(), context->GetRawTilingData()->GetCapacity());
+    context->GetRawTilingData()->SetDataSize(tiling.GetDataSize());
+
+    return ge::GRAPH_SUCCESS;
+}
+
+} // namespace optiling
+
+namespace ge {
+static ge::graphStatus InferShapeSparse(gert::InferShapeContext* context) {
+    const gert::Shape* indptr_shape = context->GetInputShape(0);
+    gert::Shape* y_shape = context->GetOutputShape(0);
+    if (indptr_shape == nullptr || y_shape == nullptr) {
+        return ge::GRAPH_FAILED;
+    }
+
+    // n = len(indptr) - 1，输出与 Pdist 相同的压缩上三角
+    int64_t n = indptr_shape->GetDim(0) - 1;
+    y_shape->SetDimNum(1);
+    y_shape->SetDim(0, (n > 1) ? n * (n - 1) / 2 : 0);
+    return GRAPH_SUCCESS;
+}
+} // namespace ge
+
+namespace ops {
+class PdistSparse : public OpDef {
+public:
+    explicit PdistSparse(const char* name) : OpDef(name) {
+        // 行 i 的非零元为 indices / values 的 [indptr[i], indptr[i + 1])，行内列号递增
+        this->Input("indptr")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_INT32})
+            .Format({ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND});
+
+        this->Input("indices")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_INT32})
+            .Format({ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND});
+
+        this->Input("values")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT})
+            .Format({ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND});
+
+        this->Output("y")
+            .ParamType(REQUIRED)
+            .DataType({ge::DT_FLOAT})
+            .Format({ge::FORMAT_ND})
+            .UnknownShapeFormat({ge::FORMAT_ND});
+
+        this->Attr("p")
+            .AttrType(OPTIONAL)
+            .Float(2.0);
+
+        this->SetInferShape(ge::InferShapeSparse);
+        this->AICore().SetTiling(optiling::TilingFunc);
+        this->AICore().AddConfig("ascend910b");
+    }
+};
+
+OP_ADD(PdistSparse);
+} // namespace ops
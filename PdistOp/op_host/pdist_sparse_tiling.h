@@ -0,0 +1,47 @@
+#ifndef PDIST_SPARSE_TILING_H
+#define PDIST_SPARSE_TILING_H
+#include "register/tilingdata_base.h"
+#include "pdist_tiling_plan.h"
+
+namespace optiling {
+// CSR 输入每次搬入 UB 的窗口长度 (indptr / indices / values 的元素数)，窗口外的访问触发重新搬入
+constexpr uint32_t PDIST_SPARSE_WINDOW = 2048;
+
+BEGIN_TILING_DATA_DEF(PdistSparseTilingData)
+  TILING_DATA_FIELD_DEF(uint32_t, n);
+  TILING_DATA_FIELD_DEF(uint32_t, nnz);
+  TILING_DATA_FIELD_DEF(float, p);
+  TILING_DATA_FIELD_DEF(uint32_t, usedCoreNum);
+  TILING_DATA_FIELD_DEF(uint32_t, tilingKey);
+  TILING_DATA_FIELD_DEF(uint32_t, pClass);
+  TILING_DATA_FIELD_DEF(uint32_t, windowLen);
+END_TILING_DATA_DEF;
+
+REGISTER_TILING_DATA_CLASS(PdistSparse, PdistSparseTilingData)
+
+// 纯 Vector kernel 按行蛇形分配，行数 n - 1 不足核数时只用 n - 1 个核 (TilingFunc 与 CPU 仿真共用)
+inline uint32_t PdistSparseCoreNum(uint32_t n, uint32_t coreNumAiv) {
+    if (n < coreNumAiv + 1) {
+        return (n <= 1) ? 1 : (n - 1);
+    }
+    return coreNumAiv;
+}
+
+// user workspace: p = 2 时存放每行的平方范数
+inline uint64_t PdistSparseUserWorkspaceBytes(uint32_t n, float p) {
+    return (PdistPClassOf(p) == PDIST_P_TWO) ? PdistGramNormBytes(n) : 0;
+}
+
+// 决定核数并写入 TilingData (TilingFunc 与 CPU 仿真共用)；blockDim 取 usedCoreNum
+inline void FillPdistSparseTilingData(uint32_t n, uint32_t nnz, float p, uint32_t coreNumAiv,
+                                      PdistSparseTilingData& tiling) {
+    tiling.set_n(n);
+    tiling.set_nnz(nnz);
+    tiling.set_p(p);
+    tiling.set_usedCoreNum(PdistSparseCoreNum(n, coreNumAiv));
+    tiling.set_tilingKey(1);
+    tiling.set_pClass(PdistPClassOf(p));
+    tiling.set_windowLen(PDIST_SPARSE_WINDOW);
+}
+}
+#endif // PDIST_SPARSE_TILING_H
@@ -1,6 +1,8 @@
 #ifndef PDIST_TILING_H
 #define PDIST_TILING_H
 #include "register/tilingdata_base.h"
+#include "tiling/tiling_api.h"
+#include "pdist_tiling_plan.h"
 
 namespace optiling {
 BEGIN_TILING_DATA_DEF(PdistTilingData)
@@ -10,9 +12,78 @@ BEGIN_TILING_DATA_DEF(PdistTilingData)
   TILING_DATA_FIELD_DEF(uint32_t, tileLength);
   TILING_DATA_FIELD_DEF(uint32_t, usedCoreNum);
   TILING_DATA_FIELD_DEF(uint32_t, tilingKey);
+  TILING_DATA_FIELD_DEF(uint32_t, pClass);
+  TILING_DATA_FIELD_DEF(uint32_t, blockRows);
+  TILING_DATA_FIELD_DEF(uint32_t, blockCols);
+  TILING_DATA_FIELD_DEF(uint32_t, kChunk);
+  TILING_DATA_FIELD_DEF(uint32_t, chunkNum);
+  TILING_DATA_FIELD_DEF(uint32_t, bufferNum);
+  TILING_DATA_FIELD_DEF(uint32_t, bandBlocks);
+  TILING_DATA_FIELD_DEF(uint32_t, tileNum);
+  TILING_DATA_FIELD_DEF(uint32_t, panelBlocks);
+  TILING_DATA_FIELD_DEF(uint32_t, rowStride);
+  TILING_DATA_FIELD_DEF(uint32_t, indexSize);
+  TILING_DATA_FIELD_DEF(uint32_t, schedMode);
+  TILING_DATA_FIELD_DEF(uint32_t, nanPolicy);
+  TILING_DATA_FIELD_DEF(uint32_t, validityOut);
+  // 仅 Gram 路径 (PDIST_TILING_KEY_GRAM) 使用: 单个 Gram 块 x[i0:] * x[j0:]^T 的 Matmul tiling
+  TILING_DATA_FIELD_DEF_STRUCT(TCubeTiling, cubeTiling);
 END_TILING_DATA_DEF;
 
 // 注意这里第一个参数是算子类型名，必须是 Pdist
 REGISTER_TILING_DATA_CLASS(Pdist, PdistTilingData)
+// INT8 量化输入的 PdistQuant 复用同一套分块与 kernel 结构
+REGISTER_TILING_DATA_CLASS(PdistQuant, PdistTilingData)
+
+// 将规划结果写入 TilingData (TilingFunc 与 CPU 仿真共用)
+inline void FillPdistTilingData(const PdistTilingPlan& plan, PdistTilingData& tiling) {
+    tiling.set_n(plan.n);
+    tiling.set_m(plan.m);
+    tiling.set_p(plan.p);
+    tiling.set_tileLength(plan.tileLength);
+    tiling.set_usedCoreNum(plan.usedCoreNum);
+    tiling.set_tilingKey(plan.tilingKey);
+    tiling.set_pClass(plan.pClass);
+    tiling.set_blockRows(plan.blockRows);
+    tiling.set_blockCols(plan.blockCols);
+    tiling.set_kChunk(plan.kChunk);
+    tiling.set_chunkNum(plan.chunkNum);
+    tiling.set_bufferNum(plan.bufferNum);
+    tiling.set_bandBlocks(plan.bandBlocks);
+    tiling.set_tileNum(plan.tileNum);
+    tiling.set_panelBlocks(plan.panelBlocks);
+    tiling.set_rowStride(plan.rowStride);
+    tiling.set_indexSize(plan.indexSize);
+    tiling.set_schedMode(plan.schedMode);
+    tiling.set_nanPolicy(plan.nanPolicy);
+    tiling.set_validityOut(plan.validityOut);
+}
+
+// Gram 路径的 Matmul tiling: A 为 i 块行 (M x m)，B 为 j 块行的转置 (存储为 N x m)，C 为 Gram 块
+// (浮点输入为 float，INT8 输入为 int32 累加)
+// M = N = PDIST_GRAM_TILE，边缘块由 kernel 用 SetTail 缩小；失败时返回 false，由调用方退回 Vector kernel
+inline bool FillPdistCubeTiling(const PdistTilingPlan& plan, uint32_t typeSize,
+                                const platform_ascendc::PlatformAscendC& platform, PdistTilingData& tiling) {
+    matmul_tiling::DataType inType = matmul_tiling::DataType::DT_FLOAT16;
+    matmul_tiling::DataType outType = matmul_tiling::DataType::DT_FLOAT;
+    if (typeSize == 4) {
+        inType = matmul_tiling::DataType::DT_FLOAT;
+    } else if (typeSize == 1) {
+        inType = matmul_tiling::DataType::DT_INT8;
+        outType = matmul_tiling::DataType::DT_INT32;
+    }
+    matmul_tiling::MatmulApiTiling cubeTiling(platform);
+    cubeTiling.SetAType(matmul_tiling::TPosition::GM, matmul_tiling::CubeFormat::ND, inType);
+    cubeTiling.SetBType(matmul_tiling::TPosition::GM, matmul_tiling::CubeFormat::ND, inType, true);
+    cubeTiling.SetCType(matmul_tiling::TPosition::GM, matmul_tiling::CubeFormat::ND, outType);
+    cubeTiling.SetShape(PDIST_GRAM_TILE, PDIST_GRAM_TILE, plan.m);
+    // A / B 的行跨度为 rowStride (视图输入可大于 m；带 indices 时读 workspace 中的连续副本，行跨度为 m)，
+    // C 写入边长 PDIST_GRAM_TILE 的环形缓冲槽
+    uint32_t ka = (plan.indexSize != 0) ? plan.m : plan.rowStride;
+    cubeTiling.SetOrgShape(PDIST_GRAM_TILE, PDIST_GRAM_TILE, ka, ka);
+    cubeTiling.SetBias(false);
+    cubeTiling.SetBufferSpace(-1, -1, -1);
+    return cubeTiling.GetTiling(tiling.cubeTiling) != -1;
+}
 }
-#endif // PDIST_TILING_H
\ No newline at end of file
+#endif // PDIST_TILING_H
@@ -0,0 +1,567 @@
+/**
+ * @file pdist_tiling_plan.h
+ * @brief Pure tiling rules for Pdist (no GE/runtime dependency)
+ *
+ * TilingFunc only gathers shapes and platform info from the TilingContext and calls
+ * PlanPdistTiling; the CPU simulation driver calls the same function, so both run the
+ * kernel with identical tiling.
+ */
+
+#ifndef PDIST_TILING_PLAN_H
+#define PDIST_TILING_PLAN_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace optiling {
+
+// Profiling 构建 (-DPDIST_PROFILE) 在 user workspace 中为每个核预留的记录区
+// 需与 op_kernel/pdist_profile.h 保持一致
+constexpr uint32_t PDIST_PROFILE_MAX_CORES = 64;
+constexpr uint32_t PDIST_PROFILE_RECORD_BYTES = 64;
+
+// p 的分类，由 Host 预先判定，Kernel 内不再做浮点比较 (需与 op_kernel/pdist_common.h 一致)
+enum PdistPClass : uint32_t {
+    PDIST_P_ONE = 0,     // 曼哈顿
+    PDIST_P_TWO = 1,     // 欧氏
+    PDIST_P_INF = 2,     // 切比雪夫
+    PDIST_P_GENERIC = 3, // 通用 p: (Sum |diff|^p)^(1/p)
+};
+
+inline uint32_t PdistPClassOf(float p) {
+    if (std::isinf(p)) {
+        return PDIST_P_INF;
+    }
+    if (p == 1.0f) {
+        return PDIST_P_ONE;
+    }
+    if (p == 2.0f) {
+        return PDIST_P_TWO;
+    }
+    return PDIST_P_GENERIC;
+}
+
+// Kernel 类型决定 blockDim 的含义 (需与各 kernel 的 KERNEL_TASK_TYPE_DEFAULT 一致):
+// 纯 Vector kernel 每个 block 是一个 AIV 核；Cube + Vector 混合 kernel 每个 block 是 1 AIC + 2 AIV
+enum PdistKernelType : uint32_t {
+    PDIST_KERNEL_AIV_ONLY = 0,
+    PDIST_KERNEL_MIX_AIC_1_2 = 1,
+};
+
+// tilingKey (需与 op_kernel/pdist.cpp、pdist_quant.cpp 的 TILING_KEY_IS 分支一致)
+// 分块 Vector kernel 按距离类型各编译一份 (op_kernel/pdist_metric.h 的策略)，内层循环不再按 p 分支
+constexpr uint32_t PDIST_TILING_KEY_VECTOR = 1;       // 通用 p: Exp(p * Ln|diff|)
+constexpr uint32_t PDIST_TILING_KEY_GRAM = 2;         // p = 2: AIC 算 Gram 块，AIV 做后处理
+constexpr uint32_t PDIST_TILING_KEY_VECTOR_L1 = 3;    // p = 1
+constexpr uint32_t PDIST_TILING_KEY_VECTOR_L2 = 4;    // p = 2 (规模不足以走 Gram 路径时)
+constexpr uint32_t PDIST_TILING_KEY_VECTOR_LINF = 5;  // p = inf
+constexpr uint32_t PDIST_TILING_KEY_VECTOR_INT_P = 6; // 整数 p (3 ~ PDIST_INT_P_MAX): |diff|^p 连乘
+
+// 整数 p 走连乘的上限，更大的 p 连乘次数多于 Ln / Exp 的开销，仍按通用 p 处理
+constexpr uint32_t PDIST_INT_P_MAX = 8;
+
+inline bool PdistIsIntP(float p) {
+    return p >= 3.0f && p <= static_cast<float>(PDIST_INT_P_MAX) && p == std::floor(p);
+}
+
+// Vector kernel 中与 p 对应的实例
+inline uint32_t PdistVectorTilingKey(float p) {
+    switch (PdistPClassOf(p)) {
+        case PDIST_P_ONE:
+            return PDIST_TILING_KEY_VECTOR_L1;
+        case PDIST_P_TWO:
+            return PDIST_TILING_KEY_VECTOR_L2;
+        case PDIST_P_INF:
+            return PDIST_TILING_KEY_VECTOR_LINF;
+        default:
+            return PdistIsIntP(p) ? PDIST_TILING_KEY_VECTOR_INT_P : PDIST_TILING_KEY_VECTOR;
+    }
+}
+
+// Vector kernel 的 tile 调度方式 (需与 op_kernel/pdist_common.h 一致)
+enum PdistSchedMode : uint32_t {
+    PDIST_SCHED_AUTO = 0,    // 仅用于 PdistBlockParams: 由规则决定
+    PDIST_SCHED_STATIC = 1,  // Core c 处理第 c, c + usedCoreNum, ... 个 tile
+    PDIST_SCHED_DYNAMIC = 2, // 常驻 kernel: 首个 tile 为第 coreId 个，之后经 workspace 中的原子计数器领取下一个
+};
+
+// 动态调度的 tile 计数器 (int32) 在 user workspace 开头单独占一段，保持后续区域 512B 对齐
+constexpr uint64_t PDIST_SCHED_COUNTER_BYTES = 512;
+
+// Pdist 的 nan_policy 属性: 行中 NaN / ±Inf 的处理方式，在 Vector kernel 搬入行时完成 (需与 op_kernel/pdist_common.h 一致)
+enum PdistNanPolicy : uint32_t {
+    PDIST_NAN_PROPAGATE = 0,  // "propagate": 不做处理，非有限值按 IEEE 规则进入距离
+    PDIST_NAN_IGNORE_DIM = 1, // "ignore-dimension": 一对行中任一侧非有限的维度不计入该 pair 的距离
+    PDIST_NAN_MARK_ROW = 2,   // "mark-row": 含非有限值的行参与的全部 pair 输出 NaN
+};
+
+// 逐行有效性位图 (可选输出 valid): 第 r 行全部有限时字节 r / 8 的第 r % 8 位 (低位在前) 为 1
+inline uint64_t PdistValidityBytes(uint32_t n) {
+    return (static_cast<uint64_t>(n) + 7) / 8;
+}
+
+inline uint32_t PdistKernelTypeOf(uint32_t tilingKey) {
+    return (tilingKey == PDIST_TILING_KEY_GRAM) ? PDIST_KERNEL_MIX_AIC_1_2 : PDIST_KERNEL_AIV_ONLY;
+}
+
+// 该 kernel 类型可用的 block 数上限
+inline uint32_t PdistMaxBlockDim(uint32_t kernelType, uint32_t coreNumAic, uint32_t coreNumAiv) {
+    return (kernelType == PDIST_KERNEL_AIV_ONLY) ? coreNumAiv : coreNumAic;
+}
+
+struct PdistTilingInput {
+    uint32_t n;
+    uint32_t m;
+    float p;
+    uint32_t typeSize;   // 输入元素字节数 (FP32: 4, FP16: 2, INT8: 1 即 PdistQuant)
+    uint32_t coreNumAic; // 平台 AIC 核数
+    uint32_t coreNumAiv; // 平台 AIV 核数
+    uint64_t ubSize;     // 单核 UB 字节数 (0 表示按 910B 的 192KB)
+    uint64_t l2Size;     // 全芯片共享 L2 字节数 (0 表示不限制 j panel 大小)
+    uint32_t rowStride;  // x 相邻两行在 GM 中的元素间隔 (视图输入，>= m；0 表示连续存储即 m)
+    uint32_t indexSize;  // 可选 indices 的元素字节数 (int32: 4, int64: 8)，0 表示不带 indices；带 indices 时 n 为其长度
+    uint32_t nanPolicy;  // PdistNanPolicy
+    uint32_t validityOut; // 1 表示带可选输出 valid (逐行有效性位图)
+};
+
+// 分块参数: 每个任务为 blockRows 个 i 行 x blockCols 个 j 行，m 维按 kChunk 个元素切段
+// 可由离线调优表 / PDIST_TILING_OVERRIDE 给出，否则按启发式选取
+struct PdistBlockParams {
+    uint32_t blockRows; // Bi
+    uint32_t blockCols; // Bj，需为 8 的倍数 (累加器每行 32B 对齐)
+    uint32_t kChunk;    // 每段元素数，需 32B 对齐
+    uint32_t bufferNum; // j 块的队列深度 (1 或 2)
+    uint32_t coreNum;   // 0 表示由规则决定
+    uint32_t schedMode; // PdistSchedMode，PDIST_SCHED_AUTO 表示由规则决定
+};
+
+// 字段与 PdistTilingData 一一对应，另附 launch 参数
+struct PdistTilingPlan {
+    uint32_t n;
+    uint32_t m;
+    float p;
+    uint32_t tileLength;
+    uint32_t usedCoreNum;
+    uint32_t tilingKey;
+    uint32_t pClass;
+    uint32_t kernelType;
+    uint32_t blockRows;
+    uint32_t blockCols;
+    uint32_t kChunk;
+    uint32_t chunkNum;
+    uint32_t bufferNum;
+    uint32_t bandBlocks; // Vector kernel: 每个行带包含的 i 块数
+    uint32_t tileNum;    // Vector kernel: 上三角 (含对角) tile 总数
+    uint32_t panelBlocks; // Vector kernel: 每个 j panel 包含的 j 块数 (按 L2 容量选取)
+    uint32_t rowStride;   // x 的行跨度 (元素)，两个 kernel 都按它寻址行首
+    uint32_t indexSize;   // 非 0 时第 r 个点为 x 的第 indices[r] 行
+    uint32_t schedMode;   // Vector kernel: PDIST_SCHED_STATIC / PDIST_SCHED_DYNAMIC (Gram 路径固定为 STATIC)
+    uint32_t nanPolicy;   // PdistNanPolicy
+    uint32_t validityOut; // 非 0 时 kernel 写出逐行有效性位图
+
+    uint32_t blockDim;
+    uint64_t userWorkspaceSize;
+};
+
+constexpr uint64_t PDIST_DEFAULT_UB_SIZE = 192 * 1024;
+constexpr uint64_t PDIST_UB_RESERVED_BYTES = 4 * 1024;
+constexpr uint32_t PDIST_MAX_K_CHUNK = 2048;
+
+// 每段至多 PDIST_ROW_PACK_MAX_ELEMS 个元素 (一个 256B repeat 的 float) 时，Vector kernel 的 diff / 临时
+// buffer 按整个 j 块分配，单段时一条 Sub / WholeReduce 处理一个 i 行对整块 j 行 (需与 op_kernel/pdist_common.h 一致)
+constexpr uint32_t PDIST_ROW_PACK_MAX_ELEMS = 64;
+
+inline uint64_t PdistDiffElems(const PdistBlockParams& bp) {
+    uint64_t kc = bp.kChunk;
+    return (bp.kChunk <= PDIST_ROW_PACK_MAX_ELEMS) ? static_cast<uint64_t>(bp.blockCols) * kc : kc;
+}
+
+inline bool PdistRowPacked(const PdistTilingPlan& plan) {
+    return plan.tilingKey != PDIST_TILING_KEY_GRAM && plan.chunkNum == 1 && plan.kChunk <= PDIST_ROW_PACK_MAX_ELEMS;
+}
+
+// Gram 路径: Gram 块边长 (行列相同)、每个 AIV 的 GM 环形缓冲深度，以及启用的最小规模
+// 块边长 / 环深度需与 op_kernel/pdist_gram.h 一致
+constexpr uint32_t PDIST_GRAM_TILE = 128;
+constexpr uint32_t PDIST_GRAM_RING_DEPTH = 2;
+constexpr uint32_t PDIST_GRAM_MIN_N = 2 * PDIST_GRAM_TILE;
+constexpr uint32_t PDIST_GRAM_MIN_M = 64;
+constexpr uint32_t PDIST_MIX_AIV_PER_BLOCK = 2; // KERNEL_TYPE_MIX_AIC_1_2
+
+// j panel 至多占用 L2 的这一比例，其余留给 i 行带、输出与其他流量
+constexpr uint32_t PDIST_L2_PANEL_DIVISOR = 2;
+
+// panel 内的 j 行在所有行带扫过之前保持在 L2 中
+inline uint32_t PdistPanelBlocks(uint64_t l2Size, uint32_t tileLength, uint32_t typeSize, uint32_t blockCols,
+                                 uint32_t jBlockNum) {
+    if (l2Size == 0) {
+        return jBlockNum;
+    }
+    uint64_t panelBytes = l2Size / PDIST_L2_PANEL_DIVISOR;
+    uint64_t blockBytes = static_cast<uint64_t>(blockCols) * tileLength * typeSize;
+    uint64_t blocks = panelBytes / blockBytes;
+    if (blocks == 0) {
+        return 1;
+    }
+    return (blocks < jBlockNum) ? static_cast<uint32_t>(blocks) : jBlockNum;
+}
+
+inline uint32_t PdistAlignElems(uint32_t count, uint32_t typeSize) {
+    uint32_t align = 32 / typeSize;
+    return (count + align - 1) / align * align;
+}
+
+// 输出元素字节数: 浮点输入与输入同类型，INT8 输入 (PdistQuant) 输出反量化后的 float 距离
+inline uint32_t PdistOutTypeSize(uint32_t typeSize) {
+    return (typeSize == 1) ? static_cast<uint32_t>(sizeof(float)) : typeSize;
+}
+
+// 分块参数对应的 UB 占用，需与 KernelPdist::Init (及 propagate 布局相同的 KernelPdistCross::Init) 中的 InitBuffer 保持一致
+// 非 propagate 策略或带位图输出时需逐行检查有效性 (i / j 块的行标记与位图输出行)，
+// ignore-dimension 另需 i / j 块的逐元素掩码
+inline uint64_t PdistUbBytes(const PdistBlockParams& bp, uint32_t typeSize,
+                             uint32_t nanPolicy = PDIST_NAN_PROPAGATE, uint32_t validityOut = 0) {
+    uint64_t kc = bp.kChunk;
+    uint64_t bytes = 0;
+    bytes += static_cast<uint64_t>(bp.blockRows) * kc * typeSize;                 // i 块
+    bytes += static_cast<uint64_t>(bp.bufferNum) * bp.blockCols * kc * typeSize;  // j 块队列
+    if (typeSize != sizeof(float)) {
+        bytes += static_cast<uint64_t>(bp.blockRows + bp.blockCols) * kc * sizeof(float); // Cast 缓冲
+    }
+    if (typeSize == 1) {
+        // INT8: int8 -> half 的中间缓冲，以及 i / j 块每行的 scale / zero point
+        bytes += static_cast<uint64_t>(bp.blockRows + bp.blockCols) * kc * 2;
+        bytes += 2 * static_cast<uint64_t>(PdistAlignElems(bp.blockRows, sizeof(float)) +
+                                           PdistAlignElems(bp.blockCols, sizeof(float))) * sizeof(float);
+    }
+    bytes += 2 * PdistDiffElems(bp) * sizeof(float) + 32;                         // diff / ReduceSum 临时 / 标量结果
+    bytes += 2 * static_cast<uint64_t>(bp.blockRows) * bp.blockCols * sizeof(float); // pair 累加器与跨段补偿项
+    uint32_t outSize = PdistOutTypeSize(typeSize);
+    bytes += 2 * static_cast<uint64_t>(PdistAlignElems(bp.blockCols, outSize)) * outSize; // 输出行
+    if (nanPolicy != PDIST_NAN_PROPAGATE || validityOut != 0) {
+        bytes += static_cast<uint64_t>(PdistAlignElems(bp.blockRows, sizeof(float)) +
+                                       PdistAlignElems(bp.blockCols, sizeof(float))) * sizeof(float);
+        bytes += PdistAlignElems((bp.blockCols + 7) / 8, 1);
+    }
+    if (nanPolicy == PDIST_NAN_IGNORE_DIM) {
+        bytes += static_cast<uint64_t>(bp.blockRows + bp.blockCols) * kc * sizeof(float);
+    }
+    return bytes;
+}
+
+inline bool PdistBlockParamsValid(const PdistBlockParams& bp, const PdistTilingInput& in) {
+    uint64_t ub = (in.ubSize == 0) ? PDIST_DEFAULT_UB_SIZE : in.ubSize;
+    return bp.blockRows > 0 && bp.blockCols > 0 && bp.blockCols % 8 == 0 && bp.kChunk > 0 &&
+           bp.kChunk % (32 / in.typeSize) == 0 && (bp.bufferNum == 1 || bp.bufferNum == 2) &&
+           bp.schedMode <= PDIST_SCHED_DYNAMIC &&
+           PdistUbBytes(bp, in.typeSize, in.nanPolicy, in.validityOut) + PDIST_UB_RESERVED_BYTES <= ub;
+}
+
+// 启发式: m 维整行放下 (至多 PDIST_MAX_K_CHUNK 个元素一段)，再取能放下的最大方块 Bi = Bj
+inline PdistBlockParams PdistDefaultBlockParams(const PdistTilingInput& in) {
+    PdistBlockParams bp;
+    bp.bufferNum = 2;
+    bp.coreNum = 0;
+    bp.schedMode = PDIST_SCHED_AUTO;
+    bp.kChunk = PdistAlignElems(in.m < PDIST_MAX_K_CHUNK ? in.m : PDIST_MAX_K_CHUNK, in.typeSize);
+    const uint32_t candidates[] = {64, 32, 16, 8};
+    for (;;) {
+        for (uint32_t b : candidates) {
+            bp.blockRows = b;
+            bp.blockCols = b;
+            if (PdistBlockParamsValid(bp, in)) {
+                return bp;
+            }
+        }
+        // 最小的块也放不下时缩短 kChunk
+        uint32_t half = PdistAlignElems(bp.kChunk / 2, in.typeSize);
+        if (half >= bp.kChunk) {
+            return bp;
+        }
+        bp.kChunk = half;
+    }
+}
+
+// Vector kernel 的 tile 网格: i 方向 Bi 行一块，j 方向 Bj 行一块 (均从 0 开始对齐)
+// tile (ib, jb) 含有 j > i 的 pair 当且仅当 ib < PdistTileRowEnd(jb)，其余 tile 整块在下三角，不枚举
+// PdistFirstTileCol(ib * Bi) 是第 ib 行块可能有效的第一列
+inline uint32_t PdistFirstTileCol(uint64_t iStart, uint32_t blockCols) {
+    return static_cast<uint32_t>((iStart + 1) / blockCols);
+}
+
+// 与 jb 列相交且含 j > i 的 i 块满足 ib < PdistTileRowEnd(jb)
+inline uint32_t PdistTileRowEnd(uint32_t jb, uint32_t n, uint32_t blockRows, uint32_t blockCols) {
+    uint64_t jEnd = static_cast<uint64_t>(jb + 1) * blockCols;
+    uint64_t jMax = ((jEnd < n) ? jEnd : n) - 1;
+    return static_cast<uint32_t>((jMax + blockRows - 1) / blockRows);
+}
+
+// 对角 tile 中存在 j <= i 的元素，需要 kernel 按行屏蔽
+inline bool PdistTileIsDiagonal(uint32_t ib, uint32_t jb, uint32_t n, uint32_t blockRows, uint32_t blockCols) {
+    uint64_t iEnd = static_cast<uint64_t>(ib + 1) * blockRows;
+    uint64_t iMax = ((iEnd < n) ? iEnd : n) - 1;
+    return static_cast<uint64_t>(jb) * blockCols <= iMax;
+}
+
+inline uint64_t PdistCountUpperTiles(uint32_t n, uint32_t blockRows, uint32_t blockCols) {
+    uint32_t iBlockNum = (n + blockRows - 1) / blockRows;
+    uint32_t jBlockNum = (n + blockCols - 1) / blockCols;
+    uint64_t count = 0;
+    for (uint32_t jb = 0; jb < jBlockNum; ++jb) {
+        uint32_t rowEnd = PdistTileRowEnd(jb, n, blockRows, blockCols);
+        count += (rowEnd < iBlockNum) ? rowEnd : iBlockNum;
+    }
+    return count;
+}
+
+// 按 kernel 的调度顺序遍历 tile 列: j 方向切成 panelBlocks 个 j 块一组的 panel，逐个 panel 处理；
+// panel 内行带 (bandBlocks 个 i 块) 从上到下，带内 jb 递增，每列内有效的 i 块是带内的一段前缀
+// [bandStart, bandStart + count)；回调 f(bandStart, jb, count)
+template <typename F>
+inline void PdistForEachTileColumn(const PdistTilingPlan& plan, F f) {
+    uint32_t iBlockNum = (plan.n + plan.blockRows - 1) / plan.blockRows;
+    uint32_t jBlockNum = (plan.n + plan.blockCols - 1) / plan.blockCols;
+    for (uint32_t panelStart = 0; panelStart < jBlockNum; panelStart += plan.panelBlocks) {
+        uint32_t panelEnd = (panelStart + plan.panelBlocks < jBlockNum) ? (panelStart + plan.panelBlocks) : jBlockNum;
+        // 与本 panel 相交且含 j > i 的 i 块
+        uint32_t panelRowEnd = PdistTileRowEnd(panelEnd - 1, plan.n, plan.blockRows, plan.blockCols);
+        panelRowEnd = (panelRowEnd < iBlockNum) ? panelRowEnd : iBlockNum;
+        for (uint32_t bandStart = 0; bandStart < panelRowEnd; bandStart += plan.bandBlocks) {
+            uint32_t bandEnd = (bandStart + plan.bandBlocks < iBlockNum) ? (bandStart + plan.bandBlocks) : iBlockNum;
+            uint32_t jb = PdistFirstTileCol(static_cast<uint64_t>(bandStart) * plan.blockRows, plan.blockCols);
+            jb = (jb > panelStart) ? jb : panelStart;
+            for (; jb < panelEnd; ++jb) {
+                uint32_t rowEnd = PdistTileRowEnd(jb, plan.n, plan.blockRows, plan.blockCols);
+                uint32_t end = (rowEnd < bandEnd) ? rowEnd : bandEnd;
+                if (end > bandStart) {
+                    f(bandStart, jb, end - bandStart);
+                }
+            }
+        }
+    }
+}
+
+// 只有 p = 2 能化成矩阵乘；规模太小时 Cube 启动与 Gram 块的无效部分得不偿失
+// nan_policy 与有效性位图只在 Vector kernel 的搬入阶段实现
+inline bool PdistGramEligible(const PdistTilingInput& in) {
+    return PdistPClassOf(in.p) == PDIST_P_TWO && in.n >= PDIST_GRAM_MIN_N && in.m >= PDIST_GRAM_MIN_M &&
+           in.coreNumAic > 0 && in.nanPolicy == PDIST_NAN_PROPAGATE && in.validityOut == 0;
+}
+
+inline uint32_t PdistGramTileNum(uint32_t n) {
+    uint32_t nb = (n + PDIST_GRAM_TILE - 1) / PDIST_GRAM_TILE;
+    return nb * (nb + 1) / 2; // 只算上三角 (含对角) 的 Gram 块
+}
+
+// INT8 的 Gram 路径 (x = scale * (q - zp)) 每行预计算的系数个数: 反量化后的平方范数、s、s*zp、s*Sum(q)、
+// Sum(q) - m*zp、zp (需与 op_kernel/pdist_gram.h 一致)；浮点输入只有平方范数一项
+constexpr uint32_t PDIST_GRAM_QUANT_AUX_NUM = 6;
+
+inline uint32_t PdistGramAuxNum(uint32_t typeSize) {
+    return (typeSize == 1) ? PDIST_GRAM_QUANT_AUX_NUM : 1;
+}
+
+// Gram 路径的 user workspace: 每行系数 (每项一段，512B 对齐) + 每个 AIV 的 Gram 块环形缓冲 (float / int32)
+inline uint64_t PdistGramNormBytes(uint32_t n) {
+    return (static_cast<uint64_t>(n) * sizeof(float) + 511) / 512 * 512;
+}
+
+inline uint64_t PdistGramWorkspaceBytes(uint32_t n, uint32_t blockDim, uint32_t typeSize) {
+    uint64_t ringBytes = static_cast<uint64_t>(PDIST_GRAM_RING_DEPTH) * PDIST_GRAM_TILE * PDIST_GRAM_TILE * sizeof(float);
+    return PdistGramAuxNum(typeSize) * PdistGramNormBytes(n) +
+           static_cast<uint64_t>(blockDim) * PDIST_MIX_AIV_PER_BLOCK * ringBytes;
+}
+
+// 带 indices 时 Gram 路径在范数预计算中把选中的行写成连续副本 (n x m)，供 Cube 按块读取
+inline uint64_t PdistGramGatherBytes(uint32_t n, uint32_t m, uint32_t typeSize) {
+    return (static_cast<uint64_t>(n) * m * typeSize + 511) / 512 * 512;
+}
+
+// preset 非空且合法时使用 preset (调优表 / 强制指定)，否则使用启发式
+// 调优参数只针对 Vector kernel，给了 preset 或 allowGram 为 false (Cube tiling 失败) 时不走 Gram 路径
+inline PdistTilingPlan PlanPdistTiling(const PdistTilingInput& in, const PdistBlockParams* preset = nullptr,
+                                       bool allowGram = true) {
+    PdistTilingPlan plan;
+    plan.n = in.n;
+    plan.m = in.m;
+    plan.p = in.p;
+    plan.pClass = PdistPClassOf(in.p);
+    plan.rowStride = (in.rowStride > in.m) ? in.rowStride : in.m;
+    plan.indexSize = in.indexSize;
+    plan.schedMode = PDIST_SCHED_STATIC;
+    plan.nanPolicy = in.nanPolicy;
+    plan.validityOut = in.validityOut;
+
+    // 1. 计算对齐后的 m (tileLength)
+    // 硬件要求 DataCopy 地址 32 字节对齐
+    // FP16: 32 bytes = 16 elements
+    // FP32: 32 bytes = 8 elements
+    // 为了稳妥，统一按 32 字节对齐向上取整
+    plan.tileLength = PdistAlignElems(in.m, in.typeSize); // 对齐后的元素个数
+
+    // 2. 选择 kernel，Kernel 类型决定使用 AIC 还是 AIV 的核数
+    bool useGram = (preset == nullptr && allowGram && PdistGramEligible(in));
+    plan.tilingKey = useGram ? PDIST_TILING_KEY_GRAM : PdistVectorTilingKey(in.p);
+    plan.kernelType = PdistKernelTypeOf(plan.tilingKey);
+    uint32_t coreNum = PdistMaxBlockDim(plan.kernelType, in.coreNumAic, in.coreNumAiv);
+    plan.userWorkspaceSize = 0;
+
+    if (useGram) {
+        // Gram 块固定为 PDIST_GRAM_TILE 见方；kChunk 仅用于 AIV 预先计算行范数
+        plan.blockRows = PDIST_GRAM_TILE;
+        plan.blockCols = PDIST_GRAM_TILE;
+        plan.kChunk = PdistAlignElems(in.m < PDIST_MAX_K_CHUNK ? in.m : PDIST_MAX_K_CHUNK, in.typeSize);
+        plan.chunkNum = (in.m + plan.kChunk - 1) / plan.kChunk;
+        plan.bufferNum = 2;
+        plan.bandBlocks = 0;
+        plan.panelBlocks = 0;
+        plan.tileNum = PdistGramTileNum(in.n);
+        // 每个 block 一个 AIC + 两个 AIV，Gram 块在全部 AIV 间 Cyclic 分配
+        uint32_t perBlock = PDIST_MIX_AIV_PER_BLOCK;
+        uint32_t blocksNeeded = (PdistGramTileNum(in.n) + perBlock - 1) / perBlock;
+        plan.usedCoreNum = (blocksNeeded < coreNum) ? blocksNeeded : coreNum;
+        plan.blockDim = plan.usedCoreNum;
+        plan.userWorkspaceSize = PdistGramWorkspaceBytes(in.n, plan.blockDim, in.typeSize);
+        if (in.indexSize != 0) {
+            plan.userWorkspaceSize += PdistGramGatherBytes(in.n, in.m, in.typeSize);
+        }
+#ifdef PDIST_PROFILE
+        plan.userWorkspaceSize += PDIST_PROFILE_MAX_CORES * PDIST_PROFILE_RECORD_BYTES;
+#endif
+        return plan;
+    }
+
+    // preset 先把 kChunk 截到 tileLength 再校验: 截短后可能落入按整个 j 块分配 diff 的行打包布局，UB 占用随之变化
+    bool usePreset = false;
+    PdistBlockParams bp;
+    if (preset != nullptr) {
+        bp = *preset;
+        if (bp.kChunk > plan.tileLength) {
+            bp.kChunk = plan.tileLength;
+        }
+        usePreset = PdistBlockParamsValid(bp, in);
+    }
+    if (!usePreset) {
+        bp = PdistDefaultBlockParams(in);
+        // tile 数不足每核两块时缩小 Bi，避免核数空闲 / 负载不均
+        while (bp.blockRows > 1 && PdistCountUpperTiles(in.n, bp.blockRows, bp.blockCols) < 2ULL * coreNum) {
+            bp.blockRows /= 2;
+        }
+    }
+    plan.blockRows = bp.blockRows;
+    plan.blockCols = bp.blockCols;
+    plan.kChunk = bp.kChunk;
+    plan.chunkNum = (in.m + bp.kChunk - 1) / bp.kChunk;
+    plan.bufferNum = bp.bufferNum;
+
+    // 3. 决定核数 (BlockDim)
+    uint64_t tileNum = PdistCountUpperTiles(in.n, bp.blockRows, bp.blockCols);
+    // kernel 不依赖 tileNum (游标走到最后一个 panel 之后结束)，超出 32 位时饱和
+    plan.tileNum = (tileNum > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(tileNum);
+    uint32_t usedCoreNum = coreNum;
+    if (bp.coreNum > 0 && bp.coreNum < usedCoreNum) {
+        usedCoreNum = bp.coreNum;
+    } else if (in.n < coreNum) {
+        // 小数据量优化：如果 N 很小，没必要用多核，避免通信开销
+        usedCoreNum = 1;
+    }
+    if (usedCoreNum > tileNum) {
+        usedCoreNum = (tileNum == 0) ? 1 : static_cast<uint32_t>(tileNum);
+    }
+    plan.usedCoreNum = usedCoreNum;
+    plan.blockDim = usedCoreNum;
+
+    // 4. 只枚举上三角 tile，按行带顺序编号，Core c 处理第 c, c + usedCoreNum, ... 个 tile
+    // 行带高度取核数: 同一时刻各核处理同一 j 块列上相邻的 i 块，j 行在 L2 中复用；
+    // 各核在带内基本固定同一个 i 块，单段时 i 块可常驻 UB
+    plan.bandBlocks = usedCoreNum;
+    // n x m 大到 x 放不进 L2 时，j 方向按 panel 推进: 各行带依次扫过同一个 panel，
+    // panel 的 j 行只从 HBM 读一次，之后都命中 L2
+    uint32_t jBlockNum = (in.n + bp.blockCols - 1) / bp.blockCols;
+    plan.panelBlocks = PdistPanelBlocks(in.l2Size, plan.tileLength, in.typeSize, bp.blockCols, jBlockNum);
+    if (plan.panelBlocks == 0) {
+        plan.panelBlocks = 1;
+    }
+
+    // 5. 调度方式: 多段时 i 块本就随每段重搬，按领取顺序处理不损失 UB 复用，
+    // 改为动态领取 tile，吸收对角 tile 与 L2 争用带来的各核耗时差异；
+    // 单段时静态 Cyclic 让各核在行带内固定同一个 i 块 (常驻 UB)，保持静态
+    uint32_t schedMode = bp.schedMode;
+    if (schedMode == PDIST_SCHED_AUTO) {
+        schedMode = (plan.chunkNum > 1) ? PDIST_SCHED_DYNAMIC : PDIST_SCHED_STATIC;
+    }
+    // 单核无需领取；计数器为 int32
+    if (usedCoreNum == 1 || tileNum > INT32_MAX) {
+        schedMode = PDIST_SCHED_STATIC;
+    }
+    plan.schedMode = schedMode;
+
+    // 6. user workspace: 动态调度的 tile 计数器 + (Profiling 构建时) 每核计数记录区 (位于末尾)
+    if (plan.schedMode == PDIST_SCHED_DYNAMIC) {
+        plan.userWorkspaceSize += PDIST_SCHED_COUNTER_BYTES;
+    }
+#ifdef PDIST_PROFILE
+    plan.userWorkspaceSize += PDIST_PROFILE_MAX_CORES * PDIST_PROFILE_RECORD_BYTES;
+#endif
+    return plan;
+}
+
+// 每个元素的计算量: Sub + Abs/Mul + Add/Max，通用 p 额外计 Pow 一次
+inline double PdistFlopsPerElement(uint32_t pClass) {
+    return (pClass == PDIST_P_GENERIC) ? 4.0 : 3.0;
+}
+
+// 一次 launch 的 GM 流量与计算量估算，用于 roofline 定位 (需随 kernel 的搬运方式同步更新)
+struct PdistCostModel {
+    double bytesMoved; // GM 读 + 写字节数
+    double flops;
+    bool usesCube;     // 该 tilingKey 的主计算是否在 Cube 上
+};
+
+inline PdistCostModel EstimatePdistCost(const PdistTilingPlan& plan, uint32_t typeSize) {
+    PdistCostModel cost;
+    double pairs = static_cast<double>(plan.n) * (plan.n - 1) / 2.0;
+    double outBytes = pairs * PdistOutTypeSize(typeSize);
+    if (plan.tilingKey == PDIST_TILING_KEY_GRAM) {
+        // 范数预计算读一遍 x；每个 Gram 块读两块行、写 + 读一次 float 的 Gram 块；再写压缩输出
+        double tiles = PdistGramTileNum(plan.n);
+        double tileElems = static_cast<double>(PDIST_GRAM_TILE) * PDIST_GRAM_TILE;
+        double xBytes = static_cast<double>(plan.n) * plan.m * typeSize;
+        cost.bytesMoved = xBytes + tiles * 2.0 * PDIST_GRAM_TILE * plan.m * typeSize +
+                          tiles * tileElems * sizeof(float) * 2.0 + outBytes;
+        cost.flops = tiles * tileElems * 2.0 * plan.m + static_cast<double>(plan.n) * plan.m * 2.0;
+        cost.usesCube = true;
+        return cost;
+    }
+    double rowBytes = static_cast<double>(plan.tileLength) * typeSize;
+    // 按 kernel 的 tile 顺序与 Cyclic 分配复现搬运: 每个 tile 搬入 j 块；
+    // 多段时 i 块随每段重新搬入，单段时只在本核换到另一个 i 块时搬入
+    // (动态调度时 tile 到核的对应关系在运行时决定，此处按 Cyclic 近似)
+    double loadRows = 0.0;
+    uint32_t cores = (plan.usedCoreNum > 0) ? plan.usedCoreNum : 1;
+    std::vector<int64_t> residentIb(cores, -1);
+    uint64_t t = 0;
+    PdistForEachTileColumn(plan, [&](uint32_t bandStart, uint32_t jb, uint32_t count) {
+        uint64_t j0 = static_cast<uint64_t>(jb) * plan.blockCols;
+        uint64_t jCount = (plan.n - j0 < plan.blockCols) ? (plan.n - j0) : plan.blockCols;
+        for (uint32_t ib = bandStart; ib < bandStart + count; ++ib, ++t) {
+            uint64_t i0 = static_cast<uint64_t>(ib) * plan.blockRows;
+            uint64_t iCount = (plan.n - i0 < plan.blockRows) ? (plan.n - i0) : plan.blockRows;
+            int64_t& resident = residentIb[t % cores];
+            loadRows += static_cast<double>(jCount);
+            if (plan.chunkNum > 1 || resident != ib) {
+                loadRows += static_cast<double>(iCount);
+                resident = ib;
+            }
+        }
+    });
+    cost.bytesMoved = loadRows * rowBytes + outBytes;
+    cost.flops = pairs * plan.m * PdistFlopsPerElement(plan.pClass);
+    cost.usesCube = false;
+    return cost;
+}
+
+} // namespace optiling
+
+#endif // PDIST_TILING_PLAN_H
@@ -0,0 +1,115 @@
+/**
+ * @file pdist_tuning.cpp
+ * @brief Offline tuning table for Pdist tiling
+ */
+
+#include "pdist_tuning.h"
+
+#include <dlfcn.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace optiling {
+
+namespace {
+
+struct TuningEntry {
+    uint32_t n;
+    uint32_t m;
+    float p;
+    uint32_t typeSize;
+    PdistBlockParams params;
+};
+
+// 默认表与 tiling 库放在同一目录
+std::string DefaultTablePath() {
+    Dl_info info;
+    if (dladdr(reinterpret_cast<void*>(&LookupPdistTuning), &info) == 0 || info.dli_fname == nullptr) {
+        return "";
+    }
+    std::string path = info.dli_fname;
+    size_t pos = path.rfind('/');
+    return (pos == std::string::npos) ? "pdist_tuning_table.txt" : path.substr(0, pos + 1) + "pdist_tuning_table.txt";
+}
+
+std::vector<TuningEntry> LoadTable() {
+    std::vector<TuningEntry> table;
+    const char* env = std::getenv("PDIST_TUNING_TABLE");
+    std::string path = (env != nullptr) ? env : DefaultTablePath();
+    FILE* f = path.empty() ? nullptr : std::fopen(path.c_str(), "r");
+    if (f == nullptr) {
+        return table;
+    }
+    char line[256];
+    while (std::fgets(line, sizeof(line), f) != nullptr) {
+        if (line[0] == '#') {
+            continue;
+        }
+        TuningEntry e;
+        char pStr[32];
+        char dtype[16];
+        e.params.schedMode = PDIST_SCHED_AUTO;
+        int fields = std::sscanf(line, "%u %u %31s %15s %u %u %u %u %u %u", &e.n, &e.m, pStr, dtype,
+                                 &e.params.blockRows, &e.params.blockCols, &e.params.kChunk, &e.params.bufferNum,
+                                 &e.params.coreNum, &e.params.schedMode);
+        if (fields != 9 && fields != 10) {
+            continue;
+        }
+        e.p = (std::strcmp(pStr, "inf") == 0) ? INFINITY : static_cast<float>(std::atof(pStr));
+        if (std::strcmp(dtype, "fp32") == 0) {
+            e.typeSize = 4;
+        } else if (std::strcmp(dtype, "fp16") == 0) {
+            e.typeSize = 2;
+        } else {
+            continue;
+        }
+        table.push_back(e);
+    }
+    std::fclose(f);
+    return table;
+}
+
+const std::vector<TuningEntry>& Table() {
+    // 首次使用时加载一次
+    static const std::vector<TuningEntry> table = LoadTable();
+    return table;
+}
+
+} // namespace
+
+bool LookupPdistTuning(const PdistTilingInput& in, PdistBlockParams& params) {
+    const TuningEntry* best = nullptr;
+    double bestRatio = 2.0;
+    for (const TuningEntry& e : Table()) {
+        if (e.m != in.m || e.typeSize != in.typeSize || PdistPClassOf(e.p) != PdistPClassOf(in.p) ||
+            (PdistPClassOf(in.p) == PDIST_P_GENERIC && e.p != in.p)) {
+            continue;
+        }
+        double ratio = (e.n > in.n) ? static_cast<double>(e.n) / in.n : static_cast<double>(in.n) / e.n;
+        if (ratio <= bestRatio) {
+            bestRatio = ratio;
+            best = &e;
+        }
+    }
+    if (best == nullptr) {
+        return false;
+    }
+    params = best->params;
+    return true;
+}
+
+bool GetPdistTilingOverride(PdistBlockParams& params) {
+    const char* env = std::getenv("PDIST_TILING_OVERRIDE");
+    if (env == nullptr) {
+        return false;
+    }
+    params.schedMode = PDIST_SCHED_AUTO;
+    int fields = std::sscanf(env, "%u,%u,%u,%u,%u,%u", &params.blockRows, &params.blockCols, &params.kChunk,
+                             &params.bufferNum, &params.coreNum, &params.schedMode);
+    return fields == 5 || fields == 6;
+}
+
+} // namespace optiling
@@ -0,0 +1,28 @@
+/**
+ * @file pdist_tuning.h
+ * @brief Offline tuning table for Pdist tiling (written by TestPdist/autotune.py)
+ *
+ * The table is a text file, one shape per line (# starts a comment):
+ *     n m p dtype blockRows blockCols kChunk bufferNum coreNum [schedMode]
+ * e.g. "4096 128 2 fp32 32 32 128 2 24". schedMode (1 = static, 2 = dynamic) is optional and
+ * defaults to the rule in PlanPdistTiling. It is loaded once, from $PDIST_TUNING_TABLE or
+ * pdist_tuning_table.txt next to the tiling library. Shapes that are not in the table use the
+ * heuristic in pdist_tiling_plan.h.
+ */
+
+#ifndef PDIST_TUNING_H
+#define PDIST_TUNING_H
+
+#include "pdist_tiling_plan.h"
+
+namespace optiling {
+
+// 查表: m / p / dtype 必须一致，n 取最接近且相差不超过 2 倍的条目
+bool LookupPdistTuning(const PdistTilingInput& in, PdistBlockParams& params);
+
+// 调优工具用: 环境变量 PDIST_TILING_OVERRIDE="Bi,Bj,kChunk,bufferNum,coreNum[,schedMode]" 强制指定分块参数
+bool GetPdistTilingOverride(PdistBlockParams& params);
+
+} // namespace optiling
+
+#endif // PDIST_TUNING_H
@@ -4,162 +4,43 @@
  */
 
 #include "kernel_operator.h"
-
-using namespace AscendC;
-
-// 本地定义 Tiling 结构体，确保与 Host 侧一致
-struct KernelTilingData {
-    uint32_t n;
-    uint32_t m;
-    float p;
-    uint32_t tileLength;
-    uint32_t usedCoreNum;
-    uint32_t tilingKey;
-};
-
-constexpr int32_t BUFFER_NUM = 2;
-
-class KernelPdist {
-public:
-    __aicore__ inline KernelPdist() {}
-
-    __aicore__ inline void Init(GM_ADDR x, GM_ADDR y, const KernelTilingData* tData) {
-        // 1. 获取参数
-        n = tData->n;
-        m = tData->m;
-        p = tData->p;
-        tileLength = tData->tileLength;
-        totalCoreNum = tData->usedCoreNum;
-        
-        coreId = GetBlockIdx();
-
-        // 2. 初始化 Global Tensor 和 原生指针
-        xGm.SetGlobalBuffer((__gm__ float*)x);
-        // 保存原生指针用于标量写回 (规避 DataCopyPad 参数问题)
-        yRaw = (__gm__ float*)y; 
-
-        // 3. 初始化 Buffer
-        pipe.InitBuffer(inQueueI, BUFFER_NUM, tileLength * sizeof(float));
-        pipe.InitBuffer(inQueueJ, BUFFER_NUM, tileLength * sizeof(float));
-        // ReduceSum 需要的 workspace (大小为 tileLength * sizeof(T))
-        pipe.InitBuffer(workQueue, 1, tileLength * sizeof(float));
-        // 输出 buffer (虽然直接写指针，但中间计算仍需 tensor)
-        pipe.InitBuffer(outQueue, 1, 32); 
-    }
-
-    __aicore__ inline void Process() {
-        if (coreId >= totalCoreNum) return;
-
-        // Cyclic Tiling 循环
-        for (uint32_t i = coreId; i < n; i += totalCoreNum) {
-            LocalTensor<float> rowI = inQueueI.AllocTensor<float>();
-            CopyRow(rowI, i);
-            inQueueI.EnQue(rowI);
-            rowI = inQueueI.DeQue<float>(); 
-
-            for (uint32_t j = i + 1; j < n; ++j) {
-                ComputeAndSave(rowI, i, j);
-            }
-
-            inQueueI.FreeTensor(rowI); 
-        }
-    }
-
-private:
-    __aicore__ inline void ComputeAndSave(LocalTensor<float>& rowI, uint32_t i, uint32_t j) {
-        LocalTensor<float> rowJ = inQueueJ.AllocTensor<float>();
-        CopyRow(rowJ, j);
-        inQueueJ.EnQue(rowJ);
-        rowJ = inQueueJ.DeQue<float>();
-
-        LocalTensor<float> outLocal = outQueue.AllocTensor<float>();
-        LocalTensor<float> workLocal = workQueue.AllocTensor<float>(); // ReduceSum 临时空间
-
-        // --- Vector 计算核心 ---
-        
-        // 1. |x[i] - x[j]|
-        Sub(rowJ, rowI, rowJ, tileLength);
-        Abs(rowJ, rowJ, tileLength);
-
-        // 2. 根据 P 值处理
-        if (p == 1.0f) {
-            // Sum
-            ReduceSum(outLocal, rowJ, workLocal, tileLength);
-        } else if (p == 2.0f) {
-            // Sqrt(Sum(Square))
-            Mul(rowJ, rowJ, rowJ, tileLength);
-            ReduceSum(outLocal, rowJ, workLocal, tileLength);
-            Sqrt(outLocal, outLocal, 1);
-        } else {
-            // Generic P: (Sum(|diff|^p))^(1/p)
-            // Log -> Mul P -> Exp -> Sum
-            // 防止 0 的 Log 导致 NaN
-            Adds(rowJ, rowJ, 1e-20f, tileLength); 
-            Ln(rowJ, rowJ, tileLength);
-            Muls(rowJ, rowJ, p, tileLength);
-            Exp(rowJ, rowJ, tileLength);
-            
-            ReduceSum(outLocal, rowJ, workLocal, tileLength);
-            
-            // 标量 Pow 放在 Host 或后续处理，这里仅输出 Sum 结果
-            // (为了保证编译通过且逻辑简单，此处暂不调用复杂的标量 Pow)
-        }
-
-        // --- 结果写回 ---
-        
-        // 获取计算结果 (标量)
-        float result = outLocal.GetValue(0);
-        
-        // 计算全局索引
-        uint64_t outIdx = (uint64_t)(2 * n - 1 - i) * i / 2 + (j - i - 1);
-        
-        // 使用原生指针直接写入 GM (最稳妥，无 API 兼容性风险)
-        yRaw[outIdx] = result;
-
-        inQueueJ.FreeTensor(rowJ);
-        // 注意：outLocal 和 workLocal 是从 Queue 分配的吗？
-        // outQueue 我们定义了，workQueue 也定义了，需要释放
-        outQueue.FreeTensor(outLocal);
-        workQueue.FreeTensor(workLocal);
-    }
-
-    __aicore__ inline void CopyRow(LocalTensor<float>& ub, uint32_t rowIdx) {
-        DataCopy(ub, xGm[rowIdx * m], tileLength);
-    }
-
-private:
-    TPipe pipe;
-    TQue<QuePosition::VECIN, BUFFER_NUM> inQueueI, inQueueJ;
-    TQue<QuePosition::VECIN, 1> workQueue;
-    TQue<QuePosition::VECOUT, 1> outQueue;
-    
-    GlobalTensor<float> xGm;
-    __gm__ float* yRaw; // 新增：用于直接写回的指针
-
-    uint32_t n, m;
-    float p;
-    uint32_t tileLength;
-    uint32_t totalCoreNum;
-    uint32_t coreId;
-};
-
-extern "C" __global__ __aicore__ void pdist(GM_ADDR x, GM_ADDR y, GM_ADDR workspace, GM_ADDR tiling) {
-    // 【修复重点】
-    // 1. 先将 void* 转换为 __gm__ 指针，符合地址空间要求
+#include "pdist_gram.h"
+#include "pdist_vector.h"
+
+extern "C" __global__ __aicore__ void pdist(GM_ADDR x, GM_ADDR indices, GM_ADDR y, GM_ADDR valid,
+                                            GM_ADDR workspace, GM_ADDR tiling) {
+    // Vector kernel 按 AIV 核启动；Gram 路径每个 block 为 1 AIC + 2 AIV (见 PdistKernelTypeOf)
+    KERNEL_TASK_TYPE_DEFAULT(KERNEL_TYPE_AIV_ONLY);
+    KERNEL_TASK_TYPE(2, KERNEL_TYPE_MIX_AIC_1_2);
+    // 【修复重点】先将 void* 转换为 __gm__ 指针，再把 GM 数据拷贝到栈上的局部变量
     const __gm__ KernelTilingData* tDataGM = (const __gm__ KernelTilingData*)tiling;
-    
-    // 2. 将 GM 数据拷贝到栈上的局部变量 (Scalar Copy)
-    //    这样 Init 函数接收的就是普通指针，不再有 __gm__ 冲突
     KernelTilingData tDataLocal;
-    tDataLocal.n = tDataGM->n;
-    tDataLocal.m = tDataGM->m;
-    tDataLocal.p = tDataGM->p;
-    tDataLocal.tileLength = tDataGM->tileLength;
-    tDataLocal.usedCoreNum = tDataGM->usedCoreNum;
-    tDataLocal.tilingKey = tDataGM->tilingKey;
-
-    KernelPdist op;
-    // 3. 传入局部变量的地址
-    op.Init(x, y, &tDataLocal);
-    op.Process();
+    LoadKernelTilingData(tDataGM, tDataLocal);
+
+    // DTYPE_X 由算子编译流程按输入 x 的数据类型定义 (float / half)
+    // 可选输入 indices 未提供时地址为空，tDataLocal.indexSize 为 0；可选输出 valid 同理 (只由 Vector kernel 写出)
+    // tilingKey 需与 op_host/pdist_tiling_plan.h 的 PDIST_TILING_KEY_* 一致:
+    // 1 = Vector 通用 p, 2 = Gram, 3 / 4 / 5 = Vector p = 1 / 2 / inf, 6 = Vector 整数 p
+    if (TILING_KEY_IS(1)) {
+        RunPdistVector<DTYPE_X, PdistMetricGeneric>(x, indices, y, valid, GetUserWorkspace(workspace), &tDataLocal);
+    } else if (TILING_KEY_IS(3)) {
+        RunPdistVector<DTYPE_X, PdistMetricL1>(x, indices, y, valid, GetUserWorkspace(workspace), &tDataLocal);
+    } else if (TILING_KEY_IS(4)) {
+        RunPdistVector<DTYPE_X, PdistMetricL2>(x, indices, y, valid, GetUserWorkspace(workspace), &tDataLocal);
+    } else if (TILING_KEY_IS(5)) {
+        RunPdistVector<DTYPE_X, PdistMetricLinf>(x, indices, y, valid, GetUserWorkspace(workspace), &tDataLocal);
+    } else if (TILING_KEY_IS(6)) {
+        RunPdistVector<DTYPE_X, PdistMetricIntP>(x, indices, y, valid, GetUserWorkspace(workspace), &tDataLocal);
+    } else if (TILING_KEY_IS(2)) {
+        LoadKernelCubeTiling(tDataGM, tDataLocal);
+        SetSysWorkspace(workspace);
+        TPipe pipe;
+        KernelPdistGram<DTYPE_X> op;
+        // AIC 在此进入 Matmul 服务循环，执行完 AIV 下发的全部 Gram 块后返回
+        REGIST_MATMUL_OBJ(&pipe, GetSysWorkSpacePtr(), op.mm, &tDataLocal.cubeTiling);
+        op.SetRowIndices(indices, tDataLocal.indexSize);
+        op.Init(x, y, GetUserWorkspace(workspace), tDataLocal.n, tDataLocal.m, tDataLocal.rowStride,
+                tDataLocal.kChunk, tDataLocal.chunkNum, tDataLocal.usedCoreNum, &pipe);
+        op.Process();
+    }
 }
\ No newline at end of file
@@ -0,0 +1,162 @@
+/**
+ * @file pdist_common.h
+ * @brief Vector helpers shared by the Pdist family of kernels
+ */
+
+#ifndef PDIST_COMMON_H
+#define PDIST_COMMON_H
+
+#include "kernel_operator.h"
+
+// p 的分类，由 Host 在 Tiling 时判定 (需与 op_host/pdist_tiling_plan.h 一致)
+constexpr uint32_t PDIST_P_ONE = 0;
+constexpr uint32_t PDIST_P_TWO = 1;
+constexpr uint32_t PDIST_P_INF = 2;
+constexpr uint32_t PDIST_P_GENERIC = 3;
+
+// Vector kernel 的 tile 调度方式与动态调度计数器所占字节数 (需与 op_host/pdist_tiling_plan.h 一致)
+constexpr uint32_t PDIST_SCHED_STATIC = 1;
+constexpr uint32_t PDIST_SCHED_DYNAMIC = 2;
+constexpr uint32_t PDIST_SCHED_COUNTER_BYTES = 512;
+
+// nan_policy (需与 op_host/pdist_tiling_plan.h 的 PdistNanPolicy 一致)
+constexpr uint32_t PDIST_NAN_PROPAGATE = 0;
+constexpr uint32_t PDIST_NAN_IGNORE_DIM = 1;
+constexpr uint32_t PDIST_NAN_MARK_ROW = 2;
+
+// float 的指数位全为 1 即 NaN / ±Inf
+__aicore__ inline bool PdistIsFinite(float v)
+{
+    uint32_t bits = *reinterpret_cast<uint32_t*>(&v);
+    return (bits & 0x7F800000U) != 0x7F800000U;
+}
+
+__aicore__ inline float PdistQuietNaN()
+{
+    uint32_t bits = 0x7FC00000U;
+    return *reinterpret_cast<float*>(&bits);
+}
+
+// 每段不超过该元素数时 diff / 临时 buffer 按整个 j 块分配，单段时按行打包计算 (需与 op_host/pdist_tiling_plan.h 一致)
+constexpr uint32_t PDIST_ROW_PACK_MAX_ELEMS = 64;
+
+// 从 GM 搬入一行 (m 个有效元素)，尾部补零到 tileLength
+// DataCopyPad 按实际字节数搬运，m 不是 32B 对齐时不会读到下一行 / 越过 x 的末尾
+template <typename T>
+__aicore__ inline void CopyRowPad(AscendC::LocalTensor<T>& dst, AscendC::GlobalTensor<T>& src, uint64_t offset,
+                                  uint32_t m, uint32_t tileLength)
+{
+    using namespace AscendC;
+    DataCopyExtParams copyParams{1, static_cast<uint32_t>(m * sizeof(T)), 0, 0, 0};
+    DataCopyPadExtParams<T> padParams{true, 0, static_cast<uint8_t>(tileLength - m), static_cast<T>(0)};
+    DataCopyPad(dst, src[offset], copyParams, padParams);
+}
+
+// 从 GM 搬入 rows 行中 [k0, k0 + len) 这一段 (offset 已指向首行的 k0)，源行长 srcRowLen 个元素
+// UB 中每行占 dstRowLen 个元素 (32B 对齐)，有效数据之后补零到 32B
+template <typename T>
+__aicore__ inline void CopyRowsPad(AscendC::LocalTensor<T>& dst, AscendC::GlobalTensor<T>& src, uint64_t offset,
+                                   uint32_t rows, uint32_t len, uint32_t srcRowLen, uint32_t dstRowLen)
+{
+    using namespace AscendC;
+    uint32_t lenBytes = len * sizeof(T);
+    uint32_t alignedBytes = (lenBytes + 31) / 32 * 32;
+    DataCopyExtParams copyParams{static_cast<uint16_t>(rows), lenBytes,
+                                 static_cast<uint32_t>((srcRowLen - len) * sizeof(T)),
+                                 static_cast<uint32_t>((dstRowLen * sizeof(T) - alignedBytes) / 32), 0};
+    DataCopyPadExtParams<T> padParams{true, 0, static_cast<uint8_t>((alignedBytes - lenBytes) / sizeof(T)),
+                                      static_cast<T>(0)};
+    DataCopyPad(dst, src[offset], copyParams, padParams);
+}
+
+// 点号到 x 行号的映射: Pdist 提供 indices (int32 / int64，indexSize 为其字节数) 时第 r 个点取 x 的第 indices[r] 行，
+// 否则为第 r 行。索引值由 Scalar 直接从 GM 读取，需落在 [0, x 的行数) 内
+class PdistRowMap {
+public:
+    __aicore__ inline void Init(GM_ADDR indices, uint32_t indexSize)
+    {
+        this->indexSize = (indices == nullptr) ? 0 : indexSize;
+        if (this->indexSize == sizeof(int64_t)) {
+            idx64Gm.SetGlobalBuffer((__gm__ int64_t*)indices);
+        } else if (this->indexSize == sizeof(int32_t)) {
+            idx32Gm.SetGlobalBuffer((__gm__ int32_t*)indices);
+        }
+    }
+
+    __aicore__ inline bool Gathered() const { return indexSize != 0; }
+
+    __aicore__ inline uint64_t Row(uint32_t r)
+    {
+        if (indexSize == sizeof(int64_t)) {
+            return static_cast<uint64_t>(idx64Gm.GetValue(r));
+        }
+        if (indexSize == sizeof(int32_t)) {
+            return static_cast<uint64_t>(idx32Gm.GetValue(r));
+        }
+        return r;
+    }
+
+private:
+    AscendC::GlobalTensor<int32_t> idx32Gm;
+    AscendC::GlobalTensor<int64_t> idx64Gm;
+    uint32_t indexSize = 0;
+};
+
+// 按行号映射搬入第 [row0, row0 + rows) 个点的 [k0, k0 + len) 段，x 的行跨度为 srcRowLen
+// 无映射时行间等距，一次 strided DataCopyPad 搬完；有映射时逐行搬入
+template <typename T>
+__aicore__ inline void CopyRowsMapped(AscendC::LocalTensor<T>& dst, AscendC::GlobalTensor<T>& src,
+                                      PdistRowMap& rowMap, uint32_t row0, uint32_t rows, uint32_t k0, uint32_t len,
+                                      uint32_t srcRowLen, uint32_t dstRowLen)
+{
+    if (!rowMap.Gathered()) {
+        CopyRowsPad<T>(dst, src, (uint64_t)row0 * srcRowLen + k0, rows, len, srcRowLen, dstRowLen);
+        return;
+    }
+    for (uint32_t r = 0; r < rows; ++r) {
+        AscendC::LocalTensor<T> dstRow = dst[r * dstRowLen];
+        CopyRowsPad<T>(dstRow, src, rowMap.Row(row0 + r) * srcRowLen + k0, 1, len, srcRowLen, dstRowLen);
+    }
+}
+
+// 将搬入的一行转成 float 参与计算；FP32 输入直接返回原 tensor，FP16 输入 Cast 到 castBuf
+template <typename T>
+__aicore__ inline AscendC::LocalTensor<float> RowAsFloat(AscendC::LocalTensor<T>& raw,
+                                                         AscendC::TBuf<AscendC::TPosition::VECCALC>& castBuf,
+                                                         uint32_t len)
+{
+    using namespace AscendC;
+    if constexpr (IsSameType<T, float>::value) {
+        return raw;
+    } else {
+        LocalTensor<float> rowF = castBuf.Get<float>();
+        Cast(rowF, raw, RoundMode::CAST_NONE, len);
+        return rowF;
+    }
+}
+
+// 补偿求和 (Neumaier): 每次加法的舍入误差记入 comp，最终结果为 sum + comp
+// 段内由 ReduceSum 的归约树求和，跨段 / 逐元素的 Scalar 累加用它，m 很大时误差不随段数线性增长
+__aicore__ inline void KahanAdd(float& sum, float& comp, float value)
+{
+    float t = sum + value;
+    float absSum = (sum < 0.0f) ? -sum : sum;
+    float absValue = (value < 0.0f) ? -value : value;
+    comp += (absSum >= absValue) ? ((sum - t) + value) : ((value - t) + sum);
+    sum = t;
+}
+
+// 对 count 个已合并的部分结果原地开方，得到最终距离
+__aicore__ inline void MinkowskiFinalize(AscendC::LocalTensor<float>& vals, uint32_t count, float p, uint32_t pClass)
+{
+    using namespace AscendC;
+    if (pClass == PDIST_P_TWO) {
+        Sqrt(vals, vals, count);
+    } else if (pClass == PDIST_P_GENERIC) {
+        Ln(vals, vals, count);
+        Muls(vals, vals, 1.0f / p, count);
+        Exp(vals, vals, count);
+    }
+}
+
+#endif // PDIST_COMMON_H
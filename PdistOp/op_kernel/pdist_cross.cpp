@@ -0,0 +1,293 @@
+/**
+ * @file pdist_cross.cpp
+ * @brief Kernel implementation for PdistCross Operator (off-diagonal panel of Pdist)
+ *
+ * Same blocked structure as KernelPdist (pdist_vector.h): x1 / x2 row blocks are staged in UB per
+ * m chunk, pair partials are combined in a UB accumulator and each output row segment is written
+ * back with one DataCopyPad. The distance math comes from the metric policies in pdist_metric.h,
+ * one instantiation per tilingKey (PdistVectorTilingKey in op_host/pdist_tiling_plan.h).
+ */
+
+#include "kernel_operator.h"
+#include "pdist_common.h"
+#include "pdist_metric.h"
+
+using namespace AscendC;
+
+// 本地定义 Tiling 结构体，确保与 Host 侧一致
+struct KernelCrossTilingData {
+    uint32_t rows1;
+    uint32_t rows2;
+    uint32_t m;
+    float p;
+    uint32_t tileLength;
+    uint32_t usedCoreNum;
+    uint32_t tilingKey;
+    uint32_t pClass;
+    uint32_t blockRows;
+    uint32_t blockCols;
+    uint32_t kChunk;
+    uint32_t chunkNum;
+    uint32_t bufferNum;
+    uint32_t tileNum;
+};
+
+constexpr int32_t CROSS_BUFFER_NUM = 2;
+
+// 计算 x1 (rows1 x m) 与 x2 (rows2 x m) 两两之间的距离，输出 rows1 x rows2 的稠密块 (行主序)
+// 分块: Bi 个 x1 行 x Bj 个 x2 行为一个 tile，矩形网格按行主序编号，Core c 处理连续的一段 tile；
+// m 维按 kChunk 切段，各段部分结果在 UB 累加器中补偿求和 (p = inf 取 Max) 后开方、按行写回
+// 单段时 x1 块在同一核的相邻 tile 间常驻 UB，且段长不超过 PDIST_ROW_PACK_MAX_ELEMS 时按行打包计算
+template <typename T, typename Metric>
+class KernelPdistCross {
+public:
+    __aicore__ inline KernelPdistCross() {}
+
+    __aicore__ inline void Init(GM_ADDR x1, GM_ADDR x2, GM_ADDR y, const KernelCrossTilingData* tData) {
+        rows1 = tData->rows1;
+        rows2 = tData->rows2;
+        m = tData->m;
+        p = tData->p;
+        totalCoreNum = tData->usedCoreNum;
+        blockRows = tData->blockRows;
+        blockCols = tData->blockCols;
+        kChunk = tData->kChunk;
+        chunkNum = tData->chunkNum;
+        tileNum = tData->tileNum;
+        iBlockNum = (rows1 + blockRows - 1) / blockRows;
+        jBlockNum = (rows2 + blockCols - 1) / blockCols;
+
+        coreId = GetBlockIdx();
+
+        x1Gm.SetGlobalBuffer((__gm__ T*)x1);
+        x2Gm.SetGlobalBuffer((__gm__ T*)x2);
+        yGm.SetGlobalBuffer((__gm__ T*)y);
+
+        // 大小需与 Host 侧 PdistUbBytes 一致 (与 KernelPdist 的 propagate 布局相同)
+        pipe.InitBuffer(inQueueI, 1, blockRows * kChunk * sizeof(T));
+        pipe.InitBuffer(inQueueJ, tData->bufferNum, blockCols * kChunk * sizeof(T));
+        if constexpr (!IsSameType<T, float>::value) {
+            pipe.InitBuffer(castBufI, blockRows * kChunk * sizeof(float));
+            pipe.InitBuffer(castBufJ, blockCols * kChunk * sizeof(float));
+        }
+        rowPacked = (chunkNum == 1 && kChunk <= PDIST_ROW_PACK_MAX_ELEMS);
+        uint32_t diffElems = (kChunk <= PDIST_ROW_PACK_MAX_ELEMS) ? blockCols * kChunk : kChunk;
+        pipe.InitBuffer(diffBuf, diffElems * sizeof(float));
+        pipe.InitBuffer(workBuf, diffElems * sizeof(float));
+        pipe.InitBuffer(reduceBuf, 32);
+        pipe.InitBuffer(accBuf, blockRows * blockCols * sizeof(float));
+        pipe.InitBuffer(compBuf, blockRows * blockCols * sizeof(float));
+        pipe.InitBuffer(outQueue, CROSS_BUFFER_NUM, (blockCols * sizeof(T) + 31) / 32 * 32);
+    }
+
+    __aicore__ inline void Process() {
+        if (coreId >= totalCoreNum) return;
+
+        // 全部 tile 计算量相同，按编号平均切成 usedCoreNum 段；行主序使本核相邻 tile 多为同一个 x1 块
+        uint32_t begin = static_cast<uint32_t>((uint64_t)tileNum * coreId / totalCoreNum);
+        uint32_t end = static_cast<uint32_t>((uint64_t)tileNum * (coreId + 1) / totalCoreNum);
+        residentIb = iBlockNum;
+        for (uint32_t t = begin; t < end; ++t) {
+            ProcessTile(t / jBlockNum, t % jBlockNum);
+        }
+        if (residentIb < iBlockNum) {
+            inQueueI.FreeTensor(iRaw);
+        }
+    }
+
+private:
+    __aicore__ inline void ProcessTile(uint32_t ib, uint32_t jb) {
+        uint32_t i0 = ib * blockRows;
+        uint32_t iCount = (rows1 - i0 < blockRows) ? (rows1 - i0) : blockRows;
+        uint32_t j0 = jb * blockCols;
+        uint32_t jCount = (rows2 - j0 < blockCols) ? (rows2 - j0) : blockCols;
+
+        for (uint32_t c = 0; c < chunkNum; ++c) {
+            uint32_t k0 = c * kChunk;
+            uint32_t kLen = (m - k0 < kChunk) ? (m - k0) : kChunk;
+            uint32_t kLenAligned = (kLen * sizeof(T) + 31) / 32 * 32 / sizeof(T);
+
+            // 单段时 x1 块常驻 UB，直到本核换到另一个 x1 块；多段时随每段重新搬入
+            if (residentIb != ib) {
+                if (residentIb < iBlockNum) {
+                    inQueueI.FreeTensor(iRaw);
+                    residentIb = iBlockNum;
+                }
+                iRaw = inQueueI.template AllocTensor<T>();
+                CopyRowsPad<T>(iRaw, x1Gm, (uint64_t)i0 * m + k0, iCount, kLen, m, kChunk);
+                inQueueI.EnQue(iRaw);
+                iRaw = inQueueI.template DeQue<T>();
+                iF = RowAsFloat<T>(iRaw, castBufI, iCount * kChunk);
+                if (chunkNum == 1) {
+                    residentIb = ib;
+                }
+            }
+
+            LocalTensor<T> jRaw = inQueueJ.template AllocTensor<T>();
+            CopyRowsPad<T>(jRaw, x2Gm, (uint64_t)j0 * m + k0, jCount, kLen, m, kChunk);
+            inQueueJ.EnQue(jRaw);
+            jRaw = inQueueJ.template DeQue<T>();
+            LocalTensor<float> jF = RowAsFloat<T>(jRaw, castBufJ, jCount * kChunk);
+
+            if (rowPacked) {
+                AccumulatePacked(jF, iCount, jCount);
+            } else {
+                AccumulateChunk(jF, iCount, jCount, kLenAligned, c == 0);
+            }
+
+            inQueueJ.FreeTensor(jRaw);
+            if (residentIb != ib) {
+                inQueueI.FreeTensor(iRaw);
+            }
+        }
+
+        WriteBlock(i0, iCount, j0, jCount);
+    }
+
+    // 累加器第 ii 行存放 x1 第 i0 + ii 行对本块 x2 行的部分结果，跨段舍入误差记在补偿累加器中
+    __aicore__ inline void AccumulateChunk(LocalTensor<float>& jF, uint32_t iCount, uint32_t jCount, uint32_t len,
+                                           bool firstChunk) {
+        LocalTensor<float> acc = accBuf.Get<float>();
+        LocalTensor<float> comp = compBuf.Get<float>();
+        LocalTensor<float> diff = diffBuf.Get<float>();
+        LocalTensor<float> work = workBuf.Get<float>();
+        LocalTensor<float> red = reduceBuf.Get<float>();
+
+        for (uint32_t ii = 0; ii < iCount; ++ii) {
+            LocalTensor<float> rowI = iF[ii * kChunk];
+            for (uint32_t jj = 0; jj < jCount; ++jj) {
+                LocalTensor<float> rowJ = jF[jj * kChunk];
+                float partial = PdistMetricPartial<Metric>(rowI, rowJ, diff, red, work, len, p);
+                uint32_t idx = ii * blockCols + jj;
+                if (firstChunk) {
+                    acc.SetValue(idx, partial);
+                    comp.SetValue(idx, 0.0f);
+                } else if constexpr (Metric::MAX_COMBINE) {
+                    float prev = acc.GetValue(idx);
+                    acc.SetValue(idx, (partial > prev) ? partial : prev);
+                } else {
+                    float sum = acc.GetValue(idx);
+                    float c = comp.GetValue(idx);
+                    KahanAdd(sum, c, partial);
+                    acc.SetValue(idx, sum);
+                    comp.SetValue(idx, c);
+                }
+            }
+        }
+    }
+
+    // 单段短行: 一个 x1 行对本块全部 x2 行只需一条 Sub、一组逐元素变换和一条分段归约，结果直接写入累加器行
+    __aicore__ inline void AccumulatePacked(LocalTensor<float>& jF, uint32_t iCount, uint32_t jCount) {
+        LocalTensor<float> acc = accBuf.Get<float>();
+        LocalTensor<float> diff = diffBuf.Get<float>();
+        LocalTensor<float> work = workBuf.Get<float>();
+
+        for (uint32_t ii = 0; ii < iCount; ++ii) {
+            LocalTensor<float> rowI = iF[ii * kChunk];
+            LocalTensor<float> accRow = acc[ii * blockCols];
+            PdistMetricRows<Metric>(accRow, rowI, jF, diff, work, kChunk, jCount, p);
+        }
+    }
+
+    __aicore__ inline void WriteBlock(uint32_t i0, uint32_t iCount, uint32_t j0, uint32_t jCount) {
+        LocalTensor<float> acc = accBuf.Get<float>();
+        // 累加器由 Scalar 写入 (按行打包时由 Vector 写入，同步无副作用)，Vector 读取前同步
+        event_t eventSV = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::S_V));
+        SetFlag<HardEvent::S_V>(eventSV);
+        WaitFlag<HardEvent::S_V>(eventSV);
+
+        for (uint32_t ii = 0; ii < iCount; ++ii) {
+            LocalTensor<float> accRow = acc[ii * blockCols];
+            if constexpr (!Metric::MAX_COMBINE) {
+                if (chunkNum > 1) {
+                    LocalTensor<float> compRow = compBuf.Get<float>()[ii * blockCols];
+                    Add(accRow, accRow, compRow, jCount);
+                }
+            }
+            Metric::Finalize(accRow, jCount, p);
+
+            LocalTensor<T> yLocal = outQueue.template AllocTensor<T>();
+            if constexpr (IsSameType<T, float>::value) {
+                Adds(yLocal, accRow, 0.0f, jCount);
+            } else {
+                Cast(yLocal, accRow, RoundMode::CAST_ROUND, jCount);
+            }
+            outQueue.EnQue(yLocal);
+            yLocal = outQueue.template DeQue<T>();
+
+            // 稠密块第 i0 + ii 行的 [j0, j0 + jCount) 是连续的一段
+            DataCopyExtParams copyParams{1, static_cast<uint32_t>(jCount * sizeof(T)), 0, 0, 0};
+            DataCopyPad(yGm[(uint64_t)(i0 + ii) * rows2 + j0], yLocal, copyParams);
+            outQueue.FreeTensor(yLocal);
+        }
+    }
+
+private:
+    TPipe pipe;
+    TQue<QuePosition::VECIN, 1> inQueueI;
+    TQue<QuePosition::VECIN, CROSS_BUFFER_NUM> inQueueJ;
+    TQue<QuePosition::VECOUT, CROSS_BUFFER_NUM> outQueue;
+    TBuf<TPosition::VECCALC> castBufI, castBufJ;
+    TBuf<TPosition::VECCALC> diffBuf, workBuf, reduceBuf, accBuf, compBuf;
+
+    GlobalTensor<T> x1Gm;
+    GlobalTensor<T> x2Gm;
+    GlobalTensor<T> yGm;
+
+    uint32_t rows1, rows2, m;
+    float p;
+    uint32_t totalCoreNum;
+    uint32_t coreId;
+    uint32_t blockRows, blockCols;
+    uint32_t kChunk, chunkNum;
+    uint32_t tileNum;
+    uint32_t iBlockNum, jBlockNum;
+    bool rowPacked;
+
+    // 常驻 UB 的 x1 块 (residentIb == iBlockNum 表示无)
+    uint32_t residentIb;
+    LocalTensor<T> iRaw;
+    LocalTensor<float> iF;
+};
+
+template <typename T, typename Metric>
+__aicore__ inline void RunPdistCross(GM_ADDR x1, GM_ADDR x2, GM_ADDR y, const KernelCrossTilingData* tData) {
+    KernelPdistCross<T, Metric> op;
+    op.Init(x1, x2, y, tData);
+    op.Process();
+}
+
+extern "C" __global__ __aicore__ void pdist_cross(GM_ADDR x1, GM_ADDR x2, GM_ADDR y, GM_ADDR workspace,
+                                                  GM_ADDR tiling) {
+    KERNEL_TASK_TYPE_DEFAULT(KERNEL_TYPE_AIV_ONLY);
+    const __gm__ KernelCrossTilingData* tDataGM = (const __gm__ KernelCrossTilingData*)tiling;
+
+    KernelCrossTilingData tDataLocal;
+    tDataLocal.rows1 = tDataGM->rows1;
+    tDataLocal.rows2 = tDataGM->rows2;
+    tDataLocal.m = tDataGM->m;
+    tDataLocal.p = tDataGM->p;
+    tDataLocal.tileLength = tDataGM->tileLength;
+    tDataLocal.usedCoreNum = tDataGM->usedCoreNum;
+    tDataLocal.tilingKey = tDataGM->tilingKey;
+    tDataLocal.pClass = tDataGM->pClass;
+    tDataLocal.blockRows = tDataGM->blockRows;
+    tDataLocal.blockCols = tDataGM->blockCols;
+    tDataLocal.kChunk = tDataGM->kChunk;
+    tDataLocal.chunkNum = tDataGM->chunkNum;
+    tDataLocal.bufferNum = tDataGM->bufferNum;
+    tDataLocal.tileNum = tDataGM->tileNum;
+
+    // tilingKey 同 Pdist 的 Vector 分支: 1 = 通用 p, 3 / 4 / 5 = p = 1 / 2 / inf, 6 = 整数 p
+    if (TILING_KEY_IS(1)) {
+        RunPdistCross<DTYPE_X1, PdistMetricGeneric>(x1, x2, y, &tDataLocal);
+    } else if (TILING_KEY_IS(3)) {
+        RunPdistCross<DTYPE_X1, PdistMetricL1>(x1, x2, y, &tDataLocal);
+    } else if (TILING_KEY_IS(4)) {
+        RunPdistCross<DTYPE_X1, PdistMetricL2>(x1, x2, y, &tDataLocal);
+    } else if (TILING_KEY_IS(5)) {
+        RunPdistCross<DTYPE_X1, PdistMetricLinf>(x1, x2, y, &tDataLocal);
+    } else if (TILING_KEY_IS(6)) {
+        RunPdistCross<DTYPE_X1, PdistMetricIntP>(x1, x2, y, &tDataLocal);
+    }
+}
@@ -0,0 +1,396 @@
+/**
+ * @file pdist_grad.cpp
+ * @brief Kernel implementation for PdistGrad Operator (backward of Pdist)
+ *
+ * grad_x[i] = sum_{j != i} g_ij * dd_ij/dx_i, and dd_ij/dx_j = -dd_ij/dx_i. Like the forward, only
+ * upper-triangle (i, j) block pairs are visited; for each K-chunk a block pair accumulates the i-row
+ * and j-row contributions in UB and atomically adds both into a float accumulator in GM, so the
+ * per-pair difference vectors never leave UB. FP16 accumulates in a float workspace that is cast to
+ * half once all cores are done.
+ */
+
+#include "kernel_operator.h"
+#include "pdist_common.h"
+
+using namespace AscendC;
+
+// 本地定义 Tiling 结构体，确保与 Host 侧一致
+struct KernelGradTilingData {
+    uint32_t n;
+    uint32_t m;
+    float p;
+    uint32_t usedCoreNum;
+    uint32_t tilingKey;
+    uint32_t pClass;
+    uint32_t blockRows;
+    uint32_t kChunk;
+    uint32_t chunkNum;
+    uint32_t tileNum;
+};
+
+// 避免 0 作除数 / 取对数；p = inf 判定 |diff| == d 的相对容差 (FP16 的 y 已舍入到 half)
+constexpr float PDIST_GRAD_TINY = 1e-30f;
+constexpr float PDIST_GRAD_INF_TOL_FP32 = 1e-6f;
+constexpr float PDIST_GRAD_INF_TOL_FP16 = 1e-3f;
+
+// 逐 pair 的方向向量 w 与系数 c 满足 dd_ij/dx_i = c_ij * w_ij:
+//   p = 1: w = sign(diff), c = 1；p = 2: w = diff, c = 1 / d；
+//   p = inf: w = sign(diff) * [|diff| == d], c = 1；通用 p: w = diff * |diff|^(p - 2), c = d^(1 - p)
+// c 再乘上 grad_y 后按块预先算好，内层只剩 Vector 计算 w 与两次 Axpy
+template <typename T>
+class KernelPdistGrad {
+public:
+    __aicore__ inline KernelPdistGrad() {}
+
+    __aicore__ inline void Init(GM_ADDR x, GM_ADDR y, GM_ADDR gradY, GM_ADDR gradX, GM_ADDR usrWorkspace,
+                                const KernelGradTilingData* tData) {
+        n = tData->n;
+        m = tData->m;
+        p = tData->p;
+        pClass = tData->pClass;
+        totalCoreNum = tData->usedCoreNum;
+        block = tData->blockRows;
+        kChunk = tData->kChunk;
+        chunkNum = tData->chunkNum;
+        coreId = GetBlockIdx();
+        infTol = IsSameType<T, float>::value ? PDIST_GRAD_INF_TOL_FP32 : PDIST_GRAD_INF_TOL_FP16;
+
+        xGm.SetGlobalBuffer((__gm__ T*)x);
+        yGm.SetGlobalBuffer((__gm__ T*)y);
+        gradYGm.SetGlobalBuffer((__gm__ T*)gradY);
+        gradXGm.SetGlobalBuffer((__gm__ T*)gradX);
+        // FP32 直接在 grad_x 上累加，FP16 先累加到 workspace 的 float 区
+        if constexpr (IsSameType<T, float>::value) {
+            accGm.SetGlobalBuffer((__gm__ float*)gradX);
+        } else {
+            accGm.SetGlobalBuffer((__gm__ float*)usrWorkspace);
+        }
+
+        // Buffer 大小需与 Host 侧 PdistGradUbBytes 一致
+        uint32_t rowElems = block * kChunk;
+        uint32_t tileElems = block * block;
+        pipe.InitBuffer(inQueueI, 1, rowElems * sizeof(T));
+        pipe.InitBuffer(inQueueJ, 1, rowElems * sizeof(T));
+        pipe.InitBuffer(accIBuf, rowElems * sizeof(float));
+        pipe.InitBuffer(accJBuf, rowElems * sizeof(float));
+        pipe.InitBuffer(diffBuf, kChunk * sizeof(float));
+        pipe.InitBuffer(absBuf, kChunk * sizeof(float));
+        pipe.InitBuffer(tmpBuf, kChunk * sizeof(float));
+        pipe.InitBuffer(gradTileBuf, tileElems * sizeof(float));
+        pipe.InitBuffer(distTileBuf, tileElems * sizeof(float));
+        pipe.InitBuffer(coefTileBuf, tileElems * sizeof(float));
+        if constexpr (!IsSameType<T, float>::value) {
+            pipe.InitBuffer(castBufI, rowElems * sizeof(float));
+            pipe.InitBuffer(castBufJ, rowElems * sizeof(float));
+            pipe.InitBuffer(gradRawBuf, tileElems * sizeof(T));
+            pipe.InitBuffer(distRawBuf, tileElems * sizeof(T));
+        }
+    }
+
+    __aicore__ inline void Process() {
+        if (coreId >= totalCoreNum) return;
+        ZeroAccumulator();
+        // 全部核清零后才能开始原子累加
+        SyncAll();
+
+        // 上三角块按行优先编号，Core c 处理第 c, c + usedCoreNum, ... 块
+        uint32_t blockNum = (n + block - 1) / block;
+        uint32_t t = 0;
+        for (uint32_t ib = 0; ib < blockNum; ++ib) {
+            for (uint32_t jb = ib; jb < blockNum; ++jb, ++t) {
+                if (t % totalCoreNum == coreId) {
+                    ProcessTile(ib, jb);
+                }
+            }
+        }
+
+        if constexpr (!IsSameType<T, float>::value) {
+            // 全部核累加完成后，各核把自己那一段 float 结果转成 half
+            SyncAll();
+            CastOut();
+        }
+    }
+
+private:
+    // 各核清零累加区中连续的一段 (按元素平分 n * m)
+    __aicore__ inline void ZeroAccumulator() {
+        LocalTensor<float> zero = accIBuf.Get<float>();
+        uint32_t piece = block * kChunk;
+        Duplicate(zero, 0.0f, piece);
+        event_t eventVMte3 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::V_MTE3));
+        SetFlag<HardEvent::V_MTE3>(eventVMte3);
+        WaitFlag<HardEvent::V_MTE3>(eventVMte3);
+
+        uint64_t begin, end;
+        CoreRange(begin, end);
+        for (uint64_t off = begin; off < end; off += piece) {
+            uint32_t len = (end - off < piece) ? static_cast<uint32_t>(end - off) : piece;
+            DataCopyExtParams copyParams{1, static_cast<uint32_t>(len * sizeof(float)), 0, 0, 0};
+            DataCopyPad(accGm[off], zero, copyParams);
+        }
+        // 之后的 Duplicate 会改写 accI
+        event_t eventMte3V = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE3_V));
+        SetFlag<HardEvent::MTE3_V>(eventMte3V);
+        WaitFlag<HardEvent::MTE3_V>(eventMte3V);
+    }
+
+    // FP16: 把本核那一段 float 累加结果转成 half 写入 grad_x
+    __aicore__ inline void CastOut() {
+        // 两个累加器此时已空闲: accI 放 float 段，accJ 放转换后的 half 段
+        LocalTensor<float> accF = accIBuf.Get<float>();
+        LocalTensor<T> outT = accJBuf.Get<T>();
+        uint32_t piece = block * kChunk;
+        uint64_t begin, end;
+        CoreRange(begin, end);
+        for (uint64_t off = begin; off < end; off += piece) {
+            uint32_t len = (end - off < piece) ? static_cast<uint32_t>(end - off) : piece;
+            DataCopyExtParams inParams{1, static_cast<uint32_t>(len * sizeof(float)), 0, 0, 0};
+            DataCopyPad(accF, accGm[off], inParams, DataCopyPadExtParams<float>{false, 0, 0, 0.0f});
+            event_t eventMte2V = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE2_V));
+            SetFlag<HardEvent::MTE2_V>(eventMte2V);
+            WaitFlag<HardEvent::MTE2_V>(eventMte2V);
+            Cast(outT, accF, RoundMode::CAST_ROUND, len);
+            event_t eventVMte3 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::V_MTE3));
+            SetFlag<HardEvent::V_MTE3>(eventVMte3);
+            WaitFlag<HardEvent::V_MTE3>(eventVMte3);
+            DataCopyExtParams outParams{1, static_cast<uint32_t>(len * sizeof(T)), 0, 0, 0};
+            DataCopyPad(gradXGm[off], outT, outParams);
+            // 下一段搬入会覆盖 accF / outT
+            event_t eventMte3Mte2 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE3_MTE2));
+            SetFlag<HardEvent::MTE3_MTE2>(eventMte3Mte2);
+            WaitFlag<HardEvent::MTE3_MTE2>(eventMte3Mte2);
+        }
+    }
+
+    __aicore__ inline void CoreRange(uint64_t& begin, uint64_t& end) {
+        uint64_t total = (uint64_t)n * m;
+        // 每核的段长取 16 的倍数，使各段起点对 float / half 都 32B 对齐
+        uint64_t perCore = ((total + totalCoreNum - 1) / totalCoreNum + 15) / 16 * 16;
+        begin = (uint64_t)coreId * perCore;
+        end = (begin + perCore < total) ? (begin + perCore) : total;
+        if (begin > end) {
+            begin = end;
+        }
+    }
+
+    __aicore__ inline void ProcessTile(uint32_t ib, uint32_t jb) {
+        uint32_t i0 = ib * block;
+        uint32_t iCount = (n - i0 < block) ? (n - i0) : block;
+        uint32_t j0 = jb * block;
+        uint32_t jCount = (n - j0 < block) ? (n - j0) : block;
+        LoadCoefficients(i0, iCount, j0, jCount);
+        LocalTensor<float> distTile = distTileBuf.Get<float>();
+        LocalTensor<float> coefTile = coefTileBuf.Get<float>();
+        LocalTensor<float> accI = accIBuf.Get<float>();
+        LocalTensor<float> accJ = accJBuf.Get<float>();
+
+        for (uint32_t c = 0; c < chunkNum; ++c) {
+            uint32_t k0 = c * kChunk;
+            uint32_t kLen = (m - k0 < kChunk) ? (m - k0) : kChunk;
+            uint32_t kLenAligned = (kLen * sizeof(T) + 31) / 32 * 32 / sizeof(T);
+
+            LocalTensor<T> iRaw = inQueueI.template AllocTensor<T>();
+            CopyRowsPad<T>(iRaw, xGm, (uint64_t)i0 * m + k0, iCount, kLen, m, kChunk);
+            inQueueI.EnQue(iRaw);
+            LocalTensor<T> jRaw = inQueueJ.template AllocTensor<T>();
+            CopyRowsPad<T>(jRaw, xGm, (uint64_t)j0 * m + k0, jCount, kLen, m, kChunk);
+            inQueueJ.EnQue(jRaw);
+            iRaw = inQueueI.template DeQue<T>();
+            jRaw = inQueueJ.template DeQue<T>();
+            LocalTensor<float> iF = BlockAsFloat(iRaw, castBufI, iCount);
+            LocalTensor<float> jF = BlockAsFloat(jRaw, castBufJ, jCount);
+
+            Duplicate(accI, 0.0f, iCount * kChunk);
+            Duplicate(accJ, 0.0f, jCount * kChunk);
+            for (uint32_t r = 0; r < iCount; ++r) {
+                uint32_t i = i0 + r;
+                uint32_t jStart = (j0 > i + 1) ? j0 : (i + 1);
+                for (uint32_t j = jStart; j < j0 + jCount; ++j) {
+                    uint32_t e = r * block + (j - jStart);
+                    float dij = distTile.GetValue(e);
+                    // d = 0 (两行相同) 时梯度取 0
+                    if (dij == 0.0f) {
+                        continue;
+                    }
+                    float cij = coefTile.GetValue(e);
+                    LocalTensor<float> xi = iF[r * kChunk];
+                    LocalTensor<float> xj = jF[(j - j0) * kChunk];
+                    LocalTensor<float> w = PairDirection(xi, xj, dij, kLenAligned);
+                    LocalTensor<float> accRowI = accI[r * kChunk];
+                    LocalTensor<float> accRowJ = accJ[(j - j0) * kChunk];
+                    Axpy(accRowI, w, cij, kLenAligned);
+                    Axpy(accRowJ, w, -cij, kLenAligned);
+                }
+            }
+            inQueueI.FreeTensor(iRaw);
+            inQueueJ.FreeTensor(jRaw);
+
+            FlushAccumulator(accI, i0, iCount, k0, kLen);
+            FlushAccumulator(accJ, j0, jCount, k0, kLen);
+        }
+    }
+
+    // 块内每行 i 的有效 pair 为 j in [max(j0, i + 1), j0 + jCount)，在压缩数组中连续，整段搬入到该行行首
+    // 搬入后按 p 算出系数 c * grad_y，供内层按 Scalar 读取
+    __aicore__ inline void LoadCoefficients(uint32_t i0, uint32_t iCount, uint32_t j0, uint32_t jCount) {
+        LocalTensor<float> gradTile = gradTileBuf.Get<float>();
+        LocalTensor<float> distTile = distTileBuf.Get<float>();
+        LocalTensor<float> coefTile = coefTileBuf.Get<float>();
+        LocalTensor<T> gradRaw, distRaw;
+        if constexpr (IsSameType<T, float>::value) {
+            gradRaw = gradTile;
+            distRaw = distTile;
+        } else {
+            gradRaw = gradRawBuf.Get<T>();
+            distRaw = distRawBuf.Get<T>();
+        }
+        for (uint32_t r = 0; r < iCount; ++r) {
+            uint32_t i = i0 + r;
+            uint32_t jStart = (j0 > i + 1) ? j0 : (i + 1);
+            if (jStart >= j0 + jCount) {
+                continue;
+            }
+            uint64_t idx = (uint64_t)(2 * n - 1 - i) * i / 2 + (jStart - i - 1);
+            DataCopyExtParams copyParams{1, static_cast<uint32_t>((j0 + jCount - jStart) * sizeof(T)), 0, 0, 0};
+            DataCopyPad(gradRaw[r * block], gradYGm[idx], copyParams, DataCopyPadExtParams<T>{false, 0, 0, 0});
+            DataCopyPad(distRaw[r * block], yGm[idx], copyParams, DataCopyPadExtParams<T>{false, 0, 0, 0});
+        }
+        event_t eventMte2V = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE2_V));
+        SetFlag<HardEvent::MTE2_V>(eventMte2V);
+        WaitFlag<HardEvent::MTE2_V>(eventMte2V);
+
+        uint32_t count = block * block;
+        if constexpr (!IsSameType<T, float>::value) {
+            Cast(gradTile, gradRaw, RoundMode::CAST_NONE, count);
+            Cast(distTile, distRaw, RoundMode::CAST_NONE, count);
+        }
+        if (pClass == PDIST_P_TWO) {
+            // g / d
+            Maxs(coefTile, distTile, PDIST_GRAD_TINY, count);
+            Div(coefTile, gradTile, coefTile, count);
+        } else if (pClass == PDIST_P_GENERIC) {
+            // g * d^(1 - p)
+            Maxs(coefTile, distTile, PDIST_GRAD_TINY, count);
+            Ln(coefTile, coefTile, count);
+            Muls(coefTile, coefTile, 1.0f - p, count);
+            Exp(coefTile, coefTile, count);
+            Mul(coefTile, gradTile, coefTile, count);
+        } else {
+            Muls(coefTile, gradTile, 1.0f, count);
+        }
+        event_t eventVS = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::V_S));
+        SetFlag<HardEvent::V_S>(eventVS);
+        WaitFlag<HardEvent::V_S>(eventVS);
+    }
+
+    // w_ij (见类注释)，写在 diffBuf 中；补零的尾部 diff = 0，w 也为 0
+    __aicore__ inline LocalTensor<float> PairDirection(LocalTensor<float>& xi, LocalTensor<float>& xj, float dij,
+                                                       uint32_t len) {
+        LocalTensor<float> diff = diffBuf.Get<float>();
+        LocalTensor<float> absDiff = absBuf.Get<float>();
+        LocalTensor<float> tmp = tmpBuf.Get<float>();
+        Sub(diff, xi, xj, len);
+        if (pClass == PDIST_P_TWO) {
+            return diff;
+        }
+        Abs(absDiff, diff, len);
+        if (pClass == PDIST_P_GENERIC) {
+            // diff * |diff|^(p - 2) = diff * Exp((p - 2) * Ln(|diff| + eps))
+            Adds(absDiff, absDiff, 1e-20f, len);
+            Ln(absDiff, absDiff, len);
+            Muls(absDiff, absDiff, p - 2.0f, len);
+            Exp(absDiff, absDiff, len);
+            Mul(diff, diff, absDiff, len);
+            return diff;
+        }
+        // sign(diff) = diff / max(|diff|, tiny)
+        Maxs(tmp, absDiff, PDIST_GRAD_TINY, len);
+        Div(diff, diff, tmp, len);
+        if (pClass == PDIST_P_INF) {
+            // 只有 |diff| 取到最大值 d 的维度有梯度 (并列时各自计入): clamp((|diff| - d) / (tol * d) + 1, 0, 1)
+            Adds(absDiff, absDiff, -dij, len);
+            Muls(absDiff, absDiff, 1.0f / (infTol * dij), len);
+            Adds(absDiff, absDiff, 1.0f, len);
+            Maxs(absDiff, absDiff, 0.0f, len);
+            Mins(absDiff, absDiff, 1.0f, len);
+            Mul(diff, diff, absDiff, len);
+        }
+        return diff;
+    }
+
+    // rows 行的 [k0, k0 + len) 段原子累加到 accGm
+    __aicore__ inline void FlushAccumulator(LocalTensor<float>& acc, uint32_t row0, uint32_t rows, uint32_t k0,
+                                            uint32_t len) {
+        event_t eventVMte3 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::V_MTE3));
+        SetFlag<HardEvent::V_MTE3>(eventVMte3);
+        WaitFlag<HardEvent::V_MTE3>(eventVMte3);
+        uint32_t lenBytes = len * sizeof(float);
+        uint32_t alignedBytes = (lenBytes + 31) / 32 * 32;
+        DataCopyExtParams copyParams{static_cast<uint16_t>(rows), lenBytes,
+                                     static_cast<uint32_t>((kChunk * sizeof(float) - alignedBytes) / 32),
+                                     static_cast<uint32_t>((m - len) * sizeof(float)), 0};
+        SetAtomicAdd<float>();
+        DataCopyPad(accGm[(uint64_t)row0 * m + k0], acc, copyParams);
+        SetAtomicNone();
+        // 下一段的 Duplicate 会改写累加器
+        event_t eventMte3V = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE3_V));
+        SetFlag<HardEvent::MTE3_V>(eventMte3V);
+        WaitFlag<HardEvent::MTE3_V>(eventMte3V);
+    }
+
+    // 块内 rows 行整体转成 float (FP32 直接返回原 tensor)
+    __aicore__ inline LocalTensor<float> BlockAsFloat(LocalTensor<T>& raw, TBuf<TPosition::VECCALC>& castBuf,
+                                                      uint32_t rows) {
+        if constexpr (IsSameType<T, float>::value) {
+            return raw;
+        } else {
+            LocalTensor<float> rowsF = castBuf.Get<float>();
+            Cast(rowsF, raw, RoundMode::CAST_NONE, rows * kChunk);
+            return rowsF;
+        }
+    }
+
+    TPipe pipe;
+    TQue<QuePosition::VECIN, 1> inQueueI;
+    TQue<QuePosition::VECIN, 1> inQueueJ;
+    TBuf<TPosition::VECCALC> accIBuf, accJBuf, castBufI, castBufJ;
+    TBuf<TPosition::VECCALC> diffBuf, absBuf, tmpBuf;
+    TBuf<TPosition::VECCALC> gradTileBuf, distTileBuf, coefTileBuf, gradRawBuf, distRawBuf;
+
+    GlobalTensor<T> xGm;
+    GlobalTensor<T> yGm;
+    GlobalTensor<T> gradYGm;
+    GlobalTensor<T> gradXGm;
+    GlobalTensor<float> accGm;
+
+    uint32_t n, m;
+    float p;
+    float infTol;
+    uint32_t pClass;
+    uint32_t totalCoreNum;
+    uint32_t coreId;
+    uint32_t block;
+    uint32_t kChunk, chunkNum;
+};
+
+extern "C" __global__ __aicore__ void pdist_grad(GM_ADDR x, GM_ADDR y, GM_ADDR grad_y, GM_ADDR grad_x,
+                                                 GM_ADDR workspace, GM_ADDR tiling) {
+    KERNEL_TASK_TYPE_DEFAULT(KERNEL_TYPE_AIV_ONLY);
+    const __gm__ KernelGradTilingData* tDataGM = (const __gm__ KernelGradTilingData*)tiling;
+    KernelGradTilingData tDataLocal;
+    tDataLocal.n = tDataGM->n;
+    tDataLocal.m = tDataGM->m;
+    tDataLocal.p = tDataGM->p;
+    tDataLocal.usedCoreNum = tDataGM->usedCoreNum;
+    tDataLocal.tilingKey = tDataGM->tilingKey;
+    tDataLocal.pClass = tDataGM->pClass;
+    tDataLocal.blockRows = tDataGM->blockRows;
+    tDataLocal.kChunk = tDataGM->kChunk;
+    tDataLocal.chunkNum = tDataGM->chunkNum;
+    tDataLocal.tileNum = tDataGM->tileNum;
+
+    // DTYPE_X 由算子编译流程按输入 x 的数据类型定义 (float / half)
+    KernelPdistGrad<DTYPE_X> op;
+    op.Init(x, y, grad_y, grad_x, GetUserWorkspace(workspace), &tDataLocal);
+    op.Process();
+}
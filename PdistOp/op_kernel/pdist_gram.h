@@ -0,0 +1,483 @@
+/**
+ * @file pdist_gram.h
+ * @brief Mixed Cube/Vector Pdist kernel for p = 2 (tilingKey PDIST_TILING_KEY_GRAM)
+ *
+ * ||xi - xj||^2 = ||xi||^2 + ||xj||^2 - 2 <xi, xj>. Each AIC computes T x T Gram tiles with the
+ * Matmul API into a per-AIV GM ring; the paired AIV adds the norms, clamps, takes the square root
+ * and packs the upper triangle into the condensed output while the AIC works on its next tile.
+ *
+ * For int8 input (PdistQuant, x = s * (q - zp) per row) the Gram tile is an exact int32 product of
+ * the raw codes; the epilogue folds in per-row scale / zero-point terms precomputed by the AIVs.
+ */
+
+#ifndef PDIST_GRAM_H
+#define PDIST_GRAM_H
+
+#include "kernel_operator.h"
+#include "lib/matmul_intf.h"
+#include "pdist_common.h"
+#include "pdist_profile.h"
+
+// 需与 op_host/pdist_tiling_plan.h 一致
+constexpr uint32_t PDIST_GRAM_TILE = 128;
+constexpr uint32_t PDIST_GRAM_RING_DEPTH = 2;
+constexpr uint32_t PDIST_MIX_AIV_PER_BLOCK = 2;
+// 后处理每次搬入的 Gram 块行数，以及范数预计算每次写回的行数
+constexpr uint32_t PDIST_GRAM_EPI_ROWS = 16;
+constexpr uint32_t PDIST_GRAM_NORM_ROWS = 64;
+
+// int8 输入每行预计算的系数在 workspace 中的段号 (段数需与 op_host/pdist_tiling_plan.h 的
+// PDIST_GRAM_QUANT_AUX_NUM 一致)。j 侧用前 4 段，i 侧用 NORM / SCALE / CENTER / ZP
+// d^2 = N_i + N_j - 2 s_i (s_j G - s_j zp_j (Sum(q_i) - m zp_i) - zp_i s_j Sum(q_j))，G = q_i . q_j
+constexpr uint32_t PDIST_QAUX_NORM = 0;      // s^2 * Sum((q - zp)^2)
+constexpr uint32_t PDIST_QAUX_SCALE = 1;     // s
+constexpr uint32_t PDIST_QAUX_SCALE_ZP = 2;  // s * zp
+constexpr uint32_t PDIST_QAUX_SCALE_SUM = 3; // s * Sum(q)
+constexpr uint32_t PDIST_QAUX_CENTER = 4;    // Sum(q) - m * zp
+constexpr uint32_t PDIST_QAUX_ZP = 5;        // zp
+constexpr uint32_t PDIST_GRAM_QUANT_AUX_NUM = 6;
+constexpr uint32_t PDIST_GRAM_QUANT_J_AUX_NUM = 4;
+
+// Gram 块的累加类型: 浮点输入为 float，int8 输入在 Cube 上按 int32 精确累加
+template <typename T>
+struct PdistGramAcc {
+    using Type = float;
+};
+
+template <>
+struct PdistGramAcc<int8_t> {
+    using Type = int32_t;
+};
+
+// T 为输入元素类型 (float / half / int8_t)，TOut 为输出元素类型 (int8 输入时为 float)
+template <typename T, typename TOut = T>
+class KernelPdistGram {
+public:
+    using AccT = typename PdistGramAcc<T>::Type;
+    using AType = matmul::MatmulType<AscendC::TPosition::GM, CubeFormat::ND, T>;
+    using BType = matmul::MatmulType<AscendC::TPosition::GM, CubeFormat::ND, T, true>;
+    using CType = matmul::MatmulType<AscendC::TPosition::GM, CubeFormat::ND, AccT>;
+    using BiasType = matmul::MatmulType<AscendC::TPosition::GM, CubeFormat::ND, AccT>;
+    matmul::Matmul<AType, BType, CType, BiasType> mm;
+
+    __aicore__ inline KernelPdistGram() {}
+
+    // 只比较 x 中 indices 指定的行 (Pdist 的可选输入)，须在 Init 之前调用
+    // 有 indices 时范数预计算顺带把选中的行按 indices 顺序写入 workspace，Matmul 从这份连续副本读取
+    __aicore__ inline void SetRowIndices(GM_ADDR indices, uint32_t indexSize) {
+        rowMap.Init(indices, indexSize);
+    }
+
+    // 只在 AIV 上调用: pipe 须与 REGIST_MATMUL_OBJ 使用同一个 (AIC 侧在该宏内进入 Matmul 服务循环后返回)
+    // scale / zeroPoint 只用于 int8 输入 (每行一个 float / int32)，zeroPoint 为空表示对称量化
+    // rowStride 为 x 的行跨度 (元素，>= m)，Matmul 的 Ka / Kb 与范数预计算都按它寻址
+    __aicore__ inline void Init(GM_ADDR x, GM_ADDR y, GM_ADDR usrWorkspace, uint32_t n, uint32_t m,
+                                uint32_t rowStride, uint32_t kChunk, uint32_t chunkNum, uint32_t usedCoreNum, AscendC::TPipe* pipe,
+                                GM_ADDR scale = nullptr, GM_ADDR zeroPoint = nullptr) {
+        using namespace AscendC;
+        this->n = n;
+        this->m = m;
+        this->rowStride = rowStride;
+        this->kChunk = kChunk;
+        this->chunkNum = chunkNum;
+        aivNum = usedCoreNum * PDIST_MIX_AIV_PER_BLOCK;
+        aivId = GetBlockIdx();
+        tileNum = (n + PDIST_GRAM_TILE - 1) / PDIST_GRAM_TILE;
+        hasZeroPoint = (zeroPoint != nullptr);
+        auxNum = IsSameType<T, int8_t>::value ? PDIST_GRAM_QUANT_AUX_NUM : 1;
+        jAuxNum = IsSameType<T, int8_t>::value ? PDIST_GRAM_QUANT_J_AUX_NUM : 1;
+
+        xGm.SetGlobalBuffer((__gm__ T*)x);
+        yGm.SetGlobalBuffer((__gm__ TOut*)y);
+        if constexpr (IsSameType<T, int8_t>::value) {
+            scaleGm.SetGlobalBuffer((__gm__ float*)scale);
+            zeroPointGm.SetGlobalBuffer((__gm__ int32_t*)zeroPoint);
+        }
+
+        // user workspace: [每行系数 (auxNum 段，浮点输入只有平方范数) | 每个 AIV 的 Gram 环形缓冲 |
+        //                  (有 indices 时) 选中行的连续副本 | Profiling 记录区]
+        uint64_t normBytes = ((uint64_t)n * sizeof(float) + 511) / 512 * 512;
+        normStride = normBytes / sizeof(float);
+        uint64_t ringElems = (uint64_t)PDIST_GRAM_RING_DEPTH * PDIST_GRAM_TILE * PDIST_GRAM_TILE;
+        normGm.SetGlobalBuffer((__gm__ float*)usrWorkspace);
+        ringGm.SetGlobalBuffer((__gm__ AccT*)(usrWorkspace + auxNum * normBytes) + aivId * ringElems);
+        GM_ADDR gatherRegion = usrWorkspace + auxNum * normBytes + aivNum * ringElems * sizeof(AccT);
+        profRegion = gatherRegion;
+        mmSrcGm = xGm;
+        mmRowStride = rowStride;
+        if (rowMap.Gathered()) {
+            gatherGm.SetGlobalBuffer((__gm__ T*)gatherRegion);
+            profRegion = gatherRegion + ((uint64_t)n * m * sizeof(T) + 511) / 512 * 512;
+            mmSrcGm = gatherGm;
+            mmRowStride = m;
+        }
+
+        // 范数预计算 (int8: 两级 Cast 到 float，同时求 Sum(q) 与 Sum((q - zp)^2))
+        pipe->InitBuffer(rowQueue, 1, kChunk * sizeof(T));
+        if constexpr (!IsSameType<T, float>::value) {
+            pipe->InitBuffer(castBuf, kChunk * sizeof(float));
+        }
+        if constexpr (IsSameType<T, int8_t>::value) {
+            pipe->InitBuffer(halfBuf, kChunk * sizeof(half));
+            pipe->InitBuffer(qParamBuf, 2 * PDIST_GRAM_NORM_ROWS * sizeof(float));
+            pipe->InitBuffer(gramFBuf, PDIST_GRAM_EPI_ROWS * PDIST_GRAM_TILE * sizeof(float));
+        }
+        pipe->InitBuffer(workBuf, kChunk * sizeof(float));
+        pipe->InitBuffer(reduceBuf, 64);
+        pipe->InitBuffer(normOutBuf, auxNum * PDIST_GRAM_NORM_ROWS * sizeof(float));
+        // 后处理: 前 EPI_ROWS 行为 Gram 行，其后为对角块逐行错位的 j 侧系数 (每段 EPI_ROWS 行)
+        pipe->InitBuffer(gramQueue, BUFFER_NUM,
+                         (1 + jAuxNum) * PDIST_GRAM_EPI_ROWS * PDIST_GRAM_TILE * sizeof(float));
+        pipe->InitBuffer(outQueue, BUFFER_NUM, PDIST_GRAM_EPI_ROWS * PDIST_GRAM_TILE * sizeof(TOut));
+        pipe->InitBuffer(normIBuf, auxNum * PDIST_GRAM_TILE * sizeof(float));
+        pipe->InitBuffer(normJBuf, jAuxNum * PDIST_GRAM_TILE * sizeof(float));
+    }
+
+    __aicore__ inline void Process() {
+        PDIST_PROF(prof.Begin());
+        ComputeNorms();
+        // 所有 AIV 的范数写完后才能开始后处理 (AIC 在服务循环中，不参与同步)
+        AscendC::SyncAll();
+        PDIST_PROF(prof.Lap(prof.copyInCycles));
+
+        // 上三角 Gram 块按行优先编号，AIV a 处理第 a, a + aivNum, ... 块
+        uint32_t ib = 0;
+        uint32_t jb = 0;
+        if (AdvanceTile(ib, jb, aivId)) {
+            uint32_t slot = 0;
+            IssueGram(ib, jb, slot);
+            while (true) {
+                mm.WaitIterateAll();
+                PDIST_PROF(prof.Lap(prof.computeCycles));
+                uint32_t nextIb = ib;
+                uint32_t nextJb = jb;
+                bool hasNext = AdvanceTile(nextIb, nextJb, aivNum);
+                // AIC 计算下一块写入另一个槽，同时 AIV 处理当前槽
+                if (hasNext) {
+                    IssueGram(nextIb, nextJb, slot ^ 1);
+                }
+                Epilogue(ib, jb, slot);
+                PDIST_PROF(prof.Lap(prof.copyOutCycles));
+                if (!hasNext) {
+                    break;
+                }
+                ib = nextIb;
+                jb = nextJb;
+                slot ^= 1;
+            }
+        }
+        mm.End();
+
+        PDIST_PROF(prof.Flush(profRegion, aivId));
+    }
+
+private:
+    // 在上三角块序列中前进 steps 块，越过末尾返回 false
+    __aicore__ inline bool AdvanceTile(uint32_t& ib, uint32_t& jb, uint32_t steps) {
+        for (uint32_t s = 0; s < steps; ++s) {
+            if (++jb == tileNum) {
+                if (++ib == tileNum) {
+                    return false;
+                }
+                jb = ib;
+            }
+        }
+        return ib < tileNum;
+    }
+
+    __aicore__ inline uint32_t TileCount(uint32_t b) {
+        uint32_t start = b * PDIST_GRAM_TILE;
+        return (n - start < PDIST_GRAM_TILE) ? (n - start) : PDIST_GRAM_TILE;
+    }
+
+    // 异步发起 G = x[i0 : i0 + iCount] * x[j0 : j0 + jCount]^T，结果写入环形缓冲第 slot 槽
+    __aicore__ inline void IssueGram(uint32_t ib, uint32_t jb, uint32_t slot) {
+        mm.SetTensorA(mmSrcGm[(uint64_t)ib * PDIST_GRAM_TILE * mmRowStride]);
+        mm.SetTensorB(mmSrcGm[(uint64_t)jb * PDIST_GRAM_TILE * mmRowStride], true);
+        mm.SetTail(TileCount(ib), TileCount(jb), m);
+        mm.template IterateAll<false>(ringGm[(uint64_t)slot * PDIST_GRAM_TILE * PDIST_GRAM_TILE], 0, false, true);
+    }
+
+    // 每个 AIV 负责连续的一段行，按 kChunk 分段求 Sum(x^2)；int8 另求 Sum(q) 并折算成每行系数
+    __aicore__ inline void ComputeNorms() {
+        using namespace AscendC;
+        uint32_t rowsPerCore = (n + aivNum - 1) / aivNum;
+        uint32_t rowStart = aivId * rowsPerCore;
+        uint32_t rowEnd = (rowStart + rowsPerCore < n) ? (rowStart + rowsPerCore) : n;
+        LocalTensor<float> work = workBuf.Get<float>();
+        LocalTensor<float> red = reduceBuf.Get<float>();
+        LocalTensor<float> normOut = normOutBuf.Get<float>();
+
+        for (uint32_t g0 = rowStart; g0 < rowEnd; g0 += PDIST_GRAM_NORM_ROWS) {
+            uint32_t cnt = (rowEnd - g0 < PDIST_GRAM_NORM_ROWS) ? (rowEnd - g0) : PDIST_GRAM_NORM_ROWS;
+            if constexpr (IsSameType<T, int8_t>::value) {
+                LoadQuantParams(g0, cnt);
+            }
+            for (uint32_t r = 0; r < cnt; ++r) {
+                float zp = 0.0f;
+                if constexpr (IsSameType<T, int8_t>::value) {
+                    zp = hasZeroPoint ? static_cast<float>(qParamBuf.Get<int32_t>().GetValue(PDIST_GRAM_NORM_ROWS + r))
+                                      : 0.0f;
+                }
+                // 跨段补偿求和，m 很大时范数误差不随段数累积
+                float acc = 0.0f;
+                float accComp = 0.0f;
+                float sum = 0.0f;
+                float sumComp = 0.0f;
+                for (uint32_t c = 0; c < chunkNum; ++c) {
+                    uint32_t k0 = c * kChunk;
+                    uint32_t kLen = (m - k0 < kChunk) ? (m - k0) : kChunk;
+                    uint32_t kLenAligned = (kLen * sizeof(T) + 31) / 32 * 32 / sizeof(T);
+                    LocalTensor<T> raw = rowQueue.template AllocTensor<T>();
+                    CopyRowsMapped<T>(raw, xGm, rowMap, g0 + r, 1, k0, kLen, rowStride, kChunk);
+                    rowQueue.EnQue(raw);
+                    raw = rowQueue.template DeQue<T>();
+                    if (rowMap.Gathered()) {
+                        // 选中行写入连续副本；fp16 / int8 的 Vector 计算只读 raw，与写出并行
+                        event_t eventMte2Mte3 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE2_MTE3));
+                        SetFlag<HardEvent::MTE2_MTE3>(eventMte2Mte3);
+                        WaitFlag<HardEvent::MTE2_MTE3>(eventMte2Mte3);
+                        DataCopyExtParams gatherParams{1, static_cast<uint32_t>(kLen * sizeof(T)), 0, 0, 0};
+                        DataCopyPad(gatherGm[(uint64_t)(g0 + r) * m + k0], raw, gatherParams);
+                    }
+                    if constexpr (IsSameType<T, int8_t>::value) {
+                        LocalTensor<half> rowH = halfBuf.Get<half>();
+                        LocalTensor<float> rowF = castBuf.Get<float>();
+                        Cast(rowH, raw, RoundMode::CAST_NONE, kLenAligned);
+                        Cast(rowF, rowH, RoundMode::CAST_NONE, kLenAligned);
+                        ReduceSum(red, rowF, work, kLen);
+                        if (hasZeroPoint) {
+                            Adds(rowF, rowF, -zp, kLen);
+                        }
+                        Mul(rowF, rowF, rowF, kLen);
+                        ReduceSum(red[8], rowF, work, kLen);
+                    } else {
+                        LocalTensor<float> rowF = RowAsFloat<T>(raw, castBuf, kLenAligned);
+                        if constexpr (IsSameType<T, float>::value) {
+                            // float 行直接在 raw 上原地平方，需等写出副本读完 raw
+                            if (rowMap.Gathered()) {
+                                event_t eventMte3V = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE3_V));
+                                SetFlag<HardEvent::MTE3_V>(eventMte3V);
+                                WaitFlag<HardEvent::MTE3_V>(eventMte3V);
+                            }
+                        }
+                        Mul(rowF, rowF, rowF, kLenAligned);
+                        ReduceSum(red[8], rowF, work, kLenAligned);
+                    }
+                    rowQueue.FreeTensor(raw);
+                    if (rowMap.Gathered()) {
+                        // 下一段搬入会覆盖 raw，需等写出完成
+                        event_t eventMte3Mte2 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE3_MTE2));
+                        SetFlag<HardEvent::MTE3_MTE2>(eventMte3Mte2);
+                        WaitFlag<HardEvent::MTE3_MTE2>(eventMte3Mte2);
+                    }
+
+                    event_t eventVS = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::V_S));
+                    SetFlag<HardEvent::V_S>(eventVS);
+                    WaitFlag<HardEvent::V_S>(eventVS);
+                    KahanAdd(acc, accComp, red.GetValue(8));
+                    if constexpr (IsSameType<T, int8_t>::value) {
+                        KahanAdd(sum, sumComp, red.GetValue(0));
+                    }
+                }
+                acc += accComp;
+                sum += sumComp;
+                if constexpr (IsSameType<T, int8_t>::value) {
+                    float s = qParamBuf.Get<float>().GetValue(r);
+                    normOut.SetValue(PDIST_QAUX_NORM * PDIST_GRAM_NORM_ROWS + r, s * s * acc);
+                    normOut.SetValue(PDIST_QAUX_SCALE * PDIST_GRAM_NORM_ROWS + r, s);
+                    normOut.SetValue(PDIST_QAUX_SCALE_ZP * PDIST_GRAM_NORM_ROWS + r, s * zp);
+                    normOut.SetValue(PDIST_QAUX_SCALE_SUM * PDIST_GRAM_NORM_ROWS + r, s * sum);
+                    normOut.SetValue(PDIST_QAUX_CENTER * PDIST_GRAM_NORM_ROWS + r, sum - static_cast<float>(m) * zp);
+                    normOut.SetValue(PDIST_QAUX_ZP * PDIST_GRAM_NORM_ROWS + r, zp);
+                } else {
+                    normOut.SetValue(r, acc);
+                }
+            }
+
+            event_t eventSMte3 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::S_MTE3));
+            SetFlag<HardEvent::S_MTE3>(eventSMte3);
+            WaitFlag<HardEvent::S_MTE3>(eventSMte3);
+            DataCopyExtParams copyParams{1, static_cast<uint32_t>(cnt * sizeof(float)), 0, 0, 0};
+            for (uint32_t a = 0; a < auxNum; ++a) {
+                DataCopyPad(normGm[a * normStride + g0], normOut[a * PDIST_GRAM_NORM_ROWS], copyParams);
+            }
+            // 下一组的 SetValue 要等本组写回完成
+            event_t eventMte3S = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE3_S));
+            SetFlag<HardEvent::MTE3_S>(eventMte3S);
+            WaitFlag<HardEvent::MTE3_S>(eventMte3S);
+        }
+    }
+
+    // int8: 搬入 [g0, g0 + cnt) 行的 scale (前半) 与 zero point (后半)，供 Scalar 读取
+    __aicore__ inline void LoadQuantParams(uint32_t g0, uint32_t cnt) {
+        using namespace AscendC;
+        DataCopyExtParams paramParams{1, static_cast<uint32_t>(cnt * sizeof(float)), 0, 0, 0};
+        DataCopyPad(qParamBuf.Get<float>(), scaleGm[g0], paramParams, DataCopyPadExtParams<float>{false, 0, 0, 0.0f});
+        if (hasZeroPoint) {
+            DataCopyPad(qParamBuf.Get<int32_t>()[PDIST_GRAM_NORM_ROWS], zeroPointGm[g0], paramParams,
+                        DataCopyPadExtParams<int32_t>{false, 0, 0, 0});
+        }
+        event_t eventMte2S = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE2_S));
+        SetFlag<HardEvent::MTE2_S>(eventMte2S);
+        WaitFlag<HardEvent::MTE2_S>(eventMte2S);
+    }
+
+    // d^2 = ||xi||^2 + ||xj||^2 - 2 G，截断到 0 后开方；只写 j > i 的部分 (int8 按行系数反量化，见 PDIST_QAUX_*)
+    __aicore__ inline void Epilogue(uint32_t ib, uint32_t jb, uint32_t slot) {
+        using namespace AscendC;
+        uint32_t i0 = ib * PDIST_GRAM_TILE;
+        uint32_t j0 = jb * PDIST_GRAM_TILE;
+        uint32_t iCount = TileCount(ib);
+        uint32_t jCount = TileCount(jb);
+        bool diagonal = (ib == jb);
+        uint64_t slotOffset = (uint64_t)slot * PDIST_GRAM_TILE * PDIST_GRAM_TILE;
+        DataCopyPadExtParams<float> noPad{false, 0, 0, 0.0f};
+        DataCopyPadExtParams<AccT> noPadAcc{false, 0, 0, 0};
+
+        // 每段 PDIST_GRAM_TILE 个: i 侧 auxNum 段，j 侧 jAuxNum 段 (浮点输入各只有平方范数一段)
+        LocalTensor<float> normI = normIBuf.Get<float>();
+        LocalTensor<float> normJ = normJBuf.Get<float>();
+        // 上一块的 Vector 计算仍可能在读 normJ
+        event_t eventVMte2 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::V_MTE2));
+        SetFlag<HardEvent::V_MTE2>(eventVMte2);
+        WaitFlag<HardEvent::V_MTE2>(eventVMte2);
+        DataCopyExtParams normIParams{1, static_cast<uint32_t>(iCount * sizeof(float)), 0, 0, 0};
+        for (uint32_t a = 0; a < auxNum; ++a) {
+            DataCopyPad(normI[a * PDIST_GRAM_TILE], normGm[a * normStride + i0], normIParams, noPad);
+        }
+        DataCopyExtParams normJParams{1, static_cast<uint32_t>(jCount * sizeof(float)), 0, 0, 0};
+        for (uint32_t a = 0; a < jAuxNum; ++a) {
+            DataCopyPad(normJ[a * PDIST_GRAM_TILE], normGm[a * normStride + j0], normJParams, noPad);
+        }
+        event_t eventMte2S = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE2_S));
+        SetFlag<HardEvent::MTE2_S>(eventMte2S);
+        WaitFlag<HardEvent::MTE2_S>(eventMte2S);
+        event_t eventMte2V = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE2_V));
+        SetFlag<HardEvent::MTE2_V>(eventMte2V);
+        WaitFlag<HardEvent::MTE2_V>(eventMte2V);
+
+        for (uint32_t r0 = 0; r0 < iCount; r0 += PDIST_GRAM_EPI_ROWS) {
+            uint32_t rowCount = (iCount - r0 < PDIST_GRAM_EPI_ROWS) ? (iCount - r0) : PDIST_GRAM_EPI_ROWS;
+            // 对角块第 ii 行只取 j > i 的部分，Gram 与 j 侧系数都按有效段起点搬入，保证 UB 行首 32B 对齐
+            LocalTensor<float> gram = gramQueue.template AllocTensor<float>();
+            LocalTensor<AccT> gramAcc = gram.template ReinterpretCast<AccT>();
+            LocalTensor<float> jAuxRows = gram[PDIST_GRAM_EPI_ROWS * PDIST_GRAM_TILE];
+            if (!diagonal) {
+                uint32_t rowBytes = jCount * sizeof(AccT);
+                DataCopyExtParams gramParams{static_cast<uint16_t>(rowCount), rowBytes,
+                                             static_cast<uint32_t>((PDIST_GRAM_TILE - jCount) * sizeof(AccT)),
+                                             static_cast<uint32_t>((PDIST_GRAM_TILE * sizeof(AccT) -
+                                                                    (rowBytes + 31) / 32 * 32) / 32),
+                                             0};
+                DataCopyPad(gramAcc, ringGm[slotOffset + (uint64_t)r0 * PDIST_GRAM_TILE], gramParams, noPadAcc);
+            } else {
+                for (uint32_t r = 0; r < rowCount; ++r) {
+                    uint32_t first = r0 + r + 1;
+                    if (first >= jCount) continue;
+                    DataCopyExtParams rowParams{1, static_cast<uint32_t>((jCount - first) * sizeof(float)), 0, 0, 0};
+                    DataCopyPad(gramAcc[r * PDIST_GRAM_TILE],
+                                ringGm[slotOffset + (uint64_t)(r0 + r) * PDIST_GRAM_TILE + first], rowParams,
+                                noPadAcc);
+                    for (uint32_t a = 0; a < jAuxNum; ++a) {
+                        DataCopyPad(jAuxRows[(a * PDIST_GRAM_EPI_ROWS + r) * PDIST_GRAM_TILE],
+                                    normGm[a * normStride + j0 + first], rowParams, noPad);
+                    }
+                }
+            }
+            gramQueue.EnQue(gram);
+            gram = gramQueue.template DeQue<float>();
+
+            uint32_t total = rowCount * PDIST_GRAM_TILE;
+            LocalTensor<float> dist = gram;
+            if constexpr (IsSameType<T, int8_t>::value) {
+                dist = gramFBuf.Get<float>();
+                Cast(dist, gram.template ReinterpretCast<int32_t>(), RoundMode::CAST_NONE, total);
+            }
+            for (uint32_t r = 0; r < rowCount; ++r) {
+                uint32_t first = diagonal ? (r0 + r + 1) : 0;
+                if (first >= jCount) continue;
+                uint32_t cnt = jCount - first;
+                uint32_t ii = r0 + r;
+                LocalTensor<float> distRow = dist[r * PDIST_GRAM_TILE];
+                // j 侧第 a 段系数: 对角块取逐行错位搬入的副本
+                uint32_t jStride = diagonal ? PDIST_GRAM_EPI_ROWS * PDIST_GRAM_TILE : PDIST_GRAM_TILE;
+                LocalTensor<float> jAux = diagonal ? jAuxRows[r * PDIST_GRAM_TILE] : normJ;
+                if constexpr (IsSameType<T, int8_t>::value) {
+                    LocalTensor<float> scaleJ = jAux[PDIST_QAUX_SCALE * jStride];
+                    Mul(distRow, distRow, scaleJ, cnt);
+                    if (hasZeroPoint) {
+                        LocalTensor<float> scaleZpJ = jAux[PDIST_QAUX_SCALE_ZP * jStride];
+                        LocalTensor<float> scaleSumJ = jAux[PDIST_QAUX_SCALE_SUM * jStride];
+                        Axpy(distRow, scaleZpJ, -normI.GetValue(PDIST_QAUX_CENTER * PDIST_GRAM_TILE + ii), cnt);
+                        Axpy(distRow, scaleSumJ, -normI.GetValue(PDIST_QAUX_ZP * PDIST_GRAM_TILE + ii), cnt);
+                    }
+                    Muls(distRow, distRow, -2.0f * normI.GetValue(PDIST_QAUX_SCALE * PDIST_GRAM_TILE + ii), cnt);
+                } else {
+                    Muls(distRow, distRow, -2.0f, cnt);
+                }
+                LocalTensor<float> normRow = jAux[PDIST_QAUX_NORM * jStride];
+                Add(distRow, distRow, normRow, cnt);
+                Adds(distRow, distRow, normI.GetValue(PDIST_QAUX_NORM * PDIST_GRAM_TILE + ii), cnt);
+                PDIST_PROF(prof.pairs += cnt);
+            }
+            // 浮点抵消可能产生微小负数
+            Maxs(dist, dist, 0.0f, total);
+            Sqrt(dist, dist, total);
+
+            LocalTensor<TOut> yLocal = outQueue.template AllocTensor<TOut>();
+            if constexpr (IsSameType<TOut, float>::value) {
+                Adds(yLocal, dist, 0.0f, total);
+            } else {
+                Cast(yLocal, dist, RoundMode::CAST_ROUND, total);
+            }
+            outQueue.EnQue(yLocal);
+            gramQueue.FreeTensor(gram);
+            yLocal = outQueue.template DeQue<TOut>();
+
+            for (uint32_t r = 0; r < rowCount; ++r) {
+                uint32_t i = i0 + r0 + r;
+                uint32_t first = diagonal ? (r0 + r + 1) : 0;
+                if (first >= jCount) continue;
+                uint64_t outIdx = (uint64_t)(2 * n - 1 - i) * i / 2 + (j0 + first - i - 1);
+                DataCopyExtParams copyParams{1, static_cast<uint32_t>((jCount - first) * sizeof(TOut)), 0, 0, 0};
+                DataCopyPad(yGm[outIdx], yLocal[r * PDIST_GRAM_TILE], copyParams);
+            }
+            outQueue.FreeTensor(yLocal);
+        }
+    }
+
+private:
+    static constexpr int32_t BUFFER_NUM = 2;
+
+    AscendC::TQue<AscendC::QuePosition::VECIN, 1> rowQueue;
+    AscendC::TQue<AscendC::QuePosition::VECIN, BUFFER_NUM> gramQueue;
+    AscendC::TQue<AscendC::QuePosition::VECOUT, BUFFER_NUM> outQueue;
+    AscendC::TBuf<AscendC::TPosition::VECCALC> castBuf, workBuf, reduceBuf, normOutBuf, normIBuf, normJBuf;
+    AscendC::TBuf<AscendC::TPosition::VECCALC> halfBuf, qParamBuf, gramFBuf;
+
+    AscendC::GlobalTensor<T> xGm;
+    AscendC::GlobalTensor<TOut> yGm;
+    AscendC::GlobalTensor<float> scaleGm;
+    AscendC::GlobalTensor<int32_t> zeroPointGm;
+    AscendC::GlobalTensor<float> normGm;
+    AscendC::GlobalTensor<AccT> ringGm;
+    AscendC::GlobalTensor<T> gatherGm;
+    AscendC::GlobalTensor<T> mmSrcGm; // Matmul 的 A / B 来源: x 本身，或有 indices 时的连续副本
+    PdistRowMap rowMap;
+    GM_ADDR profRegion;
+#ifdef PDIST_PROFILE
+    PdistProfiler prof;
+#endif
+
+    uint32_t n, m;
+    uint32_t rowStride, mmRowStride;
+    uint32_t kChunk, chunkNum;
+    uint32_t aivNum, aivId;
+    uint32_t tileNum;
+    uint32_t auxNum, jAuxNum;
+    uint64_t normStride;
+    bool hasZeroPoint;
+};
+
+#endif // PDIST_GRAM_H
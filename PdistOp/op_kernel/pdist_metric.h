@@ -0,0 +1,194 @@
+/**
+ * @file pdist_metric.h
+ * @brief Compile-time metric policies for the tiled vector Pdist kernel
+ *
+ * Each policy gives the element-wise transform of a row difference (Elementwise), whether elements
+ * and chunk partials combine by max (MAX_COMBINE) and the root applied to combined partials
+ * (Finalize). PdistMetricPartial reduces one pair; PdistMetricRows reduces many packed pairs with one
+ * segmented reduction when a row fits one vector repeat. KernelPdist is instantiated
+ * once per policy and the host picks the instantiation through the tilingKey, so the pair loop
+ * carries no p-class branches. The tilingKey of each policy must match PdistVectorTilingKey in
+ * op_host/pdist_tiling_plan.h.
+ */
+
+#ifndef PDIST_METRIC_H
+#define PDIST_METRIC_H
+
+#include "kernel_operator.h"
+
+// Elementwise 约定: 原地改写 diff 的前 len 个元素 (len 可以是多行打包后的总长)；workLocal 至少 len 个元素，可作暂存
+
+// p = 1: Sum |diff|
+struct PdistMetricL1 {
+    static constexpr bool MAX_COMBINE = false;
+
+    __aicore__ static inline void Elementwise(AscendC::LocalTensor<float>& diff,
+                                              AscendC::LocalTensor<float>& workLocal, uint32_t len, float p)
+    {
+        AscendC::Abs(diff, diff, len);
+    }
+
+    __aicore__ static inline void Finalize(AscendC::LocalTensor<float>& vals, uint32_t count, float p) {}
+};
+
+// p = 2: Sqrt(Sum diff^2)，平方不需要 Abs
+struct PdistMetricL2 {
+    static constexpr bool MAX_COMBINE = false;
+
+    __aicore__ static inline void Elementwise(AscendC::LocalTensor<float>& diff,
+                                              AscendC::LocalTensor<float>& workLocal, uint32_t len, float p)
+    {
+        AscendC::Mul(diff, diff, diff, len);
+    }
+
+    __aicore__ static inline void Finalize(AscendC::LocalTensor<float>& vals, uint32_t count, float p)
+    {
+        AscendC::Sqrt(vals, vals, count);
+    }
+};
+
+// p = inf: Max |diff|，各段取 Max
+struct PdistMetricLinf {
+    static constexpr bool MAX_COMBINE = true;
+
+    __aicore__ static inline void Elementwise(AscendC::LocalTensor<float>& diff,
+                                              AscendC::LocalTensor<float>& workLocal, uint32_t len, float p)
+    {
+        AscendC::Abs(diff, diff, len);
+    }
+
+    __aicore__ static inline void Finalize(AscendC::LocalTensor<float>& vals, uint32_t count, float p) {}
+};
+
+// (Sum)^(1/p) = Exp(Ln(Sum) / p)，通用 p 与整数 p 共用
+__aicore__ inline void PdistRootP(AscendC::LocalTensor<float>& vals, uint32_t count, float p)
+{
+    using namespace AscendC;
+    Ln(vals, vals, count);
+    Muls(vals, vals, 1.0f / p, count);
+    Exp(vals, vals, count);
+}
+
+// 通用 p: |diff|^p = Exp(p * Ln(|diff| + eps))，eps 防止 Ln(0)
+struct PdistMetricGeneric {
+    static constexpr bool MAX_COMBINE = false;
+
+    __aicore__ static inline void Elementwise(AscendC::LocalTensor<float>& diff,
+                                              AscendC::LocalTensor<float>& workLocal, uint32_t len, float p)
+    {
+        using namespace AscendC;
+        Abs(diff, diff, len);
+        Adds(diff, diff, 1e-20f, len);
+        Ln(diff, diff, len);
+        Muls(diff, diff, p, len);
+        Exp(diff, diff, len);
+    }
+
+    __aicore__ static inline void Finalize(AscendC::LocalTensor<float>& vals, uint32_t count, float p)
+    {
+        PdistRootP(vals, count, p);
+    }
+};
+
+// 整数 p (3 ~ PDIST_INT_P_MAX): |diff|^p 用 p - 1 次 Mul 连乘，代替逐元素的 Ln / Exp，且没有 Exp(Ln(x)) 的近似误差
+// |diff| 暂存在 workLocal，连乘结束后 workLocal 可再作归约的临时区
+struct PdistMetricIntP {
+    static constexpr bool MAX_COMBINE = false;
+
+    __aicore__ static inline void Elementwise(AscendC::LocalTensor<float>& diff,
+                                              AscendC::LocalTensor<float>& workLocal, uint32_t len, float p)
+    {
+        using namespace AscendC;
+        uint32_t exponent = static_cast<uint32_t>(p);
+        Abs(diff, diff, len);
+        Adds(workLocal, diff, 0.0f, len);
+        for (uint32_t e = 1; e < exponent; ++e) {
+            Mul(diff, diff, workLocal, len);
+        }
+    }
+
+    __aicore__ static inline void Finalize(AscendC::LocalTensor<float>& vals, uint32_t count, float p)
+    {
+        PdistRootP(vals, count, p);
+    }
+};
+
+// diff 中已有的一对行之差 (调用方可先对其加掩码) 归约为部分结果 (未开方)
+template <typename Metric>
+__aicore__ inline float PdistMetricReduce(AscendC::LocalTensor<float>& diff, AscendC::LocalTensor<float>& outLocal,
+                                          AscendC::LocalTensor<float>& workLocal, uint32_t len, float p)
+{
+    using namespace AscendC;
+    Metric::Elementwise(diff, workLocal, len, p);
+    if constexpr (Metric::MAX_COMBINE) {
+        ReduceMax(outLocal, diff, workLocal, len, false);
+    } else {
+        ReduceSum(outLocal, diff, workLocal, len);
+    }
+    event_t eventVS = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::V_S));
+    SetFlag<HardEvent::V_S>(eventVS);
+    WaitFlag<HardEvent::V_S>(eventVS);
+    return outLocal.GetValue(0);
+}
+
+// 一对行在 m 维某一段上的部分结果 (未开方)，各段按 Metric::MAX_COMBINE 取 Max 或求和
+template <typename Metric>
+__aicore__ inline float PdistMetricPartial(AscendC::LocalTensor<float>& rowI, AscendC::LocalTensor<float>& rowJ,
+                                           AscendC::LocalTensor<float>& diff, AscendC::LocalTensor<float>& outLocal,
+                                           AscendC::LocalTensor<float>& workLocal, uint32_t len, float p)
+{
+    AscendC::Sub(diff, rowI, rowJ, len);
+    return PdistMetricReduce<Metric>(diff, outLocal, workLocal, len, p);
+}
+
+// 一个 i 行对 rows 个连续存放的 j 行 (行距 rowStride 个 float，rowStride <= PDIST_ROW_PACK_MAX_ELEMS 且为 8 的倍数)
+// 的部分结果，依次写入 dst[0, rows)，结果留在 UB 中不经 Scalar
+// Sub 每个 repeat 处理一个 j 行，rowI 的 repeat 步长为 0 即对每行广播；逐元素变换按 rows * rowStride 连续处理；
+// 行长恰为一个 32B block 时用 BlockReduce (一个 repeat 出 8 行)，否则用 WholeReduce (一个 repeat 出 1 行)
+// BlockReduce 按 8 行取整，dst 与 diff 需各留出取整后的空间，多出的结果不使用
+// repeat 次数至多 255: Bj 更大时 Sub 与归约按 PDIST_ROWS_PER_CALL 行一组分次发出
+constexpr uint32_t PDIST_ROWS_PER_CALL = 248; // 8 的倍数，各组的 dst / diff 起点保持 32B 对齐
+
+template <typename Metric>
+__aicore__ inline void PdistMetricRows(AscendC::LocalTensor<float>& dst, AscendC::LocalTensor<float>& rowI,
+                                       AscendC::LocalTensor<float>& rowsJ, AscendC::LocalTensor<float>& diff,
+                                       AscendC::LocalTensor<float>& workLocal, uint32_t rowStride, uint32_t rows,
+                                       float p)
+{
+    using namespace AscendC;
+    constexpr uint32_t FLOATS_PER_BLOCK = 32 / sizeof(float);
+    uint8_t repStride = static_cast<uint8_t>(rowStride / FLOATS_PER_BLOCK);
+    for (uint32_t r0 = 0; r0 < rows; r0 += PDIST_ROWS_PER_CALL) {
+        uint32_t cnt = (rows - r0 < PDIST_ROWS_PER_CALL) ? (rows - r0) : PDIST_ROWS_PER_CALL;
+        LocalTensor<float> diffPart = diff[r0 * rowStride];
+        LocalTensor<float> rowsPart = rowsJ[r0 * rowStride];
+        Sub(diffPart, rowsPart, rowI, rowStride, static_cast<uint8_t>(cnt),
+            BinaryRepeatParams(1, 1, 1, repStride, repStride, 0));
+    }
+    Metric::Elementwise(diff, workLocal, rows * rowStride, p);
+
+    for (uint32_t r0 = 0; r0 < rows; r0 += PDIST_ROWS_PER_CALL) {
+        uint32_t cnt = (rows - r0 < PDIST_ROWS_PER_CALL) ? (rows - r0) : PDIST_ROWS_PER_CALL;
+        LocalTensor<float> dstPart = dst[r0];
+        LocalTensor<float> diffPart = diff[r0 * rowStride];
+        if (rowStride == FLOATS_PER_BLOCK) {
+            uint8_t repeat = static_cast<uint8_t>((cnt + FLOATS_PER_BLOCK - 1) / FLOATS_PER_BLOCK);
+            constexpr int32_t fullMask = 8 * FLOATS_PER_BLOCK;
+            if constexpr (Metric::MAX_COMBINE) {
+                BlockReduceMax(dstPart, diffPart, repeat, fullMask, 1, 1, 8);
+            } else {
+                BlockReduceSum(dstPart, diffPart, repeat, fullMask, 1, 1, 8);
+            }
+        } else {
+            if constexpr (Metric::MAX_COMBINE) {
+                WholeReduceMax(dstPart, diffPart, static_cast<int32_t>(rowStride), static_cast<int32_t>(cnt), 1, 1,
+                               repStride, ReduceOrder::ORDER_ONLY_VALUE);
+            } else {
+                WholeReduceSum(dstPart, diffPart, static_cast<int32_t>(rowStride), static_cast<int32_t>(cnt), 1, 1,
+                               repStride);
+            }
+        }
+    }
+}
+
+#endif // PDIST_METRIC_H
@@ -0,0 +1,73 @@
+/**
+ * @file pdist_profile.h
+ * @brief Optional per-core cycle counters for KernelPdist (compiled in with -DPDIST_PROFILE)
+ *
+ * Each core owns one 64-byte record in the user workspace. Layout must match
+ * host_runtime/pdist_profile.h.
+ */
+
+#ifndef PDIST_PROFILE_H
+#define PDIST_PROFILE_H
+
+#include "kernel_operator.h"
+
+constexpr uint32_t PDIST_PROFILE_MAX_CORES = 64;
+constexpr uint32_t PDIST_PROFILE_RECORD_BYTES = 64;
+constexpr uint32_t PDIST_PROFILE_MAGIC = 0x50524F46; // "PROF"
+
+#ifdef PDIST_PROFILE
+
+// 用 GetSystemCycle 分段计时: 每次 Lap 把距上次打点的 cycle 数累加到对应阶段
+struct PdistProfiler {
+    uint64_t copyInCycles;
+    uint64_t computeCycles;
+    uint64_t copyOutCycles;
+    uint64_t pairs;
+    uint64_t rows;
+    int64_t start;
+    int64_t mark;
+
+    __aicore__ inline void Begin() {
+        copyInCycles = 0;
+        computeCycles = 0;
+        copyOutCycles = 0;
+        pairs = 0;
+        rows = 0;
+        start = AscendC::GetSystemCycle();
+        mark = start;
+    }
+
+    __aicore__ inline void Lap(uint64_t& bucket) {
+        int64_t now = AscendC::GetSystemCycle();
+        bucket += static_cast<uint64_t>(now - mark);
+        mark = now;
+    }
+
+    // 将本核记录写入 workspace 中的第 coreId 个槽位
+    __aicore__ inline void Flush(GM_ADDR region, uint32_t coreId) {
+        if (region == nullptr || coreId >= PDIST_PROFILE_MAX_CORES) return;
+        AscendC::GlobalTensor<uint64_t> rec;
+        rec.SetGlobalBuffer((__gm__ uint64_t*)(region + coreId * PDIST_PROFILE_RECORD_BYTES));
+        rec.SetValue(0, copyInCycles);
+        rec.SetValue(1, computeCycles);
+        rec.SetValue(2, copyOutCycles);
+        rec.SetValue(3, static_cast<uint64_t>(AscendC::GetSystemCycle() - start));
+        rec.SetValue(4, pairs);
+        rec.SetValue(5, rows);
+        rec.SetValue(6, (static_cast<uint64_t>(PDIST_PROFILE_MAGIC) << 32) | coreId);
+        rec.SetValue(7, 0);
+        // 标量写 GM 经过 DCache，需刷出后 host 才能读到
+        AscendC::DataCacheCleanAndInvalid<uint64_t, AscendC::CacheLine::SINGLE_CACHE_LINE,
+                                          AscendC::DcciDst::CACHELINE_OUT>(rec);
+    }
+};
+
+#define PDIST_PROF(stmt) stmt
+
+#else
+
+#define PDIST_PROF(stmt)
+
+#endif // PDIST_PROFILE
+
+#endif // PDIST_PROFILE_H
@@ -0,0 +1,48 @@
+/**
+ * @file pdist_quant.cpp
+ * @brief Kernel implementation for PdistQuant Operator (int8 input with per-row scale / zero point)
+ */
+
+#include "kernel_operator.h"
+#include "pdist_gram.h"
+#include "pdist_vector.h"
+
+extern "C" __global__ __aicore__ void pdist_quant(GM_ADDR x, GM_ADDR scale, GM_ADDR zero_point, GM_ADDR y,
+                                                  GM_ADDR workspace, GM_ADDR tiling) {
+    // 与 pdist 相同: Vector kernel 按 AIV 核启动，Gram 路径每个 block 为 1 AIC + 2 AIV
+    KERNEL_TASK_TYPE_DEFAULT(KERNEL_TYPE_AIV_ONLY);
+    KERNEL_TASK_TYPE(2, KERNEL_TYPE_MIX_AIC_1_2);
+    const __gm__ KernelTilingData* tDataGM = (const __gm__ KernelTilingData*)tiling;
+    KernelTilingData tDataLocal;
+    LoadKernelTilingData(tDataGM, tDataLocal);
+
+    // DTYPE_X = int8_t，DTYPE_Y = float；未提供 zero_point 时其地址为空 (对称量化)
+    // tilingKey 需与 op_host/pdist_tiling_plan.h 的 PDIST_TILING_KEY_* 一致:
+    // 1 = Vector 通用 p, 2 = Gram (int8 Cube), 3 / 4 / 5 = Vector p = 1 / 2 / inf, 6 = Vector 整数 p
+    GM_ADDR usrWorkspace = GetUserWorkspace(workspace);
+    if (TILING_KEY_IS(1)) {
+        RunPdistVector<DTYPE_X, PdistMetricGeneric, DTYPE_Y>(x, nullptr, y, nullptr, usrWorkspace, &tDataLocal,
+                                                             scale, zero_point);
+    } else if (TILING_KEY_IS(3)) {
+        RunPdistVector<DTYPE_X, PdistMetricL1, DTYPE_Y>(x, nullptr, y, nullptr, usrWorkspace, &tDataLocal,
+                                                        scale, zero_point);
+    } else if (TILING_KEY_IS(4)) {
+        RunPdistVector<DTYPE_X, PdistMetricL2, DTYPE_Y>(x, nullptr, y, nullptr, usrWorkspace, &tDataLocal,
+                                                        scale, zero_point);
+    } else if (TILING_KEY_IS(5)) {
+        RunPdistVector<DTYPE_X, PdistMetricLinf, DTYPE_Y>(x, nullptr, y, nullptr, usrWorkspace, &tDataLocal,
+                                                          scale, zero_point);
+    } else if (TILING_KEY_IS(6)) {
+        RunPdistVector<DTYPE_X, PdistMetricIntP, DTYPE_Y>(x, nullptr, y, nullptr, usrWorkspace, &tDataLocal,
+                                                          scale, zero_point);
+    } else if (TILING_KEY_IS(2)) {
+        LoadKernelCubeTiling(tDataGM, tDataLocal);
+        SetSysWorkspace(workspace);
+        TPipe pipe;
+        KernelPdistGram<DTYPE_X, DTYPE_Y> op;
+        REGIST_MATMUL_OBJ(&pipe, GetSysWorkSpacePtr(), op.mm, &tDataLocal.cubeTiling);
+        op.Init(x, y, usrWorkspace, tDataLocal.n, tDataLocal.m, tDataLocal.rowStride,
+                tDataLocal.kChunk, tDataLocal.chunkNum, tDataLocal.usedCoreNum, &pipe, scale, zero_point);
+        op.Process();
+    }
+}
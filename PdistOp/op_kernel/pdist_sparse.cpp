@@ -0,0 +1,322 @@
+/**
+ * @file pdist_sparse.cpp
+ * @brief Kernel implementation for PdistSparse Operator (CSR input)
+ *
+ * Each pair merges the two sorted column lists on the scalar unit, reading CSR through small UB
+ * windows. p = 2 only walks the intersection (sparse dot) and uses precomputed squared norms;
+ * other p walk the union. Work per pair is nnz_i + nnz_j, independent of the dense width m.
+ * Scalar running sums use compensated (Neumaier) summation so long rows do not drift.
+ */
+
+#include "kernel_operator.h"
+#include "pdist_common.h"
+
+using namespace AscendC;
+
+// 本地定义 Tiling 结构体，确保与 Host 侧一致
+struct KernelSparseTilingData {
+    uint32_t n;
+    uint32_t nnz;
+    float p;
+    uint32_t usedCoreNum;
+    uint32_t tilingKey;
+    uint32_t pClass;
+    uint32_t windowLen;
+};
+
+// GM 数组 [start, start + len) 这一段在 UB 中的副本，访问越出窗口时从该位置起重新搬入 cap 个
+template <typename U>
+struct SparseWindow {
+    GlobalTensor<U> gm;
+    LocalTensor<U> local;
+    uint32_t start;
+    uint32_t len;
+    uint32_t total;
+};
+
+class KernelPdistSparse {
+public:
+    __aicore__ inline KernelPdistSparse() {}
+
+    __aicore__ inline void Init(GM_ADDR indptr, GM_ADDR indices, GM_ADDR values, GM_ADDR y, GM_ADDR usrWorkspace,
+                                const KernelSparseTilingData* tData) {
+        n = tData->n;
+        nnz = tData->nnz;
+        p = tData->p;
+        pClass = tData->pClass;
+        totalCoreNum = tData->usedCoreNum;
+        cap = tData->windowLen;
+        coreId = GetBlockIdx();
+
+        yGm.SetGlobalBuffer((__gm__ float*)y);
+        normGmAddr = usrWorkspace;
+
+        pipe.InitBuffer(ptrBuf, cap * sizeof(int32_t));
+        pipe.InitBuffer(normBuf, cap * sizeof(float));
+        pipe.InitBuffer(iIdxBuf, cap * sizeof(int32_t));
+        pipe.InitBuffer(iValBuf, cap * sizeof(float));
+        pipe.InitBuffer(jIdxBuf, cap * sizeof(int32_t));
+        pipe.InitBuffer(jValBuf, cap * sizeof(float));
+        // 每行的结果先攒在 outBuf，整段开方后写回；通用 p 的 |diff| 攒在 diffBuf 后用 Vector 求 |diff|^p
+        pipe.InitBuffer(outBuf, cap * sizeof(float));
+        pipe.InitBuffer(diffBuf, cap * sizeof(float));
+        pipe.InitBuffer(workBuf, cap * sizeof(float));
+        pipe.InitBuffer(reduceBuf, 32);
+
+        InitWindow(ptrWin, indptr, ptrBuf, n + 1);
+        InitWindow(normWin, usrWorkspace, normBuf, n);
+        InitWindow(iIdxWin, indices, iIdxBuf, nnz);
+        InitWindow(iValWin, values, iValBuf, nnz);
+        InitWindow(jIdxWin, indices, jIdxBuf, nnz);
+        InitWindow(jValWin, values, jValBuf, nnz);
+    }
+
+    __aicore__ inline void Process() {
+        if (coreId >= totalCoreNum) return;
+        if (pClass == PDIST_P_TWO) {
+            ComputeNorms();
+            // 全部行的范数写完后才能开始算距离
+            SyncAll();
+        }
+
+        // 行 i 有 n - 1 - i 个 pair: 每轮 usedCoreNum 行，偶数轮正序、奇数轮逆序分给各核，使每核总量接近
+        uint32_t rowNum = (n > 1) ? (n - 1) : 0;
+        for (uint32_t base = 0, round = 0; base < rowNum; base += totalCoreNum, ++round) {
+            uint32_t i = (round % 2 == 0) ? (base + coreId) : (base + totalCoreNum - 1 - coreId);
+            if (i < rowNum) {
+                ProcessRow(i);
+            }
+        }
+    }
+
+private:
+    template <typename U>
+    __aicore__ inline void InitWindow(SparseWindow<U>& w, GM_ADDR addr, TBuf<TPosition::VECCALC>& buf,
+                                      uint32_t total) {
+        w.gm.SetGlobalBuffer((__gm__ U*)addr);
+        w.local = buf.Get<U>();
+        w.start = 0;
+        w.len = 0;
+        w.total = total;
+    }
+
+    template <typename U>
+    __aicore__ inline U WindowGet(SparseWindow<U>& w, uint32_t k) {
+        if (k < w.start || k >= w.start + w.len) {
+            w.start = k;
+            w.len = (w.total - k < cap) ? (w.total - k) : cap;
+            DataCopyExtParams copyParams{1, static_cast<uint32_t>(w.len * sizeof(U)), 0, 0, 0};
+            DataCopyPad(w.local, w.gm[k], copyParams, DataCopyPadExtParams<U>{false, 0, 0, 0});
+            event_t eventMte2S = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE2_S));
+            SetFlag<HardEvent::MTE2_S>(eventMte2S);
+            WaitFlag<HardEvent::MTE2_S>(eventMte2S);
+        }
+        return w.local.GetValue(k - w.start);
+    }
+
+    // 每个核负责连续的一段行，Sum(v^2) 攒满 outBuf 后写回 workspace
+    __aicore__ inline void ComputeNorms() {
+        uint32_t rowsPerCore = (n + totalCoreNum - 1) / totalCoreNum;
+        uint32_t rowStart = coreId * rowsPerCore;
+        uint32_t rowEnd = (rowStart + rowsPerCore < n) ? (rowStart + rowsPerCore) : n;
+        GlobalTensor<float> normGm;
+        normGm.SetGlobalBuffer((__gm__ float*)normGmAddr);
+        LocalTensor<float> out = outBuf.Get<float>();
+
+        for (uint32_t g0 = rowStart; g0 < rowEnd; g0 += cap) {
+            uint32_t cnt = (rowEnd - g0 < cap) ? (rowEnd - g0) : cap;
+            for (uint32_t r = 0; r < cnt; ++r) {
+                uint32_t b0 = static_cast<uint32_t>(WindowGet(ptrWin, g0 + r));
+                uint32_t b1 = static_cast<uint32_t>(WindowGet(ptrWin, g0 + r + 1));
+                float acc = 0.0f;
+                float comp = 0.0f;
+                for (uint32_t b = b0; b < b1; ++b) {
+                    float v = WindowGet(jValWin, b);
+                    KahanAdd(acc, comp, v * v);
+                }
+                out.SetValue(r, acc + comp);
+            }
+            event_t eventSMte3 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::S_MTE3));
+            SetFlag<HardEvent::S_MTE3>(eventSMte3);
+            WaitFlag<HardEvent::S_MTE3>(eventSMte3);
+            DataCopyExtParams copyParams{1, static_cast<uint32_t>(cnt * sizeof(float)), 0, 0, 0};
+            DataCopyPad(normGm[g0], out, copyParams);
+            event_t eventMte3S = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE3_S));
+            SetFlag<HardEvent::MTE3_S>(eventMte3S);
+            WaitFlag<HardEvent::MTE3_S>(eventMte3S);
+        }
+    }
+
+    // 第 i 行与 j > i 的全部行；结果攒满 outBuf (或行尾) 时整段写回压缩输出中连续的一段
+    __aicore__ inline void ProcessRow(uint32_t i) {
+        LocalTensor<float> out = outBuf.Get<float>();
+        uint32_t a0 = static_cast<uint32_t>(WindowGet(ptrWin, i));
+        uint32_t a1 = static_cast<uint32_t>(WindowGet(ptrWin, i + 1));
+        float normI = (pClass == PDIST_P_TWO) ? WindowGet(normWin, i) : 0.0f;
+
+        uint32_t segStart = i + 1;
+        uint32_t cnt = 0;
+        for (uint32_t j = i + 1; j < n; ++j) {
+            uint32_t b0 = static_cast<uint32_t>(WindowGet(ptrWin, j));
+            uint32_t b1 = static_cast<uint32_t>(WindowGet(ptrWin, j + 1));
+            float value;
+            if (pClass == PDIST_P_TWO) {
+                // ||xi - xj||^2 = ||xi||^2 + ||xj||^2 - 2 <xi, xj>，点积只需列号的交集
+                value = normI + WindowGet(normWin, j) - 2.0f * SparseDot(a0, a1, b0, b1);
+            } else {
+                value = MergeUnion(a0, a1, b0, b1);
+            }
+            out.SetValue(cnt++, value);
+            if (cnt == cap) {
+                FlushRow(i, segStart, cnt);
+                segStart += cnt;
+                cnt = 0;
+            }
+        }
+        if (cnt > 0) {
+            FlushRow(i, segStart, cnt);
+        }
+    }
+
+    __aicore__ inline float SparseDot(uint32_t a, uint32_t a1, uint32_t b, uint32_t b1) {
+        float dot = 0.0f;
+        float comp = 0.0f;
+        while (a < a1 && b < b1) {
+            int32_t ca = WindowGet(iIdxWin, a);
+            int32_t cb = WindowGet(jIdxWin, b);
+            if (ca == cb) {
+                KahanAdd(dot, comp, WindowGet(iValWin, a) * WindowGet(jValWin, b));
+                ++a;
+                ++b;
+            } else if (ca < cb) {
+                ++a;
+            } else {
+                ++b;
+            }
+        }
+        return dot + comp;
+    }
+
+    // 按列号归并两行的并集: 只在一侧出现的列另一侧取 0；返回未开方的部分结果 (同 pdist_metric.h 的 Reduce)
+    __aicore__ inline float MergeUnion(uint32_t a, uint32_t a1, uint32_t b, uint32_t b1) {
+        float acc = 0.0f;
+        float comp = 0.0f;
+        diffCount = 0;
+        while (a < a1 || b < b1) {
+            int32_t ca = (a < a1) ? WindowGet(iIdxWin, a) : INT32_MAX;
+            int32_t cb = (b < b1) ? WindowGet(jIdxWin, b) : INT32_MAX;
+            float diff;
+            if (ca == cb) {
+                diff = WindowGet(iValWin, a) - WindowGet(jValWin, b);
+                ++a;
+                ++b;
+            } else if (ca < cb) {
+                diff = WindowGet(iValWin, a);
+                ++a;
+            } else {
+                diff = WindowGet(jValWin, b);
+                ++b;
+            }
+            diff = (diff < 0.0f) ? -diff : diff;
+            if (pClass == PDIST_P_ONE) {
+                KahanAdd(acc, comp, diff);
+            } else if (pClass == PDIST_P_INF) {
+                acc = (diff > acc) ? diff : acc;
+            } else {
+                // |diff|^p 需要 Ln / Exp，攒够一批交给 Vector
+                diffBuf.Get<float>().SetValue(diffCount++, diff);
+                if (diffCount == cap) {
+                    KahanAdd(acc, comp, PowSum());
+                }
+            }
+        }
+        if (pClass == PDIST_P_GENERIC && diffCount > 0) {
+            KahanAdd(acc, comp, PowSum());
+        }
+        return acc + comp;
+    }
+
+    // Sum(|diff|^p) = Sum(Exp(p * Ln(|diff| + eps)))，与 PdistMetricGeneric 相同
+    __aicore__ inline float PowSum() {
+        LocalTensor<float> diff = diffBuf.Get<float>();
+        LocalTensor<float> work = workBuf.Get<float>();
+        LocalTensor<float> red = reduceBuf.Get<float>();
+        event_t eventSV = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::S_V));
+        SetFlag<HardEvent::S_V>(eventSV);
+        WaitFlag<HardEvent::S_V>(eventSV);
+        Adds(diff, diff, 1e-20f, diffCount);
+        Ln(diff, diff, diffCount);
+        Muls(diff, diff, p, diffCount);
+        Exp(diff, diff, diffCount);
+        ReduceSum(red, diff, work, diffCount);
+        event_t eventVS = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::V_S));
+        SetFlag<HardEvent::V_S>(eventVS);
+        WaitFlag<HardEvent::V_S>(eventVS);
+        diffCount = 0;
+        return red.GetValue(0);
+    }
+
+    // outBuf 前 cnt 个为第 i 行 [j0, j0 + cnt) 的部分结果，开方后写回
+    __aicore__ inline void FlushRow(uint32_t i, uint32_t j0, uint32_t cnt) {
+        LocalTensor<float> out = outBuf.Get<float>();
+        event_t eventSV = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::S_V));
+        SetFlag<HardEvent::S_V>(eventSV);
+        WaitFlag<HardEvent::S_V>(eventSV);
+        if (pClass == PDIST_P_TWO) {
+            // 浮点抵消可能产生微小负数
+            Maxs(out, out, 0.0f, cnt);
+        }
+        MinkowskiFinalize(out, cnt, p, pClass);
+        event_t eventVMte3 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::V_MTE3));
+        SetFlag<HardEvent::V_MTE3>(eventVMte3);
+        WaitFlag<HardEvent::V_MTE3>(eventVMte3);
+
+        uint64_t outIdx = (uint64_t)(2 * n - 1 - i) * i / 2 + (j0 - i - 1);
+        DataCopyExtParams copyParams{1, static_cast<uint32_t>(cnt * sizeof(float)), 0, 0, 0};
+        DataCopyPad(yGm[outIdx], out, copyParams);
+        // 下一段的 SetValue 要等本段写回完成
+        event_t eventMte3S = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE3_S));
+        SetFlag<HardEvent::MTE3_S>(eventMte3S);
+        WaitFlag<HardEvent::MTE3_S>(eventMte3S);
+    }
+
+private:
+    TPipe pipe;
+    TBuf<TPosition::VECCALC> ptrBuf, normBuf, iIdxBuf, iValBuf, jIdxBuf, jValBuf;
+    TBuf<TPosition::VECCALC> outBuf, diffBuf, workBuf, reduceBuf;
+
+    SparseWindow<int32_t> ptrWin;
+    SparseWindow<float> normWin;
+    SparseWindow<int32_t> iIdxWin, jIdxWin;
+    SparseWindow<float> iValWin, jValWin;
+
+    GlobalTensor<float> yGm;
+    GM_ADDR normGmAddr;
+
+    uint32_t n, nnz;
+    float p;
+    uint32_t pClass;
+    uint32_t totalCoreNum;
+    uint32_t coreId;
+    uint32_t cap;
+    uint32_t diffCount;
+};
+
+extern "C" __global__ __aicore__ void pdist_sparse(GM_ADDR indptr, GM_ADDR indices, GM_ADDR values, GM_ADDR y,
+                                                   GM_ADDR workspace, GM_ADDR tiling) {
+    KERNEL_TASK_TYPE_DEFAULT(KERNEL_TYPE_AIV_ONLY);
+    const __gm__ KernelSparseTilingData* tDataGM = (const __gm__ KernelSparseTilingData*)tiling;
+
+    KernelSparseTilingData tDataLocal;
+    tDataLocal.n = tDataGM->n;
+    tDataLocal.nnz = tDataGM->nnz;
+    tDataLocal.p = tDataGM->p;
+    tDataLocal.usedCoreNum = tDataGM->usedCoreNum;
+    tDataLocal.tilingKey = tDataGM->tilingKey;
+    tDataLocal.pClass = tDataGM->pClass;
+    tDataLocal.windowLen = tDataGM->windowLen;
+
+    KernelPdistSparse op;
+    op.Init(indptr, indices, values, y, GetUserWorkspace(workspace), &tDataLocal);
+    op.Process();
+}
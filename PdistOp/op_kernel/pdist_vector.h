@@ -0,0 +1,671 @@
+/**
+ * @file pdist_vector.h
+ * @brief Tiled vector Pdist kernel (the PDIST_TILING_KEY_VECTOR* keys) and the kernel-side tiling struct
+ *
+ * Shared by the Pdist entry (float / half input) and the PdistQuant entry (int8 input with per-row
+ * scale and optional zero point, dequantised to float in UB before the distance math). The distance
+ * math comes from a metric policy (pdist_metric.h), one kernel instantiation per vector tilingKey.
+ */
+
+#ifndef PDIST_VECTOR_H
+#define PDIST_VECTOR_H
+
+#include "kernel_operator.h"
+#include "pdist_common.h"
+#include "pdist_metric.h"
+#include "pdist_profile.h"
+
+using namespace AscendC;
+
+// 本地定义 Tiling 结构体，确保与 Host 侧一致
+struct KernelTilingData {
+    uint32_t n;
+    uint32_t m;
+    float p;
+    uint32_t tileLength;
+    uint32_t usedCoreNum;
+    uint32_t tilingKey;
+    uint32_t pClass;
+    uint32_t blockRows;
+    uint32_t blockCols;
+    uint32_t kChunk;
+    uint32_t chunkNum;
+    uint32_t bufferNum;
+    uint32_t bandBlocks;
+    uint32_t tileNum;
+    uint32_t panelBlocks;
+    uint32_t rowStride;
+    uint32_t indexSize;
+    uint32_t schedMode;
+    uint32_t nanPolicy;
+    uint32_t validityOut;
+    TCubeTiling cubeTiling; // 仅 Gram 路径使用
+};
+
+// 将 GM 上的 tiling 逐字段拷贝到栈上 (Scalar Copy)，Init 接收普通指针，不再有 __gm__ 冲突
+__aicore__ inline void LoadKernelTilingData(const __gm__ KernelTilingData* src, KernelTilingData& dst) {
+    dst.n = src->n;
+    dst.m = src->m;
+    dst.p = src->p;
+    dst.tileLength = src->tileLength;
+    dst.usedCoreNum = src->usedCoreNum;
+    dst.tilingKey = src->tilingKey;
+    dst.pClass = src->pClass;
+    dst.blockRows = src->blockRows;
+    dst.blockCols = src->blockCols;
+    dst.kChunk = src->kChunk;
+    dst.chunkNum = src->chunkNum;
+    dst.bufferNum = src->bufferNum;
+    dst.bandBlocks = src->bandBlocks;
+    dst.tileNum = src->tileNum;
+    dst.panelBlocks = src->panelBlocks;
+    dst.rowStride = src->rowStride;
+    dst.indexSize = src->indexSize;
+    dst.schedMode = src->schedMode;
+    dst.nanPolicy = src->nanPolicy;
+    dst.validityOut = src->validityOut;
+}
+
+// Matmul 的 tiling 只在 Gram 路径需要，按 32 位字整体拷贝
+__aicore__ inline void LoadKernelCubeTiling(const __gm__ KernelTilingData* src, KernelTilingData& dst) {
+    const __gm__ uint32_t* cubeSrc = (const __gm__ uint32_t*)&src->cubeTiling;
+    uint32_t* cubeDst = (uint32_t*)&dst.cubeTiling;
+    for (uint32_t k = 0; k < sizeof(TCubeTiling) / sizeof(uint32_t); ++k) {
+        cubeDst[k] = cubeSrc[k];
+    }
+}
+
+constexpr int32_t BUFFER_NUM = 2;
+
+// T 为输入元素类型 (float / half，或 PdistQuant 的 int8_t)，TOut 为输出元素类型，计算统一在 float 上进行
+// Metric 为距离策略 (PdistMetricL1 / L2 / Linf / IntP / Generic)，段内归约、段间合并与开方均由它在编译期决定
+// int8 输入按行反量化 x = scale * (q - zp) 后参与计算，输出 float
+// 分块: n x n 网格按 blockRows x blockCols 切成 tile，只处理上三角 tile，按 j panel / 行带顺序编号，
+// 在核间 Cyclic 分配或由各核经原子计数器动态领取；对角 tile 按行屏蔽 j <= i 的部分；
+// m 维按 kChunk 切段，各段部分结果在 UB 累加器中补偿求和后再开方、按行整段写回
+// nan_policy 非 propagate 或带位图输出时，搬入的每段行都检查是否全为有限值 (见 CheckRows)
+template <typename T, typename Metric, typename TOut = T>
+class KernelPdist {
+public:
+    __aicore__ inline KernelPdist() {}
+
+    // 只比较 x 中 indices 指定的行 (Pdist 的可选输入)，输出按 indices 的顺序编号；不调用时比较全部 n 行
+    __aicore__ inline void SetRowIndices(GM_ADDR indices, uint32_t indexSize) {
+        rowMap.Init(indices, indexSize);
+    }
+
+    // Pdist 的可选输出 valid (逐行有效性位图)；地址为空或 Host 未规划位图时不写
+    __aicore__ inline void SetValidityOutput(GM_ADDR valid) {
+        hasValidity = (valid != nullptr);
+        if (hasValidity) {
+            validGm.SetGlobalBuffer((__gm__ uint8_t*)valid);
+        }
+    }
+
+    // scale / zeroPoint 只用于 int8 输入 (每行一个 float / int32)，zeroPoint 为空表示对称量化
+    __aicore__ inline void Init(GM_ADDR x, GM_ADDR y, GM_ADDR usrWorkspace, const KernelTilingData* tData,
+                                GM_ADDR scale = nullptr, GM_ADDR zeroPoint = nullptr) {
+        // 1. 获取参数
+        n = tData->n;
+        m = tData->m;
+        rowStride = tData->rowStride;
+        p = tData->p;
+        totalCoreNum = tData->usedCoreNum;
+        blockRows = tData->blockRows;
+        blockCols = tData->blockCols;
+        kChunk = tData->kChunk;
+        chunkNum = tData->chunkNum;
+        bandBlocks = tData->bandBlocks;
+        panelBlocks = tData->panelBlocks;
+        schedMode = tData->schedMode;
+        nanPolicy = tData->nanPolicy;
+        checkRows = (nanPolicy != PDIST_NAN_PROPAGATE || tData->validityOut != 0);
+        hasValidity = hasValidity && (tData->validityOut != 0);
+        iBlockNum = (n + blockRows - 1) / blockRows;
+        jBlockNum = (n + blockCols - 1) / blockCols;
+
+        coreId = GetBlockIdx();
+
+        // 2. 初始化 Global Tensor
+        xGm.SetGlobalBuffer((__gm__ T*)x);
+        yGm.SetGlobalBuffer((__gm__ TOut*)y);
+        hasZeroPoint = (zeroPoint != nullptr);
+        if constexpr (IsSameType<T, int8_t>::value) {
+            scaleGm.SetGlobalBuffer((__gm__ float*)scale);
+            zeroPointGm.SetGlobalBuffer((__gm__ int32_t*)zeroPoint);
+        }
+
+        // 3. 初始化 Buffer (大小需与 Host 侧 PdistUbBytes 一致)
+        pipe.InitBuffer(inQueueI, 1, blockRows * kChunk * sizeof(T));
+        pipe.InitBuffer(inQueueJ, tData->bufferNum, blockCols * kChunk * sizeof(T));
+        // FP16 输入先 Cast 成 float 再计算
+        if constexpr (!IsSameType<T, float>::value) {
+            pipe.InitBuffer(castBufI, blockRows * kChunk * sizeof(float));
+            pipe.InitBuffer(castBufJ, blockCols * kChunk * sizeof(float));
+        }
+        // INT8 输入经 half 两级 Cast (int8 在 half 中精确表示)，每行的 scale 与 zero point 随块搬入
+        if constexpr (IsSameType<T, int8_t>::value) {
+            pipe.InitBuffer(halfBufI, blockRows * kChunk * sizeof(half));
+            pipe.InitBuffer(halfBufJ, blockCols * kChunk * sizeof(half));
+            pipe.InitBuffer(qParamBufI, 2 * ((blockRows * sizeof(float) + 31) / 32 * 32));
+            pipe.InitBuffer(qParamBufJ, 2 * ((blockCols * sizeof(float) + 31) / 32 * 32));
+        }
+        // 段长不超过 PDIST_ROW_PACK_MAX_ELEMS 时 diff / 临时 buffer 容纳整个 j 块，单段时按行打包计算
+        rowPacked = (chunkNum == 1 && kChunk <= PDIST_ROW_PACK_MAX_ELEMS);
+        uint32_t diffElems = (kChunk <= PDIST_ROW_PACK_MAX_ELEMS) ? blockCols * kChunk : kChunk;
+        pipe.InitBuffer(diffBuf, diffElems * sizeof(float));
+        // ReduceSum 需要的 workspace (大小为 kChunk * sizeof(float))，打包时兼作 IntP 的 |diff| 暂存
+        pipe.InitBuffer(workBuf, diffElems * sizeof(float));
+        pipe.InitBuffer(reduceBuf, 32);
+        pipe.InitBuffer(accBuf, blockRows * blockCols * sizeof(float));
+        pipe.InitBuffer(compBuf, blockRows * blockCols * sizeof(float));
+        pipe.InitBuffer(outQueue, BUFFER_NUM, (blockCols * sizeof(TOut) + 31) / 32 * 32);
+        // 行有效标记 (i / j 块各一段 float，1 有效 / 0 含非有限值) 与位图输出行；ignore-dimension 另需逐元素掩码
+        if (checkRows) {
+            pipe.InitBuffer(rowValidBuf, ((blockRows + 7) / 8 * 8 + (blockCols + 7) / 8 * 8) * sizeof(float));
+            pipe.InitBuffer(bitsBuf, ((blockCols + 7) / 8 + 31) / 32 * 32);
+        }
+        if (nanPolicy == PDIST_NAN_IGNORE_DIM) {
+            pipe.InitBuffer(maskBufI, blockRows * kChunk * sizeof(float));
+            pipe.InitBuffer(maskBufJ, blockCols * kChunk * sizeof(float));
+        }
+        iAllValid = true;
+        jAllValid = true;
+
+        // 4. user workspace: 动态调度时开头为 tile 计数器，其后为 Profiling 记录区 (仅 -DPDIST_PROFILE 构建)
+        if (schedMode == PDIST_SCHED_DYNAMIC) {
+            tileCounterGm.SetGlobalBuffer((__gm__ int32_t*)usrWorkspace);
+            usrWorkspace += PDIST_SCHED_COUNTER_BYTES;
+        }
+        profRegion = usrWorkspace;
+    }
+
+    __aicore__ inline void Process() {
+        if (coreId >= totalCoreNum) return;
+        PDIST_PROF(prof.Begin());
+
+        if (schedMode == PDIST_SCHED_DYNAMIC) {
+            ResetTileCounter();
+        }
+
+        // tile 按 panel / 行带顺序编号 (与 Host 侧 PdistForEachTileColumn 一致)，Core c 先处理第 c 个；
+        // 静态调度之后依次为 c + usedCoreNum, c + 2 * usedCoreNum, ...，动态调度由 NextTile 领取
+        panelStart = 0;
+        panelEnd = (panelBlocks < jBlockNum) ? panelBlocks : jBlockNum;
+        bandStart = 0;
+        colJb = 0;
+        colIdx = 0;
+        residentIb = iBlockNum;
+        uint32_t tile = coreId;
+        AdvanceTile(tile);
+        while (panelStart < jBlockNum) {
+            ProcessTile(bandStart + colIdx, colJb);
+            // 同一个核领到的编号单调递增，游标只需向前移动
+            uint32_t next = NextTile(tile);
+            AdvanceTile(next - tile);
+            tile = next;
+        }
+        // n == 1 时没有 tile，位图由 0 号核单独搬入该行写出 (不产生 pair)
+        if (n == 1 && hasValidity && coreId == 0) {
+            ProcessTile(0, 0);
+        }
+        // 单段时最后一个 i 块 (含上面 n == 1 搬入的行) 仍常驻 UB
+        if (residentIb < iBlockNum) {
+            inQueueI.FreeTensor(iRaw);
+            residentIb = iBlockNum;
+        }
+
+        PDIST_PROF(prof.Flush(profRegion, coreId));
+    }
+
+private:
+    // 计数器记录已被领取的 tile 数 (不含各核的首个 tile)；workspace 不保证清零，由 0 号核置零，
+    // 全部核等待置零完成后才开始领取
+    __aicore__ inline void ResetTileCounter() {
+        if (coreId == 0) {
+            tileCounterGm.SetValue(0, 0);
+            DataCacheCleanAndInvalid<int32_t, CacheLine::SINGLE_CACHE_LINE, DcciDst::CACHELINE_OUT>(tileCounterGm);
+        }
+        SyncAll();
+    }
+
+    // 动态调度: 原子加 1 取回旧值 k，下一个 tile 为第 usedCoreNum + k 个，先处理完的核先领取，
+    // 对角 tile 与 L2 争用造成的耗时差异由领取次数自动吸收；编号越过最后一个 tile 时游标走到末尾，循环结束
+    __aicore__ inline uint32_t NextTile(uint32_t tile) {
+        if (schedMode != PDIST_SCHED_DYNAMIC) {
+            return tile + totalCoreNum;
+        }
+        int32_t claimed = AtomicAdd((__gm__ int32_t*)tileCounterGm.GetPhyAddr(), 1);
+        return totalCoreNum + static_cast<uint32_t>(claimed);
+    }
+
+    // 第 jb 列中含 j > i 的 i 块满足 ib < TileRowEnd(jb) (同 Host 侧 PdistTileRowEnd)
+    __aicore__ inline uint32_t TileRowEnd(uint32_t jb) {
+        uint32_t jEnd = (jb + 1) * blockCols;
+        uint32_t jMax = ((jEnd < n) ? jEnd : n) - 1;
+        return (jMax + blockRows - 1) / blockRows;
+    }
+
+    // 当前 panel、当前行带中第 colJb 列的有效 tile 数 (带内一段前缀)
+    __aicore__ inline uint32_t ColumnCount() {
+        if (colJb >= panelEnd) {
+            return 0;
+        }
+        uint32_t bandEnd = (bandStart + bandBlocks < iBlockNum) ? (bandStart + bandBlocks) : iBlockNum;
+        uint32_t rowEnd = TileRowEnd(colJb);
+        uint32_t end = (rowEnd < bandEnd) ? rowEnd : bandEnd;
+        return (end > bandStart) ? (end - bandStart) : 0;
+    }
+
+    // 列走完换下一个行带，panel 内的行带走完换下一个 panel
+    __aicore__ inline void NextColumn() {
+        if (++colJb < panelEnd) {
+            return;
+        }
+        bandStart += bandBlocks;
+        uint32_t panelRowEnd = TileRowEnd(panelEnd - 1);
+        panelRowEnd = (panelRowEnd < iBlockNum) ? panelRowEnd : iBlockNum;
+        if (bandStart < panelRowEnd) {
+            uint32_t first = (bandStart * blockRows + 1) / blockCols;
+            colJb = (first > panelStart) ? first : panelStart;
+            return;
+        }
+        panelStart = panelEnd;
+        panelEnd = (panelStart + panelBlocks < jBlockNum) ? (panelStart + panelBlocks) : jBlockNum;
+        bandStart = 0;
+        colJb = panelStart;
+    }
+
+    // 游标前进 steps 个 tile (按列整段跳过)；越过最后一个 tile 后 panelStart == jBlockNum
+    __aicore__ inline void AdvanceTile(uint32_t steps) {
+        colIdx += steps;
+        uint32_t count = ColumnCount();
+        while (colIdx >= count && panelStart < jBlockNum) {
+            colIdx -= count;
+            NextColumn();
+            count = ColumnCount();
+        }
+    }
+
+    __aicore__ inline void ProcessTile(uint32_t ib, uint32_t jb) {
+        uint32_t i0 = ib * blockRows;
+        uint32_t iCount = (n - i0 < blockRows) ? (n - i0) : blockRows;
+        uint32_t j0 = jb * blockCols;
+        uint32_t jCount = (n - j0 < blockCols) ? (n - j0) : blockCols;
+        // 对角 tile 含 j <= i 的元素，需逐行屏蔽；其余 tile 整块有效
+        bool diagonal = (j0 <= i0 + iCount - 1);
+
+        for (uint32_t c = 0; c < chunkNum; ++c) {
+            uint32_t k0 = c * kChunk;
+            uint32_t kLen = (m - k0 < kChunk) ? (m - k0) : kChunk;
+            uint32_t kLenAligned = (kLen * sizeof(T) + 31) / 32 * 32 / sizeof(T);
+
+            // 单段时 i 块常驻 UB，直到本核换到另一个 i 块；多段时随每段重新搬入
+            if (residentIb != ib) {
+                if (residentIb < iBlockNum) {
+                    inQueueI.FreeTensor(iRaw);
+                    residentIb = iBlockNum;
+                }
+                iRaw = inQueueI.template AllocTensor<T>();
+                CopyRowsMapped<T>(iRaw, xGm, rowMap, i0, iCount, k0, kLen, rowStride, kChunk);
+                inQueueI.EnQue(iRaw);
+                iRaw = inQueueI.template DeQue<T>();
+                iF = RowsAsFloat(iRaw, castBufI, halfBufI, qParamBufI, i0, iCount, kLen);
+                if (checkRows) {
+                    iAllValid = CheckRows(iF, ValidRowsI(), maskBufI, iCount, kLen, c == 0);
+                }
+                if (chunkNum == 1) {
+                    residentIb = ib;
+                }
+                PDIST_PROF(prof.rows += iCount);
+            }
+
+            LocalTensor<T> jRaw = inQueueJ.template AllocTensor<T>();
+            CopyRowsMapped<T>(jRaw, xGm, rowMap, j0, jCount, k0, kLen, rowStride, kChunk);
+            inQueueJ.EnQue(jRaw);
+            jRaw = inQueueJ.template DeQue<T>();
+            LocalTensor<float> jF = RowsAsFloat(jRaw, castBufJ, halfBufJ, qParamBufJ, j0, jCount, kLen);
+            if (checkRows) {
+                jAllValid = CheckRows(jF, ValidRowsJ(), maskBufJ, jCount, kLen, c == 0);
+            }
+            PDIST_PROF(prof.Lap(prof.copyInCycles));
+
+            // 需要逐 pair 加掩码的 tile 不走按行打包
+            if (rowPacked && !MaskPairs()) {
+                AccumulatePacked(iF, jF, i0, iCount, j0, jCount, diagonal);
+            } else {
+                AccumulateChunk(iF, jF, i0, iCount, j0, jCount, kLenAligned, c == 0, diagonal);
+            }
+            PDIST_PROF(prof.Lap(prof.computeCycles));
+
+            inQueueJ.FreeTensor(jRaw);
+            if (residentIb != ib) {
+                inQueueI.FreeTensor(iRaw);
+            }
+        }
+
+        WriteBlock(i0, iCount, j0, jCount, diagonal);
+        if (hasValidity && ib == 0) {
+            WriteValidity(j0, jCount);
+        }
+        PDIST_PROF(prof.Lap(prof.copyOutCycles));
+    }
+
+    __aicore__ inline LocalTensor<float> ValidRowsI() {
+        return rowValidBuf.Get<float>();
+    }
+
+    __aicore__ inline LocalTensor<float> ValidRowsJ() {
+        return rowValidBuf.Get<float>()[(blockRows + 7) / 8 * 8];
+    }
+
+    // ignore-dimension 下当前 tile 含坏行时，涉及坏行的 pair 需先对 diff 加掩码
+    __aicore__ inline bool MaskPairs() {
+        return nanPolicy == PDIST_NAN_IGNORE_DIM && !(iAllValid && jAllValid);
+    }
+
+    // 逐行检查搬入的一段是否全为有限值: x - x 对有限值为 0、对 NaN / ±Inf 为 NaN，行和不为 0 即含非有限值；
+    // 结果与此前各段取与，记在 valid[r] (1 / 0)，返回这些行是否全部有效
+    // ignore-dimension 下对 (累计) 无效的行生成本段的逐元素掩码 (有限为 1，否则为 0) 并把非有限值置 0，
+    // 只有坏行走 Scalar 逐元素处理
+    __aicore__ inline bool CheckRows(LocalTensor<float>& rowsF, LocalTensor<float> valid,
+                                     TBuf<TPosition::VECCALC>& maskBuf, uint32_t rows, uint32_t kLen,
+                                     bool firstChunk) {
+        LocalTensor<float> diff = diffBuf.Get<float>();
+        LocalTensor<float> work = workBuf.Get<float>();
+        LocalTensor<float> red = reduceBuf.Get<float>();
+        bool allValid = true;
+        bool masked = false;
+        for (uint32_t r = 0; r < rows; ++r) {
+            LocalTensor<float> row = rowsF[r * kChunk];
+            Sub(diff, row, row, kLen);
+            float residue = PdistMetricReduce<PdistMetricL1>(diff, red, work, kLen, 1.0f);
+            bool rowValid = (residue == 0.0f) && (firstChunk || valid.GetValue(r) != 0.0f);
+            valid.SetValue(r, rowValid ? 1.0f : 0.0f);
+            allValid = allValid && rowValid;
+            if (!rowValid && nanPolicy == PDIST_NAN_IGNORE_DIM) {
+                LocalTensor<float> mask = maskBuf.Get<float>()[r * kChunk];
+                for (uint32_t k = 0; k < kChunk; ++k) {
+                    bool finite = PdistIsFinite(row.GetValue(k));
+                    if (!finite) {
+                        row.SetValue(k, 0.0f);
+                    }
+                    mask.SetValue(k, finite ? 1.0f : 0.0f);
+                }
+                masked = true;
+            }
+        }
+        if (masked) {
+            event_t eventSV = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::S_V));
+            SetFlag<HardEvent::S_V>(eventSV);
+            WaitFlag<HardEvent::S_V>(eventSV);
+        }
+        return allValid;
+    }
+
+    // 位图按 j 块写出: 第 0 个 i 块与每个 j 块恰好组成一个 tile (n >= 2)，其 j 行已跨全部段检查；
+    // j0 为 8 的倍数，各 tile 写互不重叠的整字节
+    __aicore__ inline void WriteValidity(uint32_t j0, uint32_t jCount) {
+        LocalTensor<float> jValid = ValidRowsJ();
+        LocalTensor<uint8_t> bits = bitsBuf.Get<uint8_t>();
+        uint32_t bytes = (jCount + 7) / 8;
+        for (uint32_t b = 0; b < bytes; ++b) {
+            uint32_t v = 0;
+            for (uint32_t bit = 0; bit < 8 && b * 8 + bit < jCount; ++bit) {
+                if (jValid.GetValue(b * 8 + bit) != 0.0f) {
+                    v |= (1U << bit);
+                }
+            }
+            bits.SetValue(b, static_cast<uint8_t>(v));
+        }
+        event_t eventSMte3 = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::S_MTE3));
+        SetFlag<HardEvent::S_MTE3>(eventSMte3);
+        WaitFlag<HardEvent::S_MTE3>(eventSMte3);
+        DataCopyExtParams copyParams{1, bytes, 0, 0, 0};
+        DataCopyPad(validGm[j0 / 8], bits, copyParams);
+        // 下一次写位图前 Scalar 需等本次搬出完成
+        event_t eventMte3S = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE3_S));
+        SetFlag<HardEvent::MTE3_S>(eventMte3S);
+        WaitFlag<HardEvent::MTE3_S>(eventMte3S);
+    }
+
+    // 搬入的 rows 行 (每行 kChunk 个元素，有效 kLen 个) 转成 float
+    // int8: Cast 到 half 再到 float，之后逐行 (q - zp) * scale；只处理前 kLen 个，补零部分保持为 0
+    __aicore__ inline LocalTensor<float> RowsAsFloat(LocalTensor<T>& raw, TBuf<TPosition::VECCALC>& castBuf,
+                                                     TBuf<TPosition::VECCALC>& halfBuf,
+                                                     TBuf<TPosition::VECCALC>& qParamBuf, uint32_t row0,
+                                                     uint32_t rows, uint32_t kLen) {
+        if constexpr (IsSameType<T, int8_t>::value) {
+            uint32_t paramStride = (rows * sizeof(float) + 31) / 32 * 32 / sizeof(float);
+            LocalTensor<float> scaleLocal = qParamBuf.Get<float>();
+            LocalTensor<int32_t> zpLocal = qParamBuf.Get<int32_t>()[paramStride];
+            DataCopyExtParams paramParams{1, static_cast<uint32_t>(rows * sizeof(float)), 0, 0, 0};
+            DataCopyPad(scaleLocal, scaleGm[row0], paramParams, DataCopyPadExtParams<float>{false, 0, 0, 0.0f});
+            if (hasZeroPoint) {
+                DataCopyPad(zpLocal, zeroPointGm[row0], paramParams, DataCopyPadExtParams<int32_t>{false, 0, 0, 0});
+            }
+
+            LocalTensor<half> rowsH = halfBuf.Get<half>();
+            LocalTensor<float> rowsF = castBuf.Get<float>();
+            Cast(rowsH, raw, RoundMode::CAST_NONE, rows * kChunk);
+            Cast(rowsF, rowsH, RoundMode::CAST_NONE, rows * kChunk);
+
+            event_t eventMte2S = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::MTE2_S));
+            SetFlag<HardEvent::MTE2_S>(eventMte2S);
+            WaitFlag<HardEvent::MTE2_S>(eventMte2S);
+            for (uint32_t r = 0; r < rows; ++r) {
+                LocalTensor<float> row = rowsF[r * kChunk];
+                if (hasZeroPoint) {
+                    Adds(row, row, -static_cast<float>(zpLocal.GetValue(r)), kLen);
+                }
+                Muls(row, row, scaleLocal.GetValue(r), kLen);
+            }
+            return rowsF;
+        } else {
+            return RowAsFloat<T>(raw, castBuf, rows * kChunk);
+        }
+    }
+
+    // 块内第 ii 个 i 行的第一个有效 j 下标 (j > i)；非对角 tile 恒为 0
+    __aicore__ inline uint32_t FirstValidCol(uint32_t i, uint32_t j0, bool diagonal) {
+        return (diagonal && i + 1 > j0) ? (i + 1 - j0) : 0;
+    }
+
+    // 累加器中第 ii 行从其第一个有效 j 开始连续存放，保证写回时行首 32B 对齐
+    // 跨段求和的舍入误差记在同样布局的补偿累加器中 (p = inf 取 Max，无舍入，不使用)
+    __aicore__ inline void AccumulateChunk(LocalTensor<float>& iF, LocalTensor<float>& jF, uint32_t i0,
+                                           uint32_t iCount, uint32_t j0, uint32_t jCount, uint32_t len,
+                                           bool firstChunk, bool diagonal) {
+        LocalTensor<float> acc = accBuf.Get<float>();
+        LocalTensor<float> comp = compBuf.Get<float>();
+        LocalTensor<float> diff = diffBuf.Get<float>();
+        LocalTensor<float> work = workBuf.Get<float>();
+        LocalTensor<float> red = reduceBuf.Get<float>();
+        bool maskPairs = MaskPairs();
+
+        for (uint32_t ii = 0; ii < iCount; ++ii) {
+            uint32_t first = FirstValidCol(i0 + ii, j0, diagonal);
+            LocalTensor<float> rowI = iF[ii * kChunk];
+            for (uint32_t jj = first; jj < jCount; ++jj) {
+                LocalTensor<float> rowJ = jF[jj * kChunk];
+                float partial = maskPairs ? MaskedPartial(rowI, rowJ, ii, jj, len)
+                                          : PdistMetricPartial<Metric>(rowI, rowJ, diff, red, work, len, p);
+                uint32_t idx = ii * blockCols + (jj - first);
+                if (firstChunk) {
+                    acc.SetValue(idx, partial);
+                    comp.SetValue(idx, 0.0f);
+                } else if constexpr (Metric::MAX_COMBINE) {
+                    float prev = acc.GetValue(idx);
+                    acc.SetValue(idx, (partial > prev) ? partial : prev);
+                } else {
+                    float sum = acc.GetValue(idx);
+                    float c = comp.GetValue(idx);
+                    KahanAdd(sum, c, partial);
+                    acc.SetValue(idx, sum);
+                    comp.SetValue(idx, c);
+                }
+                PDIST_PROF(if (firstChunk) prof.pairs++);
+            }
+        }
+    }
+
+    // mark-row: 坏行参与的 pair 输出 NaN；i 行无效时整行填充，否则只改写无效的 j 列 (坏行少见，走 Scalar)
+    __aicore__ inline void MarkInvalidPairs(LocalTensor<float>& accRow, uint32_t ii, uint32_t first, uint32_t cnt) {
+        if (ValidRowsI().GetValue(ii) == 0.0f) {
+            Duplicate(accRow, PdistQuietNaN(), cnt);
+            return;
+        }
+        LocalTensor<float> jValid = ValidRowsJ();
+        event_t eventVS = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::V_S));
+        SetFlag<HardEvent::V_S>(eventVS);
+        WaitFlag<HardEvent::V_S>(eventVS);
+        for (uint32_t jj = 0; jj < cnt; ++jj) {
+            if (jValid.GetValue(first + jj) == 0.0f) {
+                accRow.SetValue(jj, PdistQuietNaN());
+            }
+        }
+        event_t eventSV = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::S_V));
+        SetFlag<HardEvent::S_V>(eventSV);
+        WaitFlag<HardEvent::S_V>(eventSV);
+    }
+
+    // ignore-dimension: 坏行一侧的 diff 乘以其掩码，非有限维度 (值已置 0) 不计入该 pair
+    __aicore__ inline float MaskedPartial(LocalTensor<float>& rowI, LocalTensor<float>& rowJ, uint32_t ii,
+                                          uint32_t jj, uint32_t len) {
+        LocalTensor<float> diff = diffBuf.Get<float>();
+        Sub(diff, rowI, rowJ, len);
+        if (ValidRowsI().GetValue(ii) == 0.0f) {
+            LocalTensor<float> maskI = maskBufI.Get<float>()[ii * kChunk];
+            Mul(diff, diff, maskI, len);
+        }
+        if (ValidRowsJ().GetValue(jj) == 0.0f) {
+            LocalTensor<float> maskJ = maskBufJ.Get<float>()[jj * kChunk];
+            Mul(diff, diff, maskJ, len);
+        }
+        LocalTensor<float> work = workBuf.Get<float>();
+        LocalTensor<float> red = reduceBuf.Get<float>();
+        return PdistMetricReduce<Metric>(diff, red, work, len, p);
+    }
+
+    // 单段且每行不超过一个 repeat 时，一个 i 行对本块全部有效 j 行只需一条 Sub、一组逐元素变换和一条分段归约，
+    // 部分结果由 Vector 直接写入累加器行首 (对角 tile 从 first 行起，jF[first * kChunk] 仍是 32B 对齐)
+    // 行内补零部分两侧均为 0，按 kChunk 整行参与计算不影响结果
+    __aicore__ inline void AccumulatePacked(LocalTensor<float>& iF, LocalTensor<float>& jF, uint32_t i0,
+                                            uint32_t iCount, uint32_t j0, uint32_t jCount, bool diagonal) {
+        LocalTensor<float> acc = accBuf.Get<float>();
+        LocalTensor<float> diff = diffBuf.Get<float>();
+        LocalTensor<float> work = workBuf.Get<float>();
+
+        for (uint32_t ii = 0; ii < iCount; ++ii) {
+            uint32_t first = FirstValidCol(i0 + ii, j0, diagonal);
+            if (first >= jCount) continue;
+            LocalTensor<float> rowI = iF[ii * kChunk];
+            LocalTensor<float> rowsJ = jF[first * kChunk];
+            LocalTensor<float> accRow = acc[ii * blockCols];
+            PdistMetricRows<Metric>(accRow, rowI, rowsJ, diff, work, kChunk, jCount - first, p);
+            PDIST_PROF(prof.pairs += jCount - first);
+        }
+    }
+
+    __aicore__ inline void WriteBlock(uint32_t i0, uint32_t iCount, uint32_t j0, uint32_t jCount, bool diagonal) {
+        LocalTensor<float> acc = accBuf.Get<float>();
+        // 累加器由 Scalar 写入 (按行打包时由 Vector 写入，同步无副作用)，Vector 读取前同步
+        event_t eventSV = static_cast<event_t>(GetTPipePtr()->FetchEventID(HardEvent::S_V));
+        SetFlag<HardEvent::S_V>(eventSV);
+        WaitFlag<HardEvent::S_V>(eventSV);
+
+        for (uint32_t ii = 0; ii < iCount; ++ii) {
+            uint32_t i = i0 + ii;
+            uint32_t first = FirstValidCol(i, j0, diagonal);
+            if (first >= jCount) continue;
+            uint32_t cnt = jCount - first;
+
+            LocalTensor<float> accRow = acc[ii * blockCols];
+            if constexpr (!Metric::MAX_COMBINE) {
+                if (chunkNum > 1) {
+                    LocalTensor<float> compRow = compBuf.Get<float>()[ii * blockCols];
+                    Add(accRow, accRow, compRow, cnt);
+                }
+            }
+            Metric::Finalize(accRow, cnt, p);
+            if (nanPolicy == PDIST_NAN_MARK_ROW && !(iAllValid && jAllValid)) {
+                MarkInvalidPairs(accRow, ii, first, cnt);
+            }
+
+            LocalTensor<TOut> yLocal = outQueue.template AllocTensor<TOut>();
+            if constexpr (IsSameType<TOut, float>::value) {
+                Adds(yLocal, accRow, 0.0f, cnt);
+            } else {
+                Cast(yLocal, accRow, RoundMode::CAST_ROUND, cnt);
+            }
+            outQueue.EnQue(yLocal);
+            yLocal = outQueue.template DeQue<TOut>();
+
+            // 第 i 行的 [j0 + first, j0 + jCount) 在压缩输出中是连续的一段
+            uint64_t outIdx = (uint64_t)(2 * n - 1 - i) * i / 2 + (j0 + first - i - 1);
+            DataCopyExtParams copyParams{1, static_cast<uint32_t>(cnt * sizeof(TOut)), 0, 0, 0};
+            DataCopyPad(yGm[outIdx], yLocal, copyParams);
+            outQueue.FreeTensor(yLocal);
+        }
+    }
+
+private:
+    TPipe pipe;
+    TQue<QuePosition::VECIN, 1> inQueueI;
+    TQue<QuePosition::VECIN, BUFFER_NUM> inQueueJ;
+    TQue<QuePosition::VECOUT, BUFFER_NUM> outQueue;
+    TBuf<TPosition::VECCALC> castBufI, castBufJ;
+    TBuf<TPosition::VECCALC> halfBufI, halfBufJ, qParamBufI, qParamBufJ;
+    TBuf<TPosition::VECCALC> diffBuf, workBuf, reduceBuf, accBuf, compBuf;
+    TBuf<TPosition::VECCALC> rowValidBuf, bitsBuf, maskBufI, maskBufJ;
+
+    GlobalTensor<T> xGm;
+    GlobalTensor<TOut> yGm;
+    PdistRowMap rowMap;
+    GlobalTensor<float> scaleGm;
+    GlobalTensor<int32_t> zeroPointGm;
+    GlobalTensor<int32_t> tileCounterGm;
+    GlobalTensor<uint8_t> validGm;
+    GM_ADDR profRegion;
+#ifdef PDIST_PROFILE
+    PdistProfiler prof;
+#endif
+
+    uint32_t n, m;
+    uint32_t rowStride; // 视图输入的行跨度 (>= m)，行首地址按它计算
+    float p;
+    bool hasZeroPoint;
+    uint32_t totalCoreNum;
+    uint32_t coreId;
+    uint32_t blockRows, blockCols;
+    uint32_t kChunk, chunkNum;
+    uint32_t bandBlocks, panelBlocks;
+    uint32_t schedMode;
+    bool rowPacked;
+    uint32_t nanPolicy;
+    bool checkRows, hasValidity = false;
+    bool iAllValid, jAllValid; // 当前 i 块 / j 块的行是否全部有效 (i 块常驻时沿用)
+    uint32_t iBlockNum, jBlockNum;
+
+    // tile 游标 (j panel 范围、行带起点、列、列内偏移) 与常驻 UB 的 i 块 (residentIb == iBlockNum 表示无)
+    uint32_t panelStart, panelEnd;
+    uint32_t bandStart, colJb, colIdx;
+    uint32_t residentIb;
+    LocalTensor<T> iRaw;
+    LocalTensor<float> iF;
+};
+
+// 以 Metric 实例化并运行 Vector kernel；indices / valid / scale / zeroPoint 为空时不使用
+// (见 SetRowIndices / SetValidityOutput / Init)
+template <typename T, typename Metric, typename TOut = T>
+__aicore__ inline void RunPdistVector(GM_ADDR x, GM_ADDR indices, GM_ADDR y, GM_ADDR valid, GM_ADDR usrWorkspace,
+                                      const KernelTilingData* tData, GM_ADDR scale = nullptr,
+                                      GM_ADDR zeroPoint = nullptr) {
+    KernelPdist<T, Metric, TOut> op;
+    op.SetRowIndices(indices, tData->indexSize);
+    op.SetValidityOutput(valid);
+    op.Init(x, y, usrWorkspace, tData, scale, zeroPoint);
+    op.Process();
+}
+
+#endif // PDIST_VECTOR_H
@@ -0,0 +1,519 @@
+/**
+ * @file pdist_cpu_sim.cpp
+ * @brief CPU simulation (ICPU_RUN_KF) regression test for KernelPdist
+ *
+ * Every case is tiled by PlanPdistTiling (the rules TilingFunc uses), checked for tiling and
+ * load-balance invariants, run on the Ascend C CPU debug library and compared with cpu_pdist.
+ * Built once per element type (DTYPE_X = float / half), see CMakeLists.txt. The int8 build
+ * (PDIST_CPU_SIM_QUANT) runs PdistQuant on per-row quantised input against the dequantised golden.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <set>
+#include <vector>
+#include "tikicpulib.h"
+#include "tiling/platform/platform_ascendc.h"
+#include "pdist_tiling.h"
+#include "pdist_golden.h"
+
+#ifdef PDIST_CPU_SIM_QUANT
+extern "C" __global__ __aicore__ void pdist_quant(GM_ADDR x, GM_ADDR scale, GM_ADDR zero_point, GM_ADDR y,
+                                                  GM_ADDR workspace, GM_ADDR tiling);
+#else
+extern "C" __global__ __aicore__ void pdist(GM_ADDR x, GM_ADDR indices, GM_ADDR y, GM_ADDR valid,
+                                            GM_ADDR workspace, GM_ADDR tiling);
+#endif
+
+namespace {
+
+using ElemT = DTYPE_X;
+using OutT = DTYPE_Y;
+
+// 仿真目标平台参数 (Ascend910B1)
+constexpr uint32_t SIM_CORE_NUM_AIC = 24;
+constexpr uint32_t SIM_CORE_NUM_AIV = 48;
+constexpr uint64_t SIM_SYS_WORKSPACE_SIZE = 16 * 1024 * 1024;
+constexpr uint64_t SIM_UB_SIZE = 192 * 1024;
+constexpr uint64_t SIM_L2_SIZE = 192ULL * 1024 * 1024;
+
+// 当前 TilingFunc 可能产生的全部 tilingKey，每个都至少要被一个用例覆盖
+const std::set<uint32_t> KNOWN_TILING_KEYS = {
+    optiling::PDIST_TILING_KEY_VECTOR,      optiling::PDIST_TILING_KEY_GRAM,
+    optiling::PDIST_TILING_KEY_VECTOR_L1,   optiling::PDIST_TILING_KEY_VECTOR_L2,
+    optiling::PDIST_TILING_KEY_VECTOR_LINF, optiling::PDIST_TILING_KEY_VECTOR_INT_P,
+};
+
+struct SimCase {
+    uint32_t n;
+    uint32_t m;
+    float p;
+    // 非 0 时作为调优参数传给 PlanPdistTiling: Bi, Bj, kChunk, bufferNum, coreNum[, schedMode]
+    optiling::PdistBlockParams preset;
+    // 非 0 时代替 SIM_L2_SIZE，用小 L2 强制把 j 方向切成多个 panel
+    uint64_t l2Size;
+    // 非 0 时 x 为更宽矩阵的特征切片 (行跨度 rowStride > m)，行间空隙填入不应被读到的值
+    uint32_t rowStride;
+    // 非 0 时带 indices (int32: 4, int64: 8)，从 2n + 5 行的 x 中乱序选出 n 行 (PdistQuant 无此输入，跳过)
+    uint32_t indexSize;
+    // nan_policy (PdistNanPolicy)、写入 NaN / ±Inf 的行数，以及是否带 valid 位图输出 (PdistQuant 无这些，跳过)
+    uint32_t nanPolicy;
+    uint32_t badRows;
+    uint32_t validityOut;
+};
+
+const float P_INF = std::numeric_limits<float>::infinity();
+
+const SimCase SIM_CASES[] = {
+    // 单核路径 (n < 核数)
+    {2, 8, 2.0f},
+    {5, 8, 2.0f},
+    {7, 13, 1.0f},
+    // 多核 Cyclic，n 恰为 / 不为核数整数倍 (AIV 48 核)
+    {48, 64, 2.0f},
+    {96, 64, 2.0f},
+    {61, 33, 1.0f},
+    // p = inf 与通用 p
+    {37, 31, P_INF},
+    {40, 16, 3.0f},
+    {29, 7, 0.5f},
+    // m 不满 32B 对齐，尾部补零
+    {33, 1, 2.0f},
+    {26, 100, 2.0f},
+    // m 超过一段 (kChunk)，多段累加
+    {30, 3000, 2.0f},
+    {30, 3000, P_INF},
+    // 长行 (数万维): 十余段的跨段补偿求和，按 1e-5 与 double golden 比较
+    {12, 24000, 1.0f},
+    {12, 24000, 3.0f},
+    // 调优参数: Bi != Bj、单缓冲、小 kChunk 多段、限定核数
+    {45, 40, 2.0f, {5, 8, 16, 1, 4}},
+    {45, 40, 1.0f, {3, 16, 16, 2, 0}},
+    {50, 77, 3.0f, {16, 8, 32, 2, 7}},
+    // 多个行带: 对角 / 非对角 tile、核间 i 块切换 (单段常驻与多段重搬)
+    {200, 24, 1.0f, {8, 8, 32, 2, 4}},
+    {130, 50, P_INF, {4, 16, 16, 1, 6}},
+    // 多个 j panel (L2 放不下全部 x)
+    {200, 24, 2.0f, {8, 8, 32, 2, 4}, 8 * 1024},
+    {150, 40, 1.0f, {}, 4 * 1024},
+    // 调度方式: 单段强制动态领取、多段强制静态、动态领取跨多个 j panel
+    {200, 24, 1.0f, {8, 8, 32, 2, 4, 2}},
+    {50, 77, 3.0f, {16, 8, 32, 2, 7, 1}},
+    {150, 40, P_INF, {8, 8, 16, 2, 6, 2}, 4 * 1024},
+    // 按行打包 (单段且 kChunk <= 64): 行长一个 block 的 BlockReduce、多 block 的 WholeReduce、段长上限
+    {150, 8, P_INF},
+    {150, 50, 4.0f},
+    {100, 64, 2.0f},
+    {100, 64, 0.5f, {8, 16, 64, 2, 5}},
+    // 按行打包且 Bj > 255 (单条指令 repeat 上限): Sub / 归约分组发出，含不满一组的尾组
+    {600, 8, P_INF, {8, 264, 32, 1, 0}},
+    {600, 24, 1.0f, {8, 256, 32, 1, 0}},
+    // 调优参数的 kChunk 大于对齐后的 m: 截短后落入行打包布局，按截短后的值校验 (放不下时退回启发式)
+    {300, 64, 2.0f, {8, 256, 128, 1, 0}},
+    {100, 40, 3.0f, {8, 16, 512, 2, 0}},
+    // Gram 路径 (p = 2 且规模足够): 整块 / 边缘块、m 不对齐、多段范数
+    {256, 64, 2.0f},
+    {300, 100, 2.0f},
+    {260, 2100, 2.0f},
+    // 视图输入 (行跨度 > m): Vector 路径单段 / 多段、Gram 路径
+    {40, 13, 1.0f, {}, 0, 20},
+    {30, 3000, P_INF, {}, 0, 3017},
+    {256, 64, 2.0f, {}, 0, 100},
+    // 行子集 (indices): int32 / int64，Vector 路径多段、Gram 路径 (选中行写成连续副本)
+    {50, 24, 1.0f, {}, 0, 0, 4},
+    {30, 3000, 3.0f, {}, 0, 40 + 3000, 8},
+    {260, 100, 2.0f, {}, 0, 0, 4},
+    // nan_policy 与有效性位图: 单段 (按行打包的 tile 含坏行时逐 pair 加掩码) / 多段 / 带 indices，
+    // mark-row 的 p = inf 与 Gram 规模 (退回 Vector kernel)，以及 propagate 下无坏行的位图
+    {60, 40, 2.0f, {}, 0, 0, 0, optiling::PDIST_NAN_IGNORE_DIM, 5, 1},
+    {40, 3000, 1.0f, {}, 0, 0, 0, optiling::PDIST_NAN_IGNORE_DIM, 3, 1},
+    {50, 24, 3.0f, {}, 0, 0, 4, optiling::PDIST_NAN_IGNORE_DIM, 4, 0},
+    {50, 24, P_INF, {}, 0, 0, 0, optiling::PDIST_NAN_MARK_ROW, 4, 1},
+    {300, 100, 2.0f, {}, 0, 0, 0, optiling::PDIST_NAN_MARK_ROW, 6, 1},
+    {45, 40, 3.0f, {}, 0, 0, 0, optiling::PDIST_NAN_PROPAGATE, 0, 1},
+    // n = 1: 没有 tile，0 号核单独搬入该行写出位图 (单段时该行常驻 UB，结束时释放)
+    {1, 40, 2.0f, {}, 0, 0, 0, optiling::PDIST_NAN_IGNORE_DIM, 1, 1},
+    {1, 3000, 1.0f, {}, 0, 0, 0, optiling::PDIST_NAN_PROPAGATE, 0, 1},
+};
+
+// Gram 路径: 上三角 Gram 块在全部 AIV 间 Cyclic 分配，统计每个 AIV 的 pair 数
+bool CheckGramPlan(const SimCase& c, const optiling::PdistTilingPlan& plan) {
+    bool ok = true;
+    uint32_t tile = optiling::PDIST_GRAM_TILE;
+    uint32_t tileNum = (c.n + tile - 1) / tile;
+    if (plan.blockRows != tile || plan.blockCols != tile || plan.usedCoreNum == 0 ||
+        plan.usedCoreNum > SIM_CORE_NUM_AIC ||
+        plan.userWorkspaceSize < optiling::PdistGramWorkspaceBytes(c.n, plan.blockDim, sizeof(ElemT))) {
+        printf("[ERROR] bad Gram plan tile=%u cores=%u workspace=%llu\n", plan.blockRows, plan.usedCoreNum,
+               (unsigned long long)plan.userWorkspaceSize);
+        ok = false;
+    }
+    uint32_t aivNum = plan.usedCoreNum * optiling::PDIST_MIX_AIV_PER_BLOCK;
+    std::vector<uint64_t> pairs(aivNum, 0);
+    uint64_t t = 0;
+    for (uint32_t ib = 0; ib < tileNum; ++ib) {
+        for (uint32_t jb = ib; jb < tileNum; ++jb, ++t) {
+            for (uint64_t i = ib * tile; i < c.n && i < (ib + 1ULL) * tile; ++i) {
+                for (uint64_t j = jb * tile; j < c.n && j < (jb + 1ULL) * tile; ++j) {
+                    pairs[t % aivNum] += (j > i) ? 1 : 0;
+                }
+            }
+        }
+    }
+    uint64_t total = 0;
+    uint64_t maxPairs = 0;
+    for (uint64_t v : pairs) {
+        total += v;
+        maxPairs = (v > maxPairs) ? v : maxPairs;
+    }
+    uint64_t expected = static_cast<uint64_t>(c.n) * (c.n - 1) / 2;
+    if (total != expected) {
+        printf("[ERROR] Gram tiles cover %llu pairs, expected %llu\n", (unsigned long long)total,
+               (unsigned long long)expected);
+        ok = false;
+    }
+    double mean = static_cast<double>(total) / aivNum;
+    printf("[INFO] Gram: blocks=%u aiv=%u tiles=%llu max/mean pairs per aiv=%.3f\n", plan.usedCoreNum, aivNum,
+           (unsigned long long)t, (mean > 0) ? maxPairs / mean : 1.0);
+    return ok;
+}
+
+// Tiling 不变量: 对齐、补零长度、核数，以及 Cyclic 分配恰好覆盖所有 pair
+bool CheckPlan(const SimCase& c, const optiling::PdistTilingInput& in, const optiling::PdistTilingPlan& plan) {
+    bool ok = true;
+    uint32_t alignElems = 32 / sizeof(ElemT);
+    if ((plan.tileLength * sizeof(ElemT)) % 32 != 0 || plan.tileLength < c.m ||
+        plan.tileLength - c.m >= alignElems) {
+        printf("[ERROR] bad tileLength %u for m=%u\n", plan.tileLength, c.m);
+        ok = false;
+    }
+    uint32_t maxCores = optiling::PdistMaxBlockDim(plan.kernelType, SIM_CORE_NUM_AIC, SIM_CORE_NUM_AIV);
+    if (plan.kernelType != optiling::PdistKernelTypeOf(plan.tilingKey)) {
+        printf("[ERROR] kernelType %u does not match tilingKey %u\n", plan.kernelType, plan.tilingKey);
+        ok = false;
+    }
+    bool expectGram = (c.preset.blockRows == 0 && plan.pClass == optiling::PDIST_P_TWO &&
+                       c.n >= optiling::PDIST_GRAM_MIN_N && c.m >= optiling::PDIST_GRAM_MIN_M &&
+                       c.nanPolicy == optiling::PDIST_NAN_PROPAGATE && c.validityOut == 0);
+    if ((plan.tilingKey == optiling::PDIST_TILING_KEY_GRAM) != expectGram) {
+        printf("[ERROR] unexpected tilingKey %u\n", plan.tilingKey);
+        return false;
+    }
+    if (plan.tilingKey == optiling::PDIST_TILING_KEY_GRAM) {
+        return ok && CheckGramPlan(c, plan);
+    }
+    // Vector kernel 按 p 选择编译期特化的实例
+    if (plan.tilingKey != optiling::PdistVectorTilingKey(c.p)) {
+        printf("[ERROR] tilingKey %u does not match the metric of p=%g\n", plan.tilingKey, c.p);
+        ok = false;
+    }
+    if (plan.usedCoreNum == 0 || plan.usedCoreNum > maxCores || plan.blockDim != plan.usedCoreNum ||
+        (plan.tileNum != 0 && plan.usedCoreNum > plan.tileNum) ||
+        (c.preset.blockRows == 0 && c.n < maxCores && plan.usedCoreNum != 1)) {
+        printf("[ERROR] bad core count usedCoreNum=%u blockDim=%u\n", plan.usedCoreNum, plan.blockDim);
+        ok = false;
+    }
+    if (plan.pClass != optiling::PdistPClassOf(c.p)) {
+        printf("[ERROR] bad pClass %u\n", plan.pClass);
+        ok = false;
+    }
+    optiling::PdistBlockParams bp = {plan.blockRows, plan.blockCols, plan.kChunk, plan.bufferNum, 0};
+    if (optiling::PdistUbBytes(bp, sizeof(ElemT), c.nanPolicy, c.validityOut) + optiling::PDIST_UB_RESERVED_BYTES >
+            SIM_UB_SIZE ||
+        plan.kChunk % (32 / sizeof(ElemT)) != 0 || plan.blockCols % 8 != 0 ||
+        static_cast<uint64_t>(plan.chunkNum) * plan.kChunk < c.m ||
+        static_cast<uint64_t>(plan.chunkNum - 1) * plan.kChunk >= c.m) {
+        printf("[ERROR] bad block params Bi=%u Bj=%u kChunk=%u chunkNum=%u\n", plan.blockRows, plan.blockCols,
+               plan.kChunk, plan.chunkNum);
+        ok = false;
+    }
+    // 调优参数对当前元素类型不合法 (如 INT8 要求 kChunk 为 32 的倍数) 时按启发式规划
+    optiling::PdistBlockParams clamped = c.preset;
+    clamped.kChunk = (clamped.kChunk < plan.tileLength) ? clamped.kChunk : plan.tileLength;
+    bool presetApplied = (c.preset.blockRows != 0 && optiling::PdistBlockParamsValid(clamped, in));
+    if (presetApplied &&
+        (plan.blockRows != c.preset.blockRows || plan.blockCols != c.preset.blockCols ||
+         plan.bufferNum != c.preset.bufferNum)) {
+        printf("[ERROR] preset block params not applied\n");
+        ok = false;
+    }
+    // 调度方式: 调优参数指定时照用 (单核退回静态)，否则多段动态、单段静态；动态时 workspace 含计数器
+    uint32_t expectSched = (plan.chunkNum > 1) ? optiling::PDIST_SCHED_DYNAMIC : optiling::PDIST_SCHED_STATIC;
+    if (presetApplied && c.preset.schedMode != optiling::PDIST_SCHED_AUTO) {
+        expectSched = c.preset.schedMode;
+    }
+    if (plan.usedCoreNum == 1) {
+        expectSched = optiling::PDIST_SCHED_STATIC;
+    }
+    if (plan.schedMode != expectSched ||
+        (plan.schedMode == optiling::PDIST_SCHED_DYNAMIC &&
+         plan.userWorkspaceSize < optiling::PDIST_SCHED_COUNTER_BYTES)) {
+        printf("[ERROR] bad schedMode %u (expected %u) workspace=%llu\n", plan.schedMode, expectSched,
+               (unsigned long long)plan.userWorkspaceSize);
+        ok = false;
+    }
+
+    // 按 kernel 的 tile 顺序与 Cyclic 规则统计每核 pair 数 (动态调度时仅作参考)，并检查对角标记与 tile 总数
+    std::vector<uint64_t> pairs(plan.usedCoreNum, 0);
+    std::vector<uint32_t> cover(static_cast<size_t>(c.n) * c.n, 0);
+    uint64_t t = 0;
+    optiling::PdistForEachTileColumn(plan, [&](uint32_t bandStart, uint32_t jb, uint32_t count) {
+        for (uint32_t ib = bandStart; ib < bandStart + count; ++ib, ++t) {
+            bool masked = false;
+            for (uint64_t i = ib * plan.blockRows; i < c.n && i < (ib + 1ULL) * plan.blockRows; ++i) {
+                for (uint64_t j = jb * plan.blockCols; j < c.n && j < (jb + 1ULL) * plan.blockCols; ++j) {
+                    if (j > i) {
+                        pairs[t % plan.usedCoreNum]++;
+                        cover[i * c.n + j]++;
+                    } else {
+                        masked = true;
+                    }
+                }
+            }
+            if (masked != optiling::PdistTileIsDiagonal(ib, jb, c.n, plan.blockRows, plan.blockCols)) {
+                printf("[ERROR] tile (%u, %u) diagonal flag mismatch\n", ib, jb);
+                ok = false;
+            }
+        }
+    });
+    if (t != plan.tileNum) {
+        printf("[ERROR] enumerated %llu tiles, plan has %u\n", (unsigned long long)t, plan.tileNum);
+        ok = false;
+    }
+    for (uint64_t i = 0; i < c.n; ++i) {
+        for (uint64_t j = i + 1; j < c.n; ++j) {
+            if (cover[i * c.n + j] != 1) {
+                printf("[ERROR] pair (%llu, %llu) covered %u times\n", (unsigned long long)i, (unsigned long long)j,
+                       cover[i * c.n + j]);
+                ok = false;
+                i = c.n;
+                break;
+            }
+        }
+    }
+    uint64_t total = 0;
+    uint64_t maxPairs = 0;
+    for (uint64_t v : pairs) {
+        total += v;
+        maxPairs = (v > maxPairs) ? v : maxPairs;
+    }
+    uint64_t expected = static_cast<uint64_t>(c.n) * (c.n - 1) / 2;
+    if (total != expected) {
+        printf("[ERROR] cyclic split covers %llu pairs, expected %llu\n", (unsigned long long)total,
+               (unsigned long long)expected);
+        ok = false;
+    }
+    double mean = static_cast<double>(total) / plan.usedCoreNum;
+    printf("[INFO] cores=%u Bi=%u Bj=%u kChunk=%u x%u buffers=%u tiles=%u band=%u panel=%u sched=%u "
+           "packed=%d tilingKey=%u max/mean pairs per core=%.3f\n",
+           plan.usedCoreNum, plan.blockRows, plan.blockCols, plan.kChunk, plan.chunkNum, plan.bufferNum,
+           plan.tileNum, plan.bandBlocks, plan.panelBlocks, plan.schedMode, optiling::PdistRowPacked(plan) ? 1 : 0,
+           plan.tilingKey, (mean > 0) ? maxPairs / mean : 1.0);
+    return ok;
+}
+
+const char* TypeName() {
+    return (sizeof(ElemT) == 4) ? "FP32" : ((sizeof(ElemT) == 2) ? "FP16" : "INT8");
+}
+
+bool RunCase(const SimCase& c, size_t caseIdx, std::set<uint32_t>& coveredKeys) {
+    printf(">>> CPU sim: N=%u, M=%u, P=%g, Type=%s, RowStride=%u, IndexBytes=%u\n", c.n, c.m, c.p, TypeName(),
+           (c.rowStride != 0) ? c.rowStride : c.m, c.indexSize);
+#ifdef PDIST_CPU_SIM_QUANT
+    if (c.indexSize != 0 || c.nanPolicy != optiling::PDIST_NAN_PROPAGATE || c.validityOut != 0) {
+        printf("[SKIP] PdistQuant has no indices input, nan_policy or valid output\n");
+        return true;
+    }
+#endif
+
+    optiling::PdistTilingInput in;
+    in.n = c.n;
+    in.m = c.m;
+    in.p = c.p;
+    in.typeSize = sizeof(ElemT);
+    in.coreNumAic = SIM_CORE_NUM_AIC;
+    in.coreNumAiv = SIM_CORE_NUM_AIV;
+    in.ubSize = SIM_UB_SIZE;
+    in.l2Size = (c.l2Size != 0) ? c.l2Size : SIM_L2_SIZE;
+    in.rowStride = c.rowStride;
+    in.indexSize = c.indexSize;
+    in.nanPolicy = c.nanPolicy;
+    in.validityOut = c.validityOut;
+    optiling::PdistTilingPlan plan =
+        optiling::PlanPdistTiling(in, (c.preset.blockRows != 0) ? &c.preset : nullptr);
+    if (!CheckPlan(c, in, plan)) {
+        return false;
+    }
+    coveredKeys.insert(plan.tilingKey);
+
+    optiling::PdistTilingData tilingData;
+    optiling::FillPdistTilingData(plan, tilingData);
+    if (plan.tilingKey == optiling::PDIST_TILING_KEY_GRAM) {
+        platform_ascendc::PlatformAscendC* platform =
+            platform_ascendc::PlatformAscendCManager::GetInstance(PDIST_CPU_SIM_SOC_NAME);
+        if (platform == nullptr || !optiling::FillPdistCubeTiling(plan, in.typeSize, *platform, tilingData)) {
+            printf("[ERROR] Matmul tiling failed\n");
+            return false;
+        }
+    }
+    size_t tilingSize = tilingData.GetDataSize();
+
+    uint64_t inputNum = static_cast<uint64_t>(c.n) * c.m;
+    uint64_t xRows = (c.indexSize != 0) ? 2ULL * c.n + 5 : c.n;
+    uint64_t storageNum = xRows * plan.rowStride;
+    uint64_t outputNum = static_cast<uint64_t>(c.n) * (c.n - 1) / 2;
+    uint8_t* x = (uint8_t*)AscendC::GmAlloc(storageNum * sizeof(ElemT));
+    uint8_t* y = (uint8_t*)AscendC::GmAlloc((outputNum + 1) * sizeof(OutT));
+    uint8_t* workspace = (uint8_t*)AscendC::GmAlloc(SIM_SYS_WORKSPACE_SIZE + plan.userWorkspaceSize);
+    uint8_t* tiling = (uint8_t*)AscendC::GmAlloc(tilingSize);
+    tilingData.SaveToBuffer(tiling, tilingSize);
+
+    // 输入先在 float 上生成，golden 用量化后的值计算，排除输入舍入误差
+    std::mt19937 gen(2023);
+    ElemT* xT = reinterpret_cast<ElemT*>(x);
+    std::vector<float> xF(inputNum);
+    // 行间空隙 (视图外的列) 填入固定值 100，若被 kernel 读到会使结果明显偏离
+    for (uint64_t k = 0; k < storageNum; ++k) {
+        xT[k] = static_cast<ElemT>(100);
+    }
+#ifdef PDIST_CPU_SIM_QUANT
+    // int8 码值 + 每行 scale；奇数号用例带 zero point (非对称量化)，偶数号不传 (对称量化)
+    bool withZeroPoint = (caseIdx % 2 == 1);
+    uint8_t* scale = (uint8_t*)AscendC::GmAlloc(c.n * sizeof(float));
+    uint8_t* zeroPoint = withZeroPoint ? (uint8_t*)AscendC::GmAlloc(c.n * sizeof(int32_t)) : nullptr;
+    float* scaleF = reinterpret_cast<float*>(scale);
+    int32_t* zpI = reinterpret_cast<int32_t*>(zeroPoint);
+    std::uniform_int_distribution<int> qDis(-127, 127);
+    std::uniform_int_distribution<int> zpDis(-20, 20);
+    std::uniform_real_distribution<float> scaleDis(0.01f, 0.1f);
+    for (uint32_t i = 0; i < c.n; ++i) {
+        scaleF[i] = scaleDis(gen);
+        int32_t zp = withZeroPoint ? zpDis(gen) : 0;
+        if (withZeroPoint) {
+            zpI[i] = zp;
+        }
+        for (uint64_t k = 0; k < c.m; ++k) {
+            ElemT q = static_cast<ElemT>(qDis(gen));
+            xT[i * plan.rowStride + k] = q;
+            xF[i * c.m + k] = scaleF[i] * static_cast<float>(q - zp);
+        }
+    }
+#else
+    (void)caseIdx;
+    std::uniform_real_distribution<float> dis(-10.0f, 10.0f);
+    for (uint64_t r = 0; r < xRows; ++r) {
+        for (uint64_t k = 0; k < c.m; ++k) {
+            xT[r * plan.rowStride + k] = static_cast<ElemT>(dis(gen));
+        }
+    }
+    // 第 i 个点取 x 的第 rowOf[i] 行: 无 indices 时为 i，否则为乱序选出的行
+    std::vector<uint64_t> rowOf(xRows);
+    std::iota(rowOf.begin(), rowOf.end(), 0);
+    uint8_t* indices = nullptr;
+    if (c.indexSize != 0) {
+        std::shuffle(rowOf.begin(), rowOf.end(), gen);
+        indices = (uint8_t*)AscendC::GmAlloc(c.n * c.indexSize);
+        for (uint32_t i = 0; i < c.n; ++i) {
+            if (c.indexSize == sizeof(int64_t)) {
+                reinterpret_cast<int64_t*>(indices)[i] = static_cast<int64_t>(rowOf[i]);
+            } else {
+                reinterpret_cast<int32_t*>(indices)[i] = static_cast<int32_t>(rowOf[i]);
+            }
+        }
+    }
+    // 坏行: 第 r 个坏行在两三个维度写入 NaN / +Inf / -Inf (同一维度可能被多个坏行命中)
+    const float badValues[] = {std::numeric_limits<float>::quiet_NaN(), std::numeric_limits<float>::infinity(),
+                               -std::numeric_limits<float>::infinity()};
+    for (uint32_t r = 0; r < c.badRows; ++r) {
+        uint64_t i = (r * 7ULL + 3) % c.n;
+        for (uint32_t h = 0; h <= r % 3; ++h) {
+            uint64_t k = (r * 13ULL + h * 5) % c.m;
+            xT[rowOf[i] * plan.rowStride + k] = static_cast<ElemT>(badValues[(r + h) % 3]);
+        }
+    }
+    for (uint64_t i = 0; i < c.n; ++i) {
+        for (uint64_t k = 0; k < c.m; ++k) {
+            xF[i * c.m + k] = static_cast<float>(xT[rowOf[i] * plan.rowStride + k]);
+        }
+    }
+    uint64_t validBytes = optiling::PdistValidityBytes(c.n);
+    uint8_t* valid = nullptr;
+    if (c.validityOut != 0) {
+        valid = (uint8_t*)AscendC::GmAlloc(validBytes);
+        std::fill(valid, valid + validBytes, 0xA5);
+    }
+#endif
+    std::vector<float> yRefF(outputNum + 1);
+    cpu_pdist<float>(xF.data(), yRefF.data(), c.n, c.m, c.p, static_cast<int>(c.nanPolicy));
+    std::vector<OutT> yRef(outputNum + 1);
+    for (uint64_t k = 0; k < outputNum; ++k) {
+        yRef[k] = static_cast<OutT>(yRefF[k]);
+    }
+
+    // Gram 路径为 1 AIC + 2 AIV 的混合 kernel
+    bool mix = (plan.kernelType == optiling::PDIST_KERNEL_MIX_AIC_1_2);
+    AscendC::SetKernelMode(mix ? KernelMode::MIX_MODE : KernelMode::AIV_MODE);
+    ICPU_SET_TILING_KEY(plan.tilingKey);
+#ifdef PDIST_CPU_SIM_QUANT
+    ICPU_RUN_KF(pdist_quant, plan.blockDim, x, scale, zeroPoint, y, workspace, tiling);
+    AscendC::GmFree((void*)scale);
+    if (zeroPoint != nullptr) {
+        AscendC::GmFree((void*)zeroPoint);
+    }
+#else
+    ICPU_RUN_KF(pdist, plan.blockDim, x, indices, y, valid, workspace, tiling);
+    if (indices != nullptr) {
+        AscendC::GmFree((void*)indices);
+    }
+#endif
+
+    bool pass = check_accuracy<OutT>(yRef.data(), reinterpret_cast<OutT*>(y), outputNum);
+#ifndef PDIST_CPU_SIM_QUANT
+    if (valid != nullptr) {
+        // 位图: 第 i 行全部有限时字节 i / 8 的第 i % 8 位为 1，末字节多出的位为 0
+        for (uint64_t b = 0; b < validBytes; ++b) {
+            uint8_t expect = 0;
+            for (uint64_t i = b * 8; i < c.n && i < b * 8 + 8; ++i) {
+                expect |= cpu_row_finite(xF.data(), static_cast<int64_t>(i), c.m) ? (1U << (i % 8)) : 0;
+            }
+            if (valid[b] != expect) {
+                printf("[ERROR] validity byte %llu: expected 0x%02x, got 0x%02x\n", (unsigned long long)b, expect,
+                       valid[b]);
+                pass = false;
+                break;
+            }
+        }
+        AscendC::GmFree((void*)valid);
+    }
+#endif
+    printf("%s\n", pass ? "[PASS]" : "[FAIL]");
+
+    AscendC::GmFree((void*)x);
+    AscendC::GmFree((void*)y);
+    AscendC::GmFree((void*)workspace);
+    AscendC::GmFree((void*)tiling);
+    return pass;
+}
+
+} // namespace
+
+int main() {
+    int failed = 0;
+    std::set<uint32_t> coveredKeys;
+    for (size_t k = 0; k < sizeof(SIM_CASES) / sizeof(SIM_CASES[0]); ++k) {
+        if (!RunCase(SIM_CASES[k], k, coveredKeys)) {
+            failed++;
+        }
+    }
+    for (uint32_t key : KNOWN_TILING_KEYS) {
+        if (coveredKeys.count(key) == 0) {
+            printf("[ERROR] tilingKey %u not covered by any case\n", key);
+            failed++;
+        }
+    }
+    printf("CPU sim: %d failure(s)\n", failed);
+    return (failed == 0) ? 0 : 1;
+}
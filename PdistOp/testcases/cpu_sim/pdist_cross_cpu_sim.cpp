@@ -0,0 +1,212 @@
+/**
+ * @file pdist_cross_cpu_sim.cpp
+ * @brief CPU simulation (ICPU_RUN_KF) regression test for KernelPdistCross
+ *
+ * Every case is tiled by PlanPdistCrossTiling (the rules the PdistCross TilingFunc uses), checked for
+ * tiling invariants, run on the Ascend C CPU debug library and compared with the cross block of
+ * cpu_pdist over the stacked rows [x1; x2]. Built once per element type (DTYPE_X1 = float / half).
+ */
+
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <set>
+#include <vector>
+#include "tikicpulib.h"
+#include "pdist_cross_tiling.h"
+#include "pdist_golden.h"
+
+extern "C" __global__ __aicore__ void pdist_cross(GM_ADDR x1, GM_ADDR x2, GM_ADDR y, GM_ADDR workspace,
+                                                  GM_ADDR tiling);
+
+namespace {
+
+using ElemT = DTYPE_X1;
+
+// 仿真目标平台参数 (Ascend910B1)
+constexpr uint32_t SIM_CORE_NUM_AIC = 24;
+constexpr uint32_t SIM_CORE_NUM_AIV = 48;
+constexpr uint64_t SIM_SYS_WORKSPACE_SIZE = 16 * 1024 * 1024;
+constexpr uint64_t SIM_UB_SIZE = 192 * 1024;
+
+// PdistCross 可能产生的全部 tilingKey (Vector kernel 的各个距离实例)
+const std::set<uint32_t> KNOWN_TILING_KEYS = {
+    optiling::PDIST_TILING_KEY_VECTOR,      optiling::PDIST_TILING_KEY_VECTOR_L1,
+    optiling::PDIST_TILING_KEY_VECTOR_L2,   optiling::PDIST_TILING_KEY_VECTOR_LINF,
+    optiling::PDIST_TILING_KEY_VECTOR_INT_P,
+};
+
+struct CrossCase {
+    uint32_t rows1;
+    uint32_t rows2;
+    uint32_t m;
+    float p;
+};
+
+const float P_INF = std::numeric_limits<float>::infinity();
+
+const CrossCase CROSS_CASES[] = {
+    // 单个 pair、单核
+    {1, 1, 8, 2.0f},
+    {5, 37, 13, 1.0f},
+    // rows1 != rows2，边缘块 (行数不是 Bi / Bj 的整数倍)
+    {40, 100, 50, P_INF},
+    {100, 23, 33, 3.0f},
+    {77, 130, 100, 0.5f},
+    // 按行打包 (单段且 kChunk <= 64): BlockReduce (m = 8) 与 WholeReduce
+    {64, 200, 8, 1.0f},
+    {50, 90, 64, 2.0f},
+    // m 超过一段 (kChunk)，多段补偿求和 / 取 Max
+    {33, 17, 3000, 2.0f},
+    {20, 45, 3000, P_INF},
+    {12, 9, 24000, 3.0f},
+    // 多核: tile 数多于核数，x1 块在相邻 tile 间常驻
+    {256, 300, 40, 2.0f},
+};
+
+// Tiling 不变量: 对齐、UB 容量、核数，以及各核连续的 tile 段恰好覆盖全部 pair
+bool CheckCrossPlan(const CrossCase& c, const optiling::PdistTilingPlan& plan) {
+    bool ok = true;
+    if (plan.tilingKey != optiling::PdistVectorTilingKey(c.p)) {
+        printf("[ERROR] tilingKey %u does not match the metric of p=%g\n", plan.tilingKey, c.p);
+        ok = false;
+    }
+    optiling::PdistBlockParams bp = {plan.blockRows, plan.blockCols, plan.kChunk, plan.bufferNum, 0, 0};
+    if (optiling::PdistUbBytes(bp, sizeof(ElemT)) + optiling::PDIST_UB_RESERVED_BYTES > SIM_UB_SIZE ||
+        plan.kChunk % (32 / sizeof(ElemT)) != 0 || plan.blockCols % 8 != 0 ||
+        static_cast<uint64_t>(plan.chunkNum) * plan.kChunk < c.m ||
+        static_cast<uint64_t>(plan.chunkNum - 1) * plan.kChunk >= c.m) {
+        printf("[ERROR] bad block params Bi=%u Bj=%u kChunk=%u chunkNum=%u\n", plan.blockRows, plan.blockCols,
+               plan.kChunk, plan.chunkNum);
+        ok = false;
+    }
+    uint32_t iBlockNum = (c.rows1 + plan.blockRows - 1) / plan.blockRows;
+    uint32_t jBlockNum = (c.rows2 + plan.blockCols - 1) / plan.blockCols;
+    if (plan.tileNum != iBlockNum * jBlockNum || plan.usedCoreNum == 0 || plan.usedCoreNum > SIM_CORE_NUM_AIV ||
+        plan.usedCoreNum > plan.tileNum || plan.blockDim != plan.usedCoreNum) {
+        printf("[ERROR] bad tile / core count tiles=%u cores=%u\n", plan.tileNum, plan.usedCoreNum);
+        ok = false;
+    }
+    // 按 kernel 的切分复现: Core c 处理 [tileNum * c / cores, tileNum * (c + 1) / cores)
+    std::vector<uint32_t> cover(static_cast<size_t>(c.rows1) * c.rows2, 0);
+    for (uint32_t core = 0; core < plan.usedCoreNum; ++core) {
+        uint64_t begin = static_cast<uint64_t>(plan.tileNum) * core / plan.usedCoreNum;
+        uint64_t end = static_cast<uint64_t>(plan.tileNum) * (core + 1) / plan.usedCoreNum;
+        for (uint64_t t = begin; t < end; ++t) {
+            uint64_t i0 = (t / jBlockNum) * plan.blockRows;
+            uint64_t j0 = (t % jBlockNum) * plan.blockCols;
+            for (uint64_t i = i0; i < c.rows1 && i < i0 + plan.blockRows; ++i) {
+                for (uint64_t j = j0; j < c.rows2 && j < j0 + plan.blockCols; ++j) {
+                    cover[i * c.rows2 + j]++;
+                }
+            }
+        }
+    }
+    for (size_t k = 0; k < cover.size(); ++k) {
+        if (cover[k] != 1) {
+            printf("[ERROR] pair %zu covered %u times\n", k, cover[k]);
+            ok = false;
+            break;
+        }
+    }
+    printf("[INFO] cores=%u Bi=%u Bj=%u kChunk=%u x%u buffers=%u tiles=%u packed=%d tilingKey=%u\n",
+           plan.usedCoreNum, plan.blockRows, plan.blockCols, plan.kChunk, plan.chunkNum, plan.bufferNum,
+           plan.tileNum, optiling::PdistRowPacked(plan) ? 1 : 0, plan.tilingKey);
+    return ok;
+}
+
+const char* TypeName() {
+    return (sizeof(ElemT) == 4) ? "FP32" : "FP16";
+}
+
+bool RunCase(const CrossCase& c, std::set<uint32_t>& coveredKeys) {
+    printf(">>> CPU sim (cross): Rows1=%u, Rows2=%u, M=%u, P=%g, Type=%s\n", c.rows1, c.rows2, c.m, c.p,
+           TypeName());
+
+    optiling::PdistTilingInput in = {};
+    in.n = c.rows1;
+    in.m = c.m;
+    in.p = c.p;
+    in.typeSize = sizeof(ElemT);
+    in.coreNumAic = SIM_CORE_NUM_AIC;
+    in.coreNumAiv = SIM_CORE_NUM_AIV;
+    in.ubSize = SIM_UB_SIZE;
+    optiling::PdistTilingPlan plan = optiling::PlanPdistCrossTiling(in, c.rows2);
+    if (!CheckCrossPlan(c, plan)) {
+        return false;
+    }
+    coveredKeys.insert(plan.tilingKey);
+
+    optiling::PdistCrossTilingData tilingData;
+    optiling::FillPdistCrossTilingData(plan, c.rows2, tilingData);
+    size_t tilingSize = tilingData.GetDataSize();
+
+    uint64_t x1Num = static_cast<uint64_t>(c.rows1) * c.m;
+    uint64_t x2Num = static_cast<uint64_t>(c.rows2) * c.m;
+    uint64_t outputNum = static_cast<uint64_t>(c.rows1) * c.rows2;
+    uint8_t* x1 = (uint8_t*)AscendC::GmAlloc(x1Num * sizeof(ElemT));
+    uint8_t* x2 = (uint8_t*)AscendC::GmAlloc(x2Num * sizeof(ElemT));
+    uint8_t* y = (uint8_t*)AscendC::GmAlloc(outputNum * sizeof(ElemT));
+    uint8_t* workspace = (uint8_t*)AscendC::GmAlloc(SIM_SYS_WORKSPACE_SIZE);
+    uint8_t* tiling = (uint8_t*)AscendC::GmAlloc(tilingSize);
+    tilingData.SaveToBuffer(tiling, tilingSize);
+
+    // x1 / x2 依次排成 rows1 + rows2 行的矩阵，golden 取其压缩距离中 (i, rows1 + j) 这一块
+    std::mt19937 gen(2023);
+    std::uniform_real_distribution<float> dis(-10.0f, 10.0f);
+    ElemT* x1T = reinterpret_cast<ElemT*>(x1);
+    ElemT* x2T = reinterpret_cast<ElemT*>(x2);
+    std::vector<float> xF(x1Num + x2Num);
+    for (uint64_t k = 0; k < x1Num; ++k) {
+        x1T[k] = static_cast<ElemT>(dis(gen));
+        xF[k] = static_cast<float>(x1T[k]);
+    }
+    for (uint64_t k = 0; k < x2Num; ++k) {
+        x2T[k] = static_cast<ElemT>(dis(gen));
+        xF[x1Num + k] = static_cast<float>(x2T[k]);
+    }
+    uint64_t total = static_cast<uint64_t>(c.rows1) + c.rows2;
+    std::vector<float> condensed(total * (total - 1) / 2 + 1);
+    cpu_pdist<float>(xF.data(), condensed.data(), total, c.m, c.p);
+    std::vector<ElemT> yRef(outputNum);
+    for (uint64_t i = 0; i < c.rows1; ++i) {
+        for (uint64_t j = 0; j < c.rows2; ++j) {
+            uint64_t col = c.rows1 + j;
+            yRef[i * c.rows2 + j] = static_cast<ElemT>(condensed[(2 * total - 1 - i) * i / 2 + (col - i - 1)]);
+        }
+    }
+
+    AscendC::SetKernelMode(KernelMode::AIV_MODE);
+    ICPU_SET_TILING_KEY(plan.tilingKey);
+    ICPU_RUN_KF(pdist_cross, plan.blockDim, x1, x2, y, workspace, tiling);
+
+    bool pass = check_accuracy<ElemT>(yRef.data(), reinterpret_cast<ElemT*>(y), outputNum);
+    printf("%s\n", pass ? "[PASS]" : "[FAIL]");
+
+    AscendC::GmFree((void*)x1);
+    AscendC::GmFree((void*)x2);
+    AscendC::GmFree((void*)y);
+    AscendC::GmFree((void*)workspace);
+    AscendC::GmFree((void*)tiling);
+    return pass;
+}
+
+} // namespace
+
+int main() {
+    int failed = 0;
+    std::set<uint32_t> coveredKeys;
+    for (size_t k = 0; k < sizeof(CROSS_CASES) / sizeof(CROSS_CASES[0]); ++k) {
+        if (!RunCase(CROSS_CASES[k], coveredKeys)) {
+            failed++;
+        }
+    }
+    for (uint32_t key : KNOWN_TILING_KEYS) {
+        if (coveredKeys.count(key) == 0) {
+            printf("[ERROR] tilingKey %u not covered by any case\n", key);
+            failed++;
+        }
+    }
+    printf("CPU sim (cross): %d failure(s)\n", failed);
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+/**
+ * @file pdist_grad_cpu_sim.cpp
+ * @brief CPU simulation (ICPU_RUN_KF) regression test for KernelPdistGrad
+ *
+ * Every case runs the forward golden (cpu_pdist) to get y, draws a random grad_y, runs the kernel on
+ * the Ascend C CPU debug library with the tiling the PdistGrad TilingFunc produces and compares grad_x
+ * with a double-precision analytic gradient evaluated on the same (x, y, grad_y). Built once per
+ * element type (DTYPE_X = float / half).
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+#include "tikicpulib.h"
+#include "pdist_grad_tiling.h"
+#include "pdist_golden.h"
+
+extern "C" __global__ __aicore__ void pdist_grad(GM_ADDR x, GM_ADDR y, GM_ADDR grad_y, GM_ADDR grad_x,
+                                                 GM_ADDR workspace, GM_ADDR tiling);
+
+namespace {
+
+using ElemT = DTYPE_X;
+
+// 仿真目标平台参数 (Ascend910B1)
+constexpr uint32_t SIM_CORE_NUM_AIV = 48;
+constexpr uint64_t SIM_SYS_WORKSPACE_SIZE = 16 * 1024 * 1024;
+constexpr uint64_t SIM_UB_SIZE = 192 * 1024;
+
+// 需与 op_kernel/pdist_grad.cpp 一致: p = inf 时 |diff| 距 d 在 tol * d 以内的维度按比例计入梯度
+constexpr double GRAD_INF_TOL = (sizeof(ElemT) == 4) ? 1e-6 : 1e-3;
+// grad_x 的每个元素是 n - 1 项之和: 误差按各项绝对值之和计 (FP32 另含 Ln / Exp 与原子累加顺序的误差)
+constexpr double GRAD_REL_TOL = (sizeof(ElemT) == 4) ? 1e-4 : 1e-2;
+
+struct GradCase {
+    uint32_t n;
+    uint32_t m;
+    float p;
+    uint32_t dupEvery; // 非 0 时第 dupEvery - 1, 2 * dupEvery - 1, ... 行复制上一行 (d = 0)
+};
+
+const float P_INF = std::numeric_limits<float>::infinity();
+
+const GradCase GRAD_CASES[] = {
+    // 单行: 没有 pair，grad_x 全 0
+    {1, 8, 2.0f, 0},
+    // n 不是块行数 (16) 的整数倍，边缘块与对角块
+    {37, 50, 2.0f, 0},
+    {37, 50, 1.0f, 0},
+    {37, 50, P_INF, 0},
+    {37, 50, 3.0f, 0},
+    {37, 50, 1.5f, 0},
+    // m 超过一段 (kChunk)，逐段原子累加
+    {20, 2500, 2.0f, 0},
+    {20, 2500, 1.0f, 0},
+    {20, 2500, P_INF, 0},
+    {20, 2500, 3.0f, 0},
+    // 重复行: d = 0 的 pair 不产生梯度
+    {50, 33, 2.0f, 9},
+    {50, 33, 1.0f, 9},
+    {50, 33, P_INF, 9},
+    {50, 33, 3.0f, 9},
+    // 块数多于核数，多核原子累加到同一行
+    {300, 16, 2.0f, 0},
+    {300, 16, 2.5f, 7},
+};
+
+const char* TypeName() {
+    return (sizeof(ElemT) == 4) ? "FP32" : "FP16";
+}
+
+// dd_ij / dx_i 的第 k 维 (op_kernel/pdist_grad.cpp 类注释的 c * w)，d 取正向输出 y
+double PairGrad(double diff, double d, float p) {
+    double a = std::abs(diff);
+    double sign = (diff > 0.0) ? 1.0 : ((diff < 0.0) ? -1.0 : 0.0);
+    if (std::isinf(p)) {
+        double w = (a - d) / (GRAD_INF_TOL * d) + 1.0;
+        return sign * std::min(std::max(w, 0.0), 1.0);
+    }
+    if (p == 1.0f) {
+        return sign;
+    }
+    if (p == 2.0f) {
+        return diff / d;
+    }
+    return sign * std::pow(a, static_cast<double>(p) - 1.0) * std::pow(d, 1.0 - static_cast<double>(p));
+}
+
+// grad_x 的 double 参考值，以及每个元素各项绝对值之和 (容差的尺度)
+void GoldenGrad(const std::vector<double>& x, const std::vector<double>& y, const std::vector<double>& g,
+                uint32_t n, uint32_t m, float p, std::vector<double>& grad, std::vector<double>& mag) {
+    grad.assign(static_cast<size_t>(n) * m, 0.0);
+    mag.assign(static_cast<size_t>(n) * m, 0.0);
+    uint64_t idx = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        for (uint64_t j = i + 1; j < n; ++j, ++idx) {
+            double d = y[idx];
+            if (d == 0.0) {
+                continue;
+            }
+            for (uint64_t k = 0; k < m; ++k) {
+                // 与 kernel 一样在 float 上求差: p = inf 判定 |diff| == d 的窗口 (tol * d) 比 double 与 float 差值的舍入更窄
+                float diffF = static_cast<float>(x[i * m + k]) - static_cast<float>(x[j * m + k]);
+                double term = g[idx] * PairGrad(static_cast<double>(diffF), d, p);
+                grad[i * m + k] += term;
+                grad[j * m + k] -= term;
+                mag[i * m + k] += std::abs(term);
+                mag[j * m + k] += std::abs(term);
+            }
+        }
+    }
+}
+
+bool RunCase(const GradCase& c) {
+    printf(">>> CPU sim (grad): N=%u, M=%u, P=%g, Type=%s%s\n", c.n, c.m, c.p, TypeName(),
+           (c.dupEvery != 0) ? ", duplicate rows" : "");
+
+    optiling::PdistGradTilingData tilingData;
+    optiling::FillPdistGradTilingData(c.n, c.m, c.p, sizeof(ElemT), SIM_UB_SIZE, SIM_CORE_NUM_AIV, tilingData);
+    uint32_t usedCoreNum = tilingData.get_usedCoreNum();
+    uint32_t kChunk = tilingData.get_kChunk();
+    uint32_t tileNum = tilingData.get_tileNum();
+    if (optiling::PdistGradUbBytes(tilingData.get_blockRows(), kChunk, sizeof(ElemT)) +
+        optiling::PDIST_UB_RESERVED_BYTES > SIM_UB_SIZE || kChunk % (32 / sizeof(ElemT)) != 0 ||
+        static_cast<uint64_t>(tilingData.get_chunkNum()) * kChunk < c.m) {
+        printf("[ERROR] bad kChunk %u\n", kChunk);
+        return false;
+    }
+    size_t tilingSize = tilingData.GetDataSize();
+    printf("[INFO] cores=%u kChunk=%u x%u tiles=%u\n", usedCoreNum, kChunk, tilingData.get_chunkNum(), tileNum);
+
+    uint64_t inputNum = static_cast<uint64_t>(c.n) * c.m;
+    uint64_t pairNum = static_cast<uint64_t>(c.n) * (c.n - 1) / 2;
+    uint8_t* x = (uint8_t*)AscendC::GmAlloc(inputNum * sizeof(ElemT));
+    uint8_t* y = (uint8_t*)AscendC::GmAlloc((pairNum + 1) * sizeof(ElemT));
+    uint8_t* gradY = (uint8_t*)AscendC::GmAlloc((pairNum + 1) * sizeof(ElemT));
+    uint8_t* gradX = (uint8_t*)AscendC::GmAlloc(inputNum * sizeof(ElemT));
+    uint8_t* workspace = (uint8_t*)AscendC::GmAlloc(
+        SIM_SYS_WORKSPACE_SIZE + optiling::PdistGradUserWorkspaceBytes(c.n, c.m, sizeof(ElemT)));
+    uint8_t* tiling = (uint8_t*)AscendC::GmAlloc(tilingSize);
+    tilingData.SaveToBuffer(tiling, tilingSize);
+
+    std::mt19937 gen(2023);
+    std::uniform_real_distribution<float> xDis(-10.0f, 10.0f);
+    std::uniform_real_distribution<float> gDis(-1.0f, 1.0f);
+    ElemT* xT = reinterpret_cast<ElemT*>(x);
+    for (uint64_t r = 0; r < c.n; ++r) {
+        bool dup = (c.dupEvery != 0 && r % c.dupEvery == c.dupEvery - 1);
+        for (uint64_t k = 0; k < c.m; ++k) {
+            xT[r * c.m + k] = dup ? xT[(r - 1) * c.m + k] : static_cast<ElemT>(xDis(gen));
+        }
+    }
+    ElemT* yT = reinterpret_cast<ElemT*>(y);
+    ElemT* gT = reinterpret_cast<ElemT*>(gradY);
+    cpu_pdist<ElemT>(xT, yT, c.n, c.m, c.p);
+    for (uint64_t k = 0; k < pairNum; ++k) {
+        gT[k] = static_cast<ElemT>(gDis(gen));
+    }
+
+    // 参考值按 kernel 实际读到的 (x, y, grad_y) 计算
+    std::vector<double> xD(inputNum), yD(pairNum), gD(pairNum), ref, mag;
+    for (uint64_t k = 0; k < inputNum; ++k) {
+        xD[k] = static_cast<double>(xT[k]);
+    }
+    for (uint64_t k = 0; k < pairNum; ++k) {
+        yD[k] = static_cast<double>(yT[k]);
+        gD[k] = static_cast<double>(gT[k]);
+    }
+    GoldenGrad(xD, yD, gD, c.n, c.m, c.p, ref, mag);
+
+    AscendC::SetKernelMode(KernelMode::AIV_MODE);
+    ICPU_SET_TILING_KEY(tilingData.get_tilingKey());
+    ICPU_RUN_KF(pdist_grad, usedCoreNum, x, y, gradY, gradX, workspace, tiling);
+
+    const ElemT* out = reinterpret_cast<const ElemT*>(gradX);
+    double maxErr = 0.0;
+    uint64_t errCount = 0;
+    for (uint64_t k = 0; k < inputNum; ++k) {
+        double got = static_cast<double>(out[k]);
+        double err = std::abs(got - ref[k]);
+        if (!(err <= GRAD_REL_TOL * (mag[k] + 1e-3))) {
+            if (errCount < 5) {
+                printf("[ERROR] Mismatch at row %llu col %llu: expected %g, got %g (scale %g)\n",
+                       (unsigned long long)(k / c.m), (unsigned long long)(k % c.m), ref[k], got, mag[k]);
+            }
+            errCount++;
+        }
+        maxErr = (err > maxErr) ? err : maxErr;
+    }
+    printf("[INFO] Max Abs Error: %g\n", maxErr);
+    bool pass = (errCount == 0);
+    printf("%s\n", pass ? "[PASS]" : "[FAIL]");
+
+    AscendC::GmFree((void*)x);
+    AscendC::GmFree((void*)y);
+    AscendC::GmFree((void*)gradY);
+    AscendC::GmFree((void*)gradX);
+    AscendC::GmFree((void*)workspace);
+    AscendC::GmFree((void*)tiling);
+    return pass;
+}
+
+} // namespace
+
+int main() {
+    int failed = 0;
+    for (size_t k = 0; k < sizeof(GRAD_CASES) / sizeof(GRAD_CASES[0]); ++k) {
+        if (!RunCase(GRAD_CASES[k])) {
+            failed++;
+        }
+    }
+    printf("CPU sim (grad): %d failure(s)\n", failed);
+    return (failed == 0) ? 0 : 1;
+}
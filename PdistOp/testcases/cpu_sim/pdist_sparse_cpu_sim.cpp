@@ -0,0 +1,164 @@
+/**
+ * @file pdist_sparse_cpu_sim.cpp
+ * @brief CPU simulation (ICPU_RUN_KF) regression test for KernelPdistSparse
+ *
+ * Every case builds a random CSR matrix (sorted column indices, optional empty and long rows), runs the
+ * kernel on the Ascend C CPU debug library with the tiling the PdistSparse TilingFunc produces and
+ * compares the condensed output with cpu_pdist on the densified matrix.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "tikicpulib.h"
+#include "pdist_sparse_tiling.h"
+#include "pdist_golden.h"
+
+extern "C" __global__ __aicore__ void pdist_sparse(GM_ADDR indptr, GM_ADDR indices, GM_ADDR values, GM_ADDR y,
+                                                   GM_ADDR workspace, GM_ADDR tiling);
+
+namespace {
+
+// 仿真目标平台参数 (Ascend910B1)
+constexpr uint32_t SIM_CORE_NUM_AIV = 48;
+constexpr uint64_t SIM_SYS_WORKSPACE_SIZE = 16 * 1024 * 1024;
+
+struct SparseCase {
+    uint32_t n;
+    uint32_t m;          // 稠密宽度 (列号范围)
+    float p;
+    uint32_t rowNnz;     // 普通行的非零元数在 [0, 2 * rowNnz] 内均匀取
+    uint32_t longRows;   // 前 longRows 行各有 longNnz 个非零元
+    uint32_t longNnz;
+    uint32_t emptyEvery; // 非 0 时第 emptyEvery - 1, 2 * emptyEvery - 1, ... 行为空行
+};
+
+const float P_INF = std::numeric_limits<float>::infinity();
+constexpr uint32_t W = optiling::PDIST_SPARSE_WINDOW;
+
+const SparseCase SPARSE_CASES[] = {
+    // 单行: 没有 pair
+    {1, 16, 2.0f, 4, 0, 0, 0},
+    // p = 2: 范数预处理 + SyncAll + 交集点积；含空行
+    {40, 300, 2.0f, 20, 0, 0, 7},
+    // p = 1 / inf / 通用 p 走并集归并；含空行
+    {40, 300, 1.0f, 20, 0, 0, 7},
+    {40, 300, P_INF, 20, 0, 0, 7},
+    {40, 300, 3.0f, 20, 0, 0, 7},
+    {40, 300, 0.5f, 20, 0, 0, 7},
+    // 行的非零元多于窗口 (W)，indices / values 窗口在行内重新搬入；
+    // 两个长行的并集多于 W 个，通用 p 的 |diff| 批在行内多次 PowSum
+    {24, 50000, 2.0f, 50, 3, W + W / 2, 5},
+    {24, 50000, 1.0f, 50, 3, W + W / 2, 5},
+    {24, 50000, P_INF, 50, 3, W + W / 2, 5},
+    {24, 50000, 3.0f, 50, 3, W + W / 2, 5},
+    // n > W: indptr / 范数窗口重新搬入，且一行的输出多于 W 个时分段写回
+    // p = 2 按 ||xi||^2 + ||xj||^2 - 2 <xi, xj> 计算，几乎重合的两行会放大舍入误差，故各行取相同的非零元数
+    {W + 52, 64, 2.0f, 0, W + 52, 16, 5},
+    {W + 52, 64, 0.5f, 3, 0, 0, 5},
+};
+
+struct Csr {
+    std::vector<int32_t> indptr;
+    std::vector<int32_t> indices;
+    std::vector<float> values;
+};
+
+Csr BuildCsr(const SparseCase& c, std::mt19937& gen) {
+    std::uniform_real_distribution<float> valDis(-10.0f, 10.0f);
+    std::uniform_int_distribution<uint32_t> nnzDis(0, 2 * c.rowNnz);
+    std::vector<int32_t> allCols(c.m);
+    std::iota(allCols.begin(), allCols.end(), 0);
+
+    Csr csr;
+    csr.indptr.push_back(0);
+    for (uint32_t r = 0; r < c.n; ++r) {
+        uint32_t rowNnz;
+        if (c.emptyEvery != 0 && r % c.emptyEvery == c.emptyEvery - 1) {
+            rowNnz = 0;
+        } else if (r < c.longRows) {
+            rowNnz = c.longNnz;
+        } else {
+            rowNnz = nnzDis(gen);
+        }
+        rowNnz = std::min(rowNnz, c.m);
+        // std::sample 保持原有顺序，行内列号递增
+        std::sample(allCols.begin(), allCols.end(), std::back_inserter(csr.indices), rowNnz, gen);
+        for (uint32_t k = 0; k < rowNnz; ++k) {
+            csr.values.push_back(valDis(gen));
+        }
+        csr.indptr.push_back(static_cast<int32_t>(csr.indices.size()));
+    }
+    return csr;
+}
+
+bool RunCase(const SparseCase& c) {
+    std::mt19937 gen(2023);
+    Csr csr = BuildCsr(c, gen);
+    uint32_t nnz = static_cast<uint32_t>(csr.values.size());
+    uint32_t maxRowNnz = 0;
+    for (uint32_t r = 0; r < c.n; ++r) {
+        maxRowNnz = std::max(maxRowNnz, static_cast<uint32_t>(csr.indptr[r + 1] - csr.indptr[r]));
+    }
+    printf(">>> CPU sim (sparse): N=%u, M=%u, P=%g, nnz=%u, max row nnz=%u\n", c.n, c.m, c.p, nnz, maxRowNnz);
+
+    optiling::PdistSparseTilingData tilingData;
+    optiling::FillPdistSparseTilingData(c.n, nnz, c.p, SIM_CORE_NUM_AIV, tilingData);
+    uint32_t usedCoreNum = tilingData.get_usedCoreNum();
+    size_t tilingSize = tilingData.GetDataSize();
+
+    uint64_t outputNum = static_cast<uint64_t>(c.n) * (c.n - 1) / 2;
+    // 空数组也分配一个元素，保证 GM 地址有效
+    uint8_t* indptr = (uint8_t*)AscendC::GmAlloc((c.n + 1) * sizeof(int32_t));
+    uint8_t* indices = (uint8_t*)AscendC::GmAlloc((nnz + 1) * sizeof(int32_t));
+    uint8_t* values = (uint8_t*)AscendC::GmAlloc((nnz + 1) * sizeof(float));
+    uint8_t* y = (uint8_t*)AscendC::GmAlloc((outputNum + 1) * sizeof(float));
+    uint8_t* workspace = (uint8_t*)AscendC::GmAlloc(SIM_SYS_WORKSPACE_SIZE +
+                                                    optiling::PdistSparseUserWorkspaceBytes(c.n, c.p));
+    uint8_t* tiling = (uint8_t*)AscendC::GmAlloc(tilingSize);
+    tilingData.SaveToBuffer(tiling, tilingSize);
+    std::copy(csr.indptr.begin(), csr.indptr.end(), reinterpret_cast<int32_t*>(indptr));
+    std::copy(csr.indices.begin(), csr.indices.end(), reinterpret_cast<int32_t*>(indices));
+    std::copy(csr.values.begin(), csr.values.end(), reinterpret_cast<float*>(values));
+
+    // 稠密化后按 Pdist 的 golden 计算
+    std::vector<float> dense(static_cast<size_t>(c.n) * c.m, 0.0f);
+    for (uint32_t r = 0; r < c.n; ++r) {
+        for (int32_t k = csr.indptr[r]; k < csr.indptr[r + 1]; ++k) {
+            dense[static_cast<size_t>(r) * c.m + csr.indices[k]] = csr.values[k];
+        }
+    }
+    std::vector<float> yRef(outputNum + 1);
+    cpu_pdist<float>(dense.data(), yRef.data(), c.n, c.m, c.p);
+
+    AscendC::SetKernelMode(KernelMode::AIV_MODE);
+    ICPU_SET_TILING_KEY(tilingData.get_tilingKey());
+    ICPU_RUN_KF(pdist_sparse, usedCoreNum, indptr, indices, values, y, workspace, tiling);
+
+    bool pass = check_accuracy<float>(yRef.data(), reinterpret_cast<float*>(y), outputNum);
+    printf("%s\n", pass ? "[PASS]" : "[FAIL]");
+
+    AscendC::GmFree((void*)indptr);
+    AscendC::GmFree((void*)indices);
+    AscendC::GmFree((void*)values);
+    AscendC::GmFree((void*)y);
+    AscendC::GmFree((void*)workspace);
+    AscendC::GmFree((void*)tiling);
+    return pass;
+}
+
+} // namespace
+
+int main() {
+    int failed = 0;
+    for (size_t k = 0; k < sizeof(SPARSE_CASES) / sizeof(SPARSE_CASES[0]); ++k) {
+        if (!RunCase(SPARSE_CASES[k])) {
+            failed++;
+        }
+    }
+    printf("CPU sim (sparse): %d failure(s)\n", failed);
+    return (failed == 0) ? 0 : 1;
+}
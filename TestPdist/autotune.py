@@ -0,0 +1,147 @@
+import argparse
+import itertools
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+# =========================================================
+# Pdist 离线调优: 对每个生产 shape 枚举分块参数 (Bi, Bj, kChunk, bufferNum, coreNum, schedMode)，
+# 通过 PDIST_TILING_OVERRIDE 逐个交给 TilingFunc，用 pdist_bench 计时，
+# 把优于启发式的最佳参数写成调优表 (格式见 PdistOp/op_host/pdist_tuning.h)。
+#
+# 用法: python3 autotune.py [--shapes shapes.txt] [--out pdist_tuning_table.txt]
+# 部署: 将输出放到 tiling 库同目录，或 export PDIST_TUNING_TABLE=<path>
+# =========================================================
+BENCH_PATH = "./build/pdist_bench"
+TIMEOUT_SEC = 300
+
+# 生产 shape: (N, M, P, DType)
+DEFAULT_SHAPES = [
+    (1024, 128, "2", "fp32"),
+    (4096, 128, "2", "fp32"),
+    (4096, 1024, "2", "fp16"),
+    (8192, 64, "1", "fp32"),
+    (2048, 3008, "2", "fp16"),
+]
+
+BLOCK_ROWS = [4, 8, 16, 32, 64]
+BLOCK_COLS = [8, 16, 32, 64]
+K_CHUNKS = [256, 512, 1024, 2048]
+BUFFER_NUMS = [1, 2]
+# tile 调度: 1 = 静态 Cyclic，2 = 原子计数器动态领取 (PdistSchedMode)
+SCHED_MODES = [1, 2]
+
+# 与 pdist_tiling_plan.h 保持一致
+UB_SIZE = 192 * 1024
+UB_RESERVED = 4 * 1024
+MAX_K_CHUNK = 2048
+ROW_PACK_MAX_ELEMS = 64
+
+
+def align_elems(count, type_size):
+    align = 32 // type_size
+    return (count + align - 1) // align * align
+
+
+def ub_bytes(bi, bj, kc, buf, type_size):
+    """与 PdistUbBytes 相同的 UB 占用估算"""
+    total = bi * kc * type_size + buf * bj * kc * type_size
+    if type_size != 4:
+        total += (bi + bj) * kc * 4
+    diff_elems = bj * kc if kc <= ROW_PACK_MAX_ELEMS else kc
+    total += 2 * diff_elems * 4 + 32
+    total += 2 * bi * bj * 4
+    total += 2 * align_elems(bj, type_size) * type_size
+    return total
+
+
+def candidates(m, type_size, core_num):
+    m_aligned = align_elems(m, type_size)
+    k_list = sorted({min(align_elems(k, type_size), m_aligned) for k in K_CHUNKS + [min(m, MAX_K_CHUNK)]})
+    core_list = [0] if core_num <= 0 else sorted({0, core_num // 2, core_num})
+    for bi, bj, kc, buf, cores, sched in itertools.product(BLOCK_ROWS, BLOCK_COLS, k_list, BUFFER_NUMS, core_list,
+                                                           SCHED_MODES):
+        if ub_bytes(bi, bj, kc, buf, type_size) + UB_RESERVED <= UB_SIZE:
+            yield (bi, bj, kc, buf, cores, sched)
+
+
+def bench(n, m, p, dtype, iters, override=None):
+    """运行一次 pdist_bench，返回 median 延迟 (ms)，失败返回 None"""
+    env = dict(os.environ)
+    env.pop("PDIST_TUNING_TABLE", None)
+    if override is not None:
+        env["PDIST_TILING_OVERRIDE"] = ",".join(str(v) for v in override)
+    else:
+        env.pop("PDIST_TILING_OVERRIDE", None)
+    with tempfile.NamedTemporaryFile(suffix=".json", delete=False) as tmp:
+        json_path = tmp.name
+    cmd = [BENCH_PATH, "--n", str(n), "--m", str(m), "--p", p, "--dtype", dtype,
+           "--iters", str(iters), "--warmup", "3", "--json", json_path, "--tag", "autotune"]
+    try:
+        ret = subprocess.run(cmd, env=env, capture_output=True, text=True, timeout=TIMEOUT_SEC)
+        if ret.returncode != 0:
+            return None
+        with open(json_path) as f:
+            results = json.load(f)["results"]
+        return results[0]["median_ms"] if results else None
+    except (subprocess.TimeoutExpired, OSError, ValueError, KeyError):
+        return None
+    finally:
+        os.remove(json_path)
+
+
+def load_shapes(path):
+    shapes = []
+    with open(path) as f:
+        for line in f:
+            parts = line.split()
+            if len(parts) == 4 and not line.startswith("#"):
+                shapes.append((int(parts[0]), int(parts[1]), parts[2], parts[3]))
+    return shapes
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pdist tiling auto-tuner")
+    parser.add_argument("--shapes", help="每行: N M P DType (fp32/fp16)")
+    parser.add_argument("--out", default="pdist_tuning_table.txt")
+    parser.add_argument("--iters", type=int, default=20)
+    parser.add_argument("--cores", type=int, default=48, help="平台 AIV 核数 (纯 Vector kernel 的 blockDim 上限)，用于生成核数候选")
+    args = parser.parse_args()
+
+    if not os.path.exists(BENCH_PATH):
+        print(f"❌ Binary not found at {BENCH_PATH}, build TestPdist first")
+        sys.exit(1)
+    shapes = load_shapes(args.shapes) if args.shapes else DEFAULT_SHAPES
+
+    lines = ["# n m p dtype blockRows blockCols kChunk bufferNum coreNum schedMode  (heuristic_ms -> tuned_ms)"]
+    for n, m, p, dtype in shapes:
+        type_size = 2 if dtype == "fp16" else 4
+        base = bench(n, m, p, dtype, args.iters)
+        if base is None:
+            print(f"❌ {n}x{m} p={p} {dtype}: heuristic run failed, skipped")
+            continue
+        print(f">>> {n}x{m} p={p} {dtype}: heuristic {base:.4f} ms")
+
+        best, best_ms = None, base
+        for cand in candidates(m, type_size, args.cores):
+            ms = bench(n, m, p, dtype, args.iters, cand)
+            if ms is not None and ms < best_ms:
+                best, best_ms = cand, ms
+                print(f"    Bi={cand[0]} Bj={cand[1]} kChunk={cand[2]} buffers={cand[3]} cores={cand[4]} "
+                      f"sched={cand[5]}: {ms:.4f} ms")
+
+        if best is None:
+            print("    heuristic is best, no table entry")
+            continue
+        print(f"✅ best {best} {best_ms:.4f} ms ({base / best_ms:.2f}x)")
+        lines.append(f"{n} {m} {p} {dtype} {' '.join(str(v) for v in best)}  # {base:.4f} -> {best_ms:.4f}")
+
+    with open(args.out, "w") as f:
+        f.write("\n".join(lines) + "\n")
+    print(f"\nTuning table written to {args.out}")
+
+
+if __name__ == "__main__":
+    main()
@@ -10,8 +10,14 @@
 #include <chrono>
 #include <iomanip>
 #include <limits> // for std::numeric_limits
+#include <cstring>
 #include "acl/acl.h"
 #include "aclnn_pdist.h"
+#include "pdist_golden.h"
+#include "pdist_pool.h"
+#ifdef PDIST_PROFILE
+#include "pdist_profile.h"
+#endif
 
 #define CHECK_RET(cond, return_expr) \
   do {                               \
@@ -25,90 +31,22 @@
     printf(message, ##__VA_ARGS__); \
   } while (0)
 
-// =========================================================
-// CPU 参考实现 (Golden Kernel) - 已修复 P=inf 支持
-// =========================================================
-template <typename T>
-void cpu_pdist(T* x, T* y, int64_t n, int64_t m, float p) {
-    int64_t out_idx = 0;
-    bool is_inf = std::isinf(p); // 检查 p 是否为无穷大
-
-    for (int64_t i = 0; i < n; i++) {
-        for (int64_t j = i + 1; j < n; j++) {
-            double result = 0.0;
-            
-            if (is_inf) {
-                // P = inf: 切比雪夫距离 (取最大差值)
-                double max_diff = 0.0;
-                for (int64_t k = 0; k < m; k++) {
-                    double diff = std::abs(static_cast<double>(x[i * m + k]) - static_cast<double>(x[j * m + k]));
-                    if (diff > max_diff) {
-                        max_diff = diff;
-                    }
-                }
-                result = max_diff;
-            } else {
-                // P = 其他: 闵可夫斯基距离 (累加 pow)
-                double sum = 0.0;
-                for (int64_t k = 0; k < m; k++) {
-                    double diff = std::abs(static_cast<double>(x[i * m + k]) - static_cast<double>(x[j * m + k]));
-                    sum += std::pow(diff, static_cast<double>(p));
-                }
-                result = std::pow(sum, 1.0 / p);
-            }
-            
-            y[out_idx++] = static_cast<T>(result);
-        }
-    }
-}
-
-// =========================================================
-// 精度校验工具
-// =========================================================
-template <typename T>
-bool check_accuracy(T* expected, T* actual, int64_t len, float p) {
-    double epsilon = (sizeof(T) == 2) ? 1e-2 : 1e-4;
-    // 适当放宽阈值
-    if (p > 2.0) epsilon *= 5.0;
-
-    double max_err = 0.0;
-    int64_t err_count = 0;
-
-    for (int64_t i = 0; i < len; ++i) {
-        double val1 = static_cast<double>(expected[i]);
-        double val2 = static_cast<double>(actual[i]);
-        double diff = std::abs(val1 - val2);
-        
-        if (diff > epsilon && diff / (std::abs(val1) + 1e-9) > epsilon) {
-            if (err_count < 5) {
-                std::cout << "[ERROR] Mismatch at index " << i 
-                          << ": expected " << val1 << ", got " << val2 
-                          << ", diff " << diff << std::endl;
-            }
-            err_count++;
-        }
-        if (diff > max_err) max_err = diff;
-    }
-
-    std::cout << "[INFO] Max Abs Error: " << max_err << std::endl;
-    
-    if (err_count > 0) {
-        std::cout << "[FAIL] Total " << err_count << " mismatches found." << std::endl;
-        return false;
-    }
-    return true;
-}
-
 // =========================================================
 // 主测试函数
 // =========================================================
 int main(int argc, char** argv) {
     if (argc < 5) {
-        std::cout << "Usage: " << argv[0] << " <N> <M> <P> <DType>" << std::endl;
+        std::cout << "Usage: " << argv[0] << " <N> <M> <P> <DType> [RowStride]" << std::endl;
         return -1;
     }
     int64_t N = std::atol(argv[1]);
     int64_t M = std::atol(argv[2]);
+    // 可选: x 取自每行 RowStride 个元素的更宽矩阵的前 M 列，以 strided 视图零拷贝传给算子
+    int64_t rowStride = (argc > 5) ? std::atol(argv[5]) : M;
+    if (rowStride < M) {
+        std::cout << "RowStride must be >= M" << std::endl;
+        return -1;
+    }
     
     // 特殊处理 inf 字符串输入
     std::string p_str = argv[3];
@@ -123,7 +61,7 @@ int main(int argc, char** argv) {
 
     std::cout << ">>> Running Test: N=" << N << ", M=" << M 
               << ", P=" << (std::isinf(p) ? "INF" : std::to_string(p)) 
-              << ", Type=" << (dtype_enum == 0 ? "FP32" : "FP16") << std::endl;
+              << ", Type=" << (dtype_enum == 0 ? "FP32" : "FP16") << ", RowStride=" << rowStride << std::endl;
 
     int32_t deviceId = 0;
     CHECK_RET(aclInit(nullptr) == ACL_SUCCESS, return -1);
@@ -132,17 +70,23 @@ int main(int argc, char** argv) {
     CHECK_RET(aclrtCreateStream(&stream) == ACL_SUCCESS, return -1);
 
     int64_t inputSize = N * M;
+    int64_t storageSize = N * rowStride;
     int64_t outputSize = N * (N - 1) / 2;
     size_t elementSize = (dtype_enum == 0) ? 4 : 2;
 
+    // 参与 DMA 的 staging buffer 与 device buffer 都从池中取: pinned 内存拷贝更快，重复调用时按尺寸类复用
+    pdist::PdistMemoryPool pool;
     void* xHost = malloc(inputSize * elementSize);
-    void* yHost = malloc(outputSize * elementSize);
     void* yRefHost = malloc(outputSize * elementSize);
+    void* xStorageHost = nullptr;
+    void* yHost = nullptr;
+    CHECK_RET(pool.Acquire(pdist::POOL_HOST_PINNED, storageSize * elementSize, &xStorageHost) == ACL_SUCCESS, return -1);
+    CHECK_RET(pool.Acquire(pdist::POOL_HOST_PINNED, outputSize * elementSize, &yHost) == ACL_SUCCESS, return -1);
 
     void* xDevice = nullptr;
     void* yDevice = nullptr;
-    CHECK_RET(aclrtMalloc(&xDevice, inputSize * elementSize, ACL_MEM_MALLOC_HUGE_FIRST) == ACL_SUCCESS, return -1);
-    CHECK_RET(aclrtMalloc(&yDevice, outputSize * elementSize, ACL_MEM_MALLOC_HUGE_FIRST) == ACL_SUCCESS, return -1);
+    CHECK_RET(pool.Acquire(pdist::POOL_DEVICE, storageSize * elementSize, &xDevice) == ACL_SUCCESS, return -1);
+    CHECK_RET(pool.Acquire(pdist::POOL_DEVICE, outputSize * elementSize, &yDevice) == ACL_SUCCESS, return -1);
 
     std::mt19937 gen(2023);
     std::uniform_real_distribution<float> dis(-10.0, 10.0);
@@ -154,8 +98,13 @@ int main(int argc, char** argv) {
         uint16_t* xF16 = (uint16_t*)xHost;
         for (int64_t i = 0; i < inputSize; i++) xF16[i] = aclFloatToFloat16(dis(gen));
     }
+    // 宽矩阵: 每行前 M 列为 x，其余列为视图外的数据
+    memset(xStorageHost, 0x7f, storageSize * elementSize);
+    for (int64_t i = 0; i < N; i++) {
+        memcpy((char*)xStorageHost + i * rowStride * elementSize, (char*)xHost + i * M * elementSize, M * elementSize);
+    }
 
-    CHECK_RET(aclrtMemcpy(xDevice, inputSize * elementSize, xHost, inputSize * elementSize, ACL_MEMCPY_HOST_TO_DEVICE) == ACL_SUCCESS, return -1);
+    CHECK_RET(aclrtMemcpy(xDevice, storageSize * elementSize, xStorageHost, storageSize * elementSize, ACL_MEMCPY_HOST_TO_DEVICE) == ACL_SUCCESS, return -1);
 
     // CPU 计算
     std::cout << "[INFO] Starting CPU calculation..." << std::endl;
@@ -172,21 +121,28 @@ int main(int argc, char** argv) {
     // NPU 计算
     aclDataType aclType = (dtype_enum == 0) ? ACL_FLOAT : ACL_FLOAT16;
     int64_t inputShape[] = {N, M};
+    int64_t inputStrides[] = {rowStride, 1};
+    int64_t storageShape[] = {N, rowStride};
     int64_t outputShape[] = {outputSize};
-    aclTensor* xTensor = aclCreateTensor(inputShape, 2, aclType, nullptr, 0, aclFormat::ACL_FORMAT_ND, inputShape, 2, xDevice);
+    aclTensor* xTensor = aclCreateTensor(inputShape, 2, aclType, inputStrides, 0, aclFormat::ACL_FORMAT_ND, storageShape, 2, xDevice);
     aclTensor* yTensor = aclCreateTensor(outputShape, 1, aclType, nullptr, 0, aclFormat::ACL_FORMAT_ND, outputShape, 1, yDevice);
 
     uint64_t workspaceSize = 0;
     aclOpExecutor* executor;
-    CHECK_RET(aclnnPdistGetWorkspaceSize(xTensor, p, yTensor, &workspaceSize, &executor) == ACL_SUCCESS, return -1);
+    char nanPolicy[] = "propagate";
+    CHECK_RET(aclnnPdistGetWorkspaceSize(xTensor, nullptr, p, nanPolicy, yTensor, nullptr, &workspaceSize, &executor) == ACL_SUCCESS, return -1);
 
     void* workspaceAddr = nullptr;
-    if (workspaceSize > 0) CHECK_RET(aclrtMalloc(&workspaceAddr, workspaceSize, ACL_MEM_MALLOC_HUGE_FIRST) == ACL_SUCCESS, return -1);
+    CHECK_RET(pool.Acquire(pdist::POOL_DEVICE, workspaceSize, &workspaceAddr) == ACL_SUCCESS, return -1);
 
     // Warmup
     aclnnPdist(workspaceAddr, workspaceSize, executor, stream);
     aclrtSynchronizeStream(stream);
 
+#ifdef PDIST_PROFILE
+    CHECK_RET(pdist::ResetPdistProfile(workspaceAddr, workspaceSize, stream) == ACL_SUCCESS, return -1);
+#endif
+
     auto start_npu = std::chrono::high_resolution_clock::now();
     CHECK_RET(aclnnPdist(workspaceAddr, workspaceSize, executor, stream) == ACL_SUCCESS, return -1);
     CHECK_RET(aclrtSynchronizeStream(stream) == ACL_SUCCESS, return -1);
@@ -197,11 +153,18 @@ int main(int argc, char** argv) {
 
     if (cpu_time_ms > 0) std::cout << "\033[1;36m[PERF] Speedup: " << (cpu_time_ms / npu_time_ms) << "x \033[0m" << std::endl;
 
+#ifdef PDIST_PROFILE
+    // Kernel 侧每核计数 (需要 PdistOp 以 ENABLE_PDIST_PROFILE=True 构建)
+    std::vector<pdist::PdistProfileRecord> profile;
+    CHECK_RET(pdist::ReadPdistProfile(workspaceAddr, workspaceSize, profile) == ACL_SUCCESS, return -1);
+    pdist::PrintPdistProfile(profile, stdout);
+#endif
+
     CHECK_RET(aclrtMemcpy(yHost, outputSize * elementSize, yDevice, outputSize * elementSize, ACL_MEMCPY_DEVICE_TO_HOST) == ACL_SUCCESS, return -1);
 
     bool pass = true;
     if (dtype_enum == 0) {
-        pass = check_accuracy<float>((float*)yRefHost, (float*)yHost, outputSize, p);
+        pass = check_accuracy<float>((float*)yRefHost, (float*)yHost, outputSize);
     } else {
         std::cout << "[WARN] FP16 strict accuracy check skipped in C++." << std::endl;
     }
@@ -210,11 +173,13 @@ int main(int argc, char** argv) {
 
     aclDestroyTensor(xTensor);
     aclDestroyTensor(yTensor);
-    if (workspaceSize > 0) aclrtFree(workspaceAddr);
-    aclrtFree(xDevice);
-    aclrtFree(yDevice);
+    pool.Release(workspaceAddr);
+    pool.Release(xDevice);
+    pool.Release(yDevice);
+    pool.Release(xStorageHost);
+    pool.Release(yHost);
+    pool.Trim();
     free(xHost);
-    free(yHost);
     free(yRefHost);
     aclrtDestroyStream(stream);
     aclFinalize();
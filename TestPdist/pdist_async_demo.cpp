@@ -0,0 +1,112 @@
+/**
+ * @file pdist_async_demo.cpp
+ * @brief PdistAsyncExecutor 测试程序: 一次提交多个不同 n 的请求 (多于 stream 数，在途请求相互重叠并排队)，
+ *        全部完成后逐个与 cpu_pdist 比对
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <future>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "acl/acl.h"
+#include "pdist_async.h"
+#include "pdist_golden.h"
+#include "pdist_pool.h"
+
+#define CHECK_RET(cond, return_expr) \
+  do {                               \
+    if (!(cond)) {                   \
+      return_expr;                   \
+    }                                \
+  } while (0)
+
+#define LOG_PRINT(message, ...)     \
+  do {                              \
+    printf(message, ##__VA_ARGS__); \
+  } while (0)
+
+int main() {
+    const uint64_t M = 64;
+    const float P = 2.0f;
+    // 请求数多于 streamNum: 前 streamNum 个并行在途，其余在 Submit 内等待空闲 stream
+    const uint64_t requestRows[] = {257, 17, 1024, 33, 600, 2, 129};
+    const size_t requestNum = sizeof(requestRows) / sizeof(requestRows[0]);
+
+    int32_t deviceId = 0;
+    CHECK_RET(aclInit(nullptr) == ACL_SUCCESS, return -1);
+    CHECK_RET(aclrtSetDevice(deviceId) == ACL_SUCCESS, return -1);
+
+    pdist::AsyncConfig config;
+    config.deviceId = deviceId;
+    config.streamNum = 3;
+
+    bool pass = true;
+    {
+        pdist::PdistMemoryPool pool;
+        pdist::PdistAsyncExecutor executor(config, ACL_FLOAT, M, P);
+
+        // 每个请求独占一组 pinned 输入 / 输出 buffer，登记后才能提交
+        std::vector<void*> xHost(requestNum, nullptr);
+        std::vector<void*> yHost(requestNum, nullptr);
+        std::mt19937 gen(2023);
+        std::uniform_real_distribution<float> dis(-10.0, 10.0);
+        for (size_t r = 0; r < requestNum; r++) {
+            uint64_t xBytes = requestRows[r] * M * sizeof(float);
+            uint64_t yBytes = pdist::CondensedSize(requestRows[r]) * sizeof(float);
+            CHECK_RET(pool.Acquire(pdist::POOL_HOST_PINNED, xBytes, &xHost[r]) == ACL_SUCCESS, return -1);
+            CHECK_RET(pool.Acquire(pdist::POOL_HOST_PINNED, yBytes, &yHost[r]) == ACL_SUCCESS, return -1);
+            CHECK_RET(executor.RegisterHostBuffer(xHost[r], xBytes) == ACL_SUCCESS, return -1);
+            CHECK_RET(executor.RegisterHostBuffer(yHost[r], yBytes) == ACL_SUCCESS, return -1);
+            float* x = static_cast<float*>(xHost[r]);
+            for (uint64_t k = 0; k < requestRows[r] * M; k++) x[k] = dis(gen);
+        }
+
+        // 全部提交后再统一等待，回调只计数 (在回调线程中执行)
+        std::atomic<uint32_t> callbackCount(0);
+        std::vector<std::future<aclError>> futures;
+        for (size_t r = 0; r < requestNum; r++) {
+            pdist::AsyncRequest request = {xHost[r], yHost[r], requestRows[r]};
+            futures.push_back(executor.Submit(request, [&callbackCount](aclError, const pdist::AsyncRequest&) {
+                callbackCount++;
+            }));
+        }
+        executor.WaitAll();
+
+        for (size_t r = 0; r < requestNum; r++) {
+            aclError status = futures[r].get();
+            uint64_t n = requestRows[r];
+            uint64_t outputSize = pdist::CondensedSize(n);
+            LOG_PRINT(">>> Request %zu: N=%llu, M=%llu, status=%d\n", r, (unsigned long long)n,
+                      (unsigned long long)M, static_cast<int>(status));
+            if (status != ACL_SUCCESS) {
+                pass = false;
+                continue;
+            }
+            std::vector<float> yRef(outputSize);
+            cpu_pdist<float>(static_cast<float*>(xHost[r]), yRef.data(), n, M, P);
+            if (!check_accuracy<float>(yRef.data(), static_cast<float*>(yHost[r]), outputSize)) {
+                pass = false;
+            }
+        }
+        if (callbackCount.load() != requestNum) {
+            LOG_PRINT("[ERROR] %u callback(s) for %zu request(s)\n", callbackCount.load(), requestNum);
+            pass = false;
+        }
+
+        for (size_t r = 0; r < requestNum; r++) {
+            executor.UnregisterHostBuffer(xHost[r]);
+            executor.UnregisterHostBuffer(yHost[r]);
+            pool.Release(xHost[r]);
+            pool.Release(yHost[r]);
+        }
+        pool.Trim();
+    }
+
+    std::cout << (pass ? "\033[32m[PASS]\033[0m" : "\033[31m[FAIL]\033[0m") << std::endl;
+
+    aclrtResetDevice(deviceId);
+    aclFinalize();
+    return pass ? 0 : 1;
+}
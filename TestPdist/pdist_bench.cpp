@@ -0,0 +1,505 @@
+/**
+ * @file pdist_bench.cpp
+ * @brief Pdist 性能基准: 在 (n, m, p, dtype, metric) 网格上扫描，用 device event 计时
+ *
+ * 每个配置先预热，再逐次用一对 aclrtEvent 包住 aclnnPdist，统计 median / p99 延迟，
+ * 并换算成 pairs/s、有效 GB/s 与 GFLOP/s。结果打印到终端，并可写成 CSV / JSON，
+ * 通过 --tag 标记 kernel 版本，用于跨版本回归对比。
+ *
+ * Roofline: 每个配置按 Host 的切分规则 (pdist_tiling_plan.h) 估算 GM 字节数与计算量，
+ * 与 PlatformAscendC 给出的平台峰值 (GM 带宽、Vector / Cube 算力) 比较，
+ * 给出所在 tilingKey 路径的算术强度、可达上限与受限类型 (memory / compute)。
+ * plot_roofline.py 可将 JSON 结果画成 roofline 图。
+ *
+ * 用法示例:
+ *   ./pdist_bench --n 1024,4096 --m 32,128,1024 --metric l1,l2,linf --dtype fp32,fp16 \
+ *                 --iters 100 --csv bench.csv --json bench.json --tag baseline
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "acl/acl.h"
+#include "aclnn_pdist.h"
+#include "pdist_tuning.h"
+#include "tiling/platform/platform_ascendc.h"
+
+#define CHECK_RET(cond, return_expr) \
+  do {                               \
+    if (!(cond)) {                   \
+      return_expr;                   \
+    }                                \
+  } while (0)
+
+#define LOG_PRINT(message, ...)     \
+  do {                              \
+    printf(message, ##__VA_ARGS__); \
+  } while (0)
+
+// =========================================================
+// 配置解析
+// =========================================================
+struct BenchOptions {
+    std::vector<int64_t> ns = {1024, 4096};
+    std::vector<int64_t> ms = {32, 128, 1024};
+    std::vector<float> ps = {2.0f};
+    std::vector<std::string> dtypes = {"fp32"};
+    std::vector<std::string> metrics = {"minkowski"};
+    int warmup = 5;
+    int iters = 50;
+    int32_t deviceId = 0;
+    std::string csvPath;
+    std::string jsonPath;
+    std::string tag = "dev";
+    // 平台主频 (GHz)，用于把每周期带宽 / 算力换算成每秒
+    double freqGhz = 1.8;
+    // 非 0 时覆盖查询到的 GM 峰值带宽 (GB/s)
+    double peakGbps = 0.0;
+};
+
+// Vector 单元每周期处理 256B，kernel 统一在 float 上计算
+constexpr double VECTOR_FP32_OPS_PER_CYCLE = 64.0;
+// Cube 单元每周期 16x16x16 个 FP16 MAC
+constexpr double CUBE_FP16_FLOPS_PER_CYCLE = 2.0 * 16 * 16 * 16;
+
+struct PlatformPeak {
+    uint32_t coreNumAic;
+    uint32_t coreNumAiv;
+    uint64_t ubSize;
+    uint64_t l2Size;
+    double gmBytesPerSec;
+    double vectorFlops;
+    double cubeFlops;
+};
+
+struct BenchConfig {
+    std::string metric;
+    std::string dtype;
+    int64_t n;
+    int64_t m;
+    float p;
+};
+
+struct BenchResult {
+    BenchConfig cfg;
+    int iters;
+    double medianMs;
+    double p99Ms;
+    double meanMs;
+    double minMs;
+    double pairsPerSec;
+    double gbPerSec;
+    double gflopPerSec;
+
+    // Roofline
+    uint32_t tilingKey;
+    uint32_t cores;
+    double modelBytes;
+    double modelFlops;
+    double intensity;        // FLOP / Byte
+    double attainableGflops; // min(算力峰值, 强度 x 带宽峰值)
+    double rooflinePct;      // 实测 GFLOP/s 占可达上限的比例
+    const char* bound;
+};
+
+static std::vector<std::string> SplitList(const std::string& s) {
+    std::vector<std::string> out;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t pos = s.find(',', start);
+        if (pos == std::string::npos) {
+            pos = s.size();
+        }
+        if (pos > start) {
+            out.push_back(s.substr(start, pos - start));
+        }
+        start = pos + 1;
+    }
+    return out;
+}
+
+static float ParseP(const std::string& s) {
+    if (s == "inf" || s == "INF") {
+        return std::numeric_limits<float>::infinity();
+    }
+    return static_cast<float>(std::atof(s.c_str()));
+}
+
+static void PrintUsage(const char* prog) {
+    LOG_PRINT("Usage: %s [--n LIST] [--m LIST] [--p LIST] [--dtype fp32,fp16] [--metric LIST]\n"
+              "          [--warmup N] [--iters N] [--device ID] [--csv FILE] [--json FILE] [--tag NAME]\n"
+              "          [--freq-ghz F] [--peak-gbps B]\n"
+              "  metric: minkowski (uses --p), l1, l2, linf\n", prog);
+}
+
+static bool ParseArgs(int argc, char** argv, BenchOptions& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string key = argv[i];
+        if (key == "-h" || key == "--help" || i + 1 >= argc) {
+            return false;
+        }
+        std::string val = argv[++i];
+        if (key == "--n" || key == "--m") {
+            std::vector<int64_t>& dst = (key == "--n") ? opt.ns : opt.ms;
+            dst.clear();
+            for (const std::string& v : SplitList(val)) {
+                dst.push_back(std::atol(v.c_str()));
+            }
+        } else if (key == "--p") {
+            opt.ps.clear();
+            for (const std::string& v : SplitList(val)) {
+                opt.ps.push_back(ParseP(v));
+            }
+        } else if (key == "--dtype") {
+            opt.dtypes = SplitList(val);
+        } else if (key == "--metric") {
+            opt.metrics = SplitList(val);
+        } else if (key == "--warmup") {
+            opt.warmup = std::atoi(val.c_str());
+        } else if (key == "--iters") {
+            opt.iters = std::atoi(val.c_str());
+        } else if (key == "--device") {
+            opt.deviceId = std::atoi(val.c_str());
+        } else if (key == "--csv") {
+            opt.csvPath = val;
+        } else if (key == "--json") {
+            opt.jsonPath = val;
+        } else if (key == "--tag") {
+            opt.tag = val;
+        } else if (key == "--freq-ghz") {
+            opt.freqGhz = std::atof(val.c_str());
+        } else if (key == "--peak-gbps") {
+            opt.peakGbps = std::atof(val.c_str());
+        } else {
+            return false;
+        }
+    }
+    return opt.iters > 0 && opt.warmup >= 0;
+}
+
+// metric 决定 p: l1 / l2 / linf 为固定 p，minkowski 展开 --p 列表
+static std::vector<BenchConfig> BuildGrid(const BenchOptions& opt) {
+    std::vector<BenchConfig> grid;
+    for (const std::string& metric : opt.metrics) {
+        std::vector<float> ps;
+        if (metric == "l1") {
+            ps.push_back(1.0f);
+        } else if (metric == "l2") {
+            ps.push_back(2.0f);
+        } else if (metric == "linf") {
+            ps.push_back(std::numeric_limits<float>::infinity());
+        } else if (metric == "minkowski") {
+            ps = opt.ps;
+        } else {
+            LOG_PRINT("[WARN] unknown metric %s skipped\n", metric.c_str());
+            continue;
+        }
+        for (const std::string& dtype : opt.dtypes) {
+            for (int64_t n : opt.ns) {
+                for (int64_t m : opt.ms) {
+                    for (float p : ps) {
+                        grid.push_back({metric, dtype, n, m, p});
+                    }
+                }
+            }
+        }
+    }
+    return grid;
+}
+
+// =========================================================
+// 平台峰值
+// =========================================================
+static void QueryPlatformPeak(const BenchOptions& opt, PlatformPeak& peak) {
+    std::memset(&peak, 0, sizeof(peak));
+    platform_ascendc::PlatformAscendC* platform = platform_ascendc::PlatformAscendCManager::GetInstance();
+    uint64_t hbmBytesPerCycle = 0;
+    if (platform != nullptr) {
+        peak.coreNumAic = platform->GetCoreNumAic();
+        peak.coreNumAiv = platform->GetCoreNumAiv();
+        platform->GetCoreMemBw(platform_ascendc::CoreMemType::HBM, hbmBytesPerCycle);
+        platform->GetCoreMemSize(platform_ascendc::CoreMemType::UB, peak.ubSize);
+        platform->GetCoreMemSize(platform_ascendc::CoreMemType::L2, peak.l2Size);
+    } else {
+        LOG_PRINT("[WARN] PlatformAscendC unavailable, roofline columns will be empty\n");
+    }
+    double hz = opt.freqGhz * 1e9;
+    peak.gmBytesPerSec = (opt.peakGbps > 0) ? opt.peakGbps * 1e9 : hbmBytesPerCycle * hz;
+    peak.vectorFlops = peak.coreNumAiv * VECTOR_FP32_OPS_PER_CYCLE * hz;
+    peak.cubeFlops = peak.coreNumAic * CUBE_FP16_FLOPS_PER_CYCLE * hz;
+    LOG_PRINT("[PLATFORM] AIC=%u AIV=%u GM=%.1f GB/s Vector=%.1f GFLOP/s Cube=%.1f GFLOP/s (%.2f GHz)\n",
+              peak.coreNumAic, peak.coreNumAiv, peak.gmBytesPerSec / 1e9, peak.vectorFlops / 1e9,
+              peak.cubeFlops / 1e9, opt.freqGhz);
+}
+
+// =========================================================
+// 统计与换算
+// =========================================================
+static double Percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t idx = static_cast<size_t>(std::ceil(q * sorted.size())) - 1;
+    return sorted[std::min(idx, sorted.size() - 1)];
+}
+
+static void Summarize(const BenchConfig& cfg, const PlatformPeak& peak, std::vector<double>& timesMs,
+                      BenchResult& r) {
+    std::sort(timesMs.begin(), timesMs.end());
+    double sum = 0.0;
+    for (double t : timesMs) {
+        sum += t;
+    }
+    r.cfg = cfg;
+    r.iters = static_cast<int>(timesMs.size());
+    r.medianMs = Percentile(timesMs, 0.5);
+    r.p99Ms = Percentile(timesMs, 0.99);
+    r.meanMs = sum / timesMs.size();
+    r.minMs = timesMs.front();
+
+    double elementSize = (cfg.dtype == "fp16") ? 2.0 : 4.0;
+    double pairs = static_cast<double>(cfg.n) * (cfg.n - 1) / 2.0;
+    // 有效带宽按算法下限计: 读一遍 x，写一遍压缩输出
+    double bytes = (static_cast<double>(cfg.n) * cfg.m + pairs) * elementSize;
+    double flops = pairs * cfg.m * optiling::PdistFlopsPerElement(optiling::PdistPClassOf(cfg.p));
+    double sec = r.medianMs / 1e3;
+    r.pairsPerSec = (sec > 0) ? pairs / sec : 0.0;
+    r.gbPerSec = (sec > 0) ? bytes / sec / 1e9 : 0.0;
+    r.gflopPerSec = (sec > 0) ? flops / sec / 1e9 : 0.0;
+
+    // Roofline: 按 TilingFunc 的规则复现切分，估算该 tilingKey 路径实际搬运的字节数
+    optiling::PdistTilingInput in;
+    in.n = static_cast<uint32_t>(cfg.n);
+    in.m = static_cast<uint32_t>(cfg.m);
+    in.p = cfg.p;
+    in.typeSize = static_cast<uint32_t>(elementSize);
+    in.coreNumAic = (peak.coreNumAic > 0) ? peak.coreNumAic : 1;
+    in.coreNumAiv = (peak.coreNumAiv > 0) ? peak.coreNumAiv : 1;
+    in.ubSize = peak.ubSize;
+    in.l2Size = peak.l2Size;
+    in.rowStride = 0;
+    in.indexSize = 0;
+    in.nanPolicy = optiling::PDIST_NAN_PROPAGATE;
+    in.validityOut = 0;
+    // 与 TilingFunc 相同的参数来源: PDIST_TILING_OVERRIDE > 调优表 > 启发式
+    optiling::PdistBlockParams tuned;
+    bool hasTuned = optiling::GetPdistTilingOverride(tuned) || optiling::LookupPdistTuning(in, tuned);
+    optiling::PdistTilingPlan plan = optiling::PlanPdistTiling(in, hasTuned ? &tuned : nullptr);
+    optiling::PdistCostModel cost = optiling::EstimatePdistCost(plan, in.typeSize);
+    r.tilingKey = plan.tilingKey;
+    r.cores = plan.blockDim;
+    r.modelBytes = cost.bytesMoved;
+    r.modelFlops = cost.flops;
+    r.intensity = (cost.bytesMoved > 0) ? cost.flops / cost.bytesMoved : 0.0;
+    double computePeak = cost.usesCube ? peak.cubeFlops : peak.vectorFlops;
+    double memoryRoof = r.intensity * peak.gmBytesPerSec;
+    r.attainableGflops = std::min(computePeak, memoryRoof) / 1e9;
+    r.bound = (computePeak <= 0 || peak.gmBytesPerSec <= 0) ? "n/a" : (memoryRoof < computePeak ? "memory" : "compute");
+    double modelGflops = (sec > 0) ? cost.flops / sec / 1e9 : 0.0;
+    r.rooflinePct = (r.attainableGflops > 0) ? 100.0 * modelGflops / r.attainableGflops : 0.0;
+}
+
+// =========================================================
+// 单个配置
+// =========================================================
+static bool RunConfig(const BenchConfig& cfg, const BenchOptions& opt, const PlatformPeak& peak, aclrtStream stream,
+                      BenchResult& result) {
+    bool isHalf = (cfg.dtype == "fp16");
+    size_t elementSize = isHalf ? 2 : 4;
+    int64_t inputSize = cfg.n * cfg.m;
+    int64_t outputSize = cfg.n * (cfg.n - 1) / 2;
+
+    std::vector<uint8_t> xHost(inputSize * elementSize);
+    std::mt19937 gen(2023);
+    std::uniform_real_distribution<float> dis(-10.0, 10.0);
+    for (int64_t i = 0; i < inputSize; i++) {
+        if (isHalf) {
+            reinterpret_cast<uint16_t*>(xHost.data())[i] = aclFloatToFloat16(dis(gen));
+        } else {
+            reinterpret_cast<float*>(xHost.data())[i] = dis(gen);
+        }
+    }
+
+    void* xDevice = nullptr;
+    void* yDevice = nullptr;
+    void* workspaceAddr = nullptr;
+    aclTensor* xTensor = nullptr;
+    aclTensor* yTensor = nullptr;
+    aclOpExecutor* executor = nullptr;
+    aclrtEvent startEvent = nullptr;
+    aclrtEvent endEvent = nullptr;
+    uint64_t workspaceSize = 0;
+    bool ok = false;
+    std::vector<double> timesMs;
+
+    do {
+        CHECK_RET(aclrtMalloc(&xDevice, inputSize * elementSize, ACL_MEM_MALLOC_HUGE_FIRST) == ACL_SUCCESS, break);
+        CHECK_RET(aclrtMalloc(&yDevice, outputSize * elementSize, ACL_MEM_MALLOC_HUGE_FIRST) == ACL_SUCCESS, break);
+        CHECK_RET(aclrtMemcpy(xDevice, inputSize * elementSize, xHost.data(), inputSize * elementSize,
+                              ACL_MEMCPY_HOST_TO_DEVICE) == ACL_SUCCESS, break);
+
+        aclDataType aclType = isHalf ? ACL_FLOAT16 : ACL_FLOAT;
+        int64_t inputShape[] = {cfg.n, cfg.m};
+        int64_t outputShape[] = {outputSize};
+        xTensor = aclCreateTensor(inputShape, 2, aclType, nullptr, 0, aclFormat::ACL_FORMAT_ND, inputShape, 2, xDevice);
+        yTensor = aclCreateTensor(outputShape, 1, aclType, nullptr, 0, aclFormat::ACL_FORMAT_ND, outputShape, 1,
+                                  yDevice);
+        CHECK_RET(xTensor != nullptr && yTensor != nullptr, break);
+
+        // 同一个 executor 反复下发，避免把 GetWorkspaceSize (Tiling) 的开销算进 kernel 时间
+        char nanPolicy[] = "propagate";
+        CHECK_RET(aclnnPdistGetWorkspaceSize(xTensor, nullptr, cfg.p, nanPolicy, yTensor, nullptr, &workspaceSize,
+                                             &executor) == ACL_SUCCESS,
+                  break);
+        CHECK_RET(aclSetAclOpExecutorRepeatable(executor) == ACL_SUCCESS, break);
+        if (workspaceSize > 0) {
+            CHECK_RET(aclrtMalloc(&workspaceAddr, workspaceSize, ACL_MEM_MALLOC_HUGE_FIRST) == ACL_SUCCESS, break);
+        }
+        CHECK_RET(aclrtCreateEvent(&startEvent) == ACL_SUCCESS, break);
+        CHECK_RET(aclrtCreateEvent(&endEvent) == ACL_SUCCESS, break);
+
+        bool launchOk = true;
+        for (int i = 0; i < opt.warmup && launchOk; ++i) {
+            launchOk = aclnnPdist(workspaceAddr, workspaceSize, executor, stream) == ACL_SUCCESS;
+        }
+        CHECK_RET(launchOk && aclrtSynchronizeStream(stream) == ACL_SUCCESS, break);
+
+        for (int i = 0; i < opt.iters && launchOk; ++i) {
+            float ms = 0.0f;
+            launchOk = aclrtRecordEvent(startEvent, stream) == ACL_SUCCESS &&
+                       aclnnPdist(workspaceAddr, workspaceSize, executor, stream) == ACL_SUCCESS &&
+                       aclrtRecordEvent(endEvent, stream) == ACL_SUCCESS &&
+                       aclrtSynchronizeEvent(endEvent) == ACL_SUCCESS &&
+                       aclrtEventElapsedTime(&ms, startEvent, endEvent) == ACL_SUCCESS;
+            timesMs.push_back(ms);
+        }
+        CHECK_RET(launchOk, break);
+        ok = true;
+    } while (0);
+
+    if (ok) {
+        Summarize(cfg, peak, timesMs, result);
+    }
+    if (startEvent != nullptr) aclrtDestroyEvent(startEvent);
+    if (endEvent != nullptr) aclrtDestroyEvent(endEvent);
+    if (executor != nullptr) aclDestroyAclOpExecutor(executor);
+    if (xTensor != nullptr) aclDestroyTensor(xTensor);
+    if (yTensor != nullptr) aclDestroyTensor(yTensor);
+    if (workspaceAddr != nullptr) aclrtFree(workspaceAddr);
+    if (xDevice != nullptr) aclrtFree(xDevice);
+    if (yDevice != nullptr) aclrtFree(yDevice);
+    return ok;
+}
+
+// =========================================================
+// 输出
+// =========================================================
+static std::string FormatP(float p) {
+    if (std::isinf(p)) {
+        return "inf";
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%g", p);
+    return buf;
+}
+
+static void WriteCsv(const std::string& path, const BenchOptions& opt, const std::vector<BenchResult>& results) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        LOG_PRINT("[ERROR] cannot open %s\n", path.c_str());
+        return;
+    }
+    fprintf(f, "tag,metric,dtype,n,m,p,iters,median_ms,p99_ms,mean_ms,min_ms,pairs_per_s,gb_per_s,gflop_per_s,"
+               "tiling_key,cores,model_bytes,model_flops,intensity,attainable_gflops,roofline_pct,bound\n");
+    for (const BenchResult& r : results) {
+        fprintf(f, "%s,%s,%s,%lld,%lld,%s,%d,%.6f,%.6f,%.6f,%.6f,%.6e,%.3f,%.3f,%u,%u,%.6e,%.6e,%.4f,%.3f,%.2f,%s\n",
+                opt.tag.c_str(), r.cfg.metric.c_str(), r.cfg.dtype.c_str(), (long long)r.cfg.n, (long long)r.cfg.m,
+                FormatP(r.cfg.p).c_str(), r.iters, r.medianMs, r.p99Ms, r.meanMs, r.minMs, r.pairsPerSec,
+                r.gbPerSec, r.gflopPerSec, r.tilingKey, r.cores, r.modelBytes, r.modelFlops, r.intensity,
+                r.attainableGflops, r.rooflinePct, r.bound);
+    }
+    fclose(f);
+}
+
+static void WriteJson(const std::string& path, const BenchOptions& opt, const PlatformPeak& peak,
+                      const std::vector<BenchResult>& results) {
+    FILE* f = fopen(path.c_str(), "w");
+    if (f == nullptr) {
+        LOG_PRINT("[ERROR] cannot open %s\n", path.c_str());
+        return;
+    }
+    fprintf(f, "{\n  \"tag\": \"%s\",\n  \"warmup\": %d,\n", opt.tag.c_str(), opt.warmup);
+    fprintf(f, "  \"platform\": {\"aic\": %u, \"aiv\": %u, \"freq_ghz\": %.3f, \"gm_gbps\": %.3f, "
+               "\"vector_gflops\": %.3f, \"cube_gflops\": %.3f},\n  \"results\": [\n",
+            peak.coreNumAic, peak.coreNumAiv, opt.freqGhz, peak.gmBytesPerSec / 1e9, peak.vectorFlops / 1e9,
+            peak.cubeFlops / 1e9);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        // JSON 没有 inf，p 以字符串保存
+        fprintf(f,
+                "    {\"metric\": \"%s\", \"dtype\": \"%s\", \"n\": %lld, \"m\": %lld, \"p\": \"%s\", "
+                "\"iters\": %d, \"median_ms\": %.6f, \"p99_ms\": %.6f, \"mean_ms\": %.6f, \"min_ms\": %.6f, "
+                "\"pairs_per_s\": %.6e, \"gb_per_s\": %.3f, \"gflop_per_s\": %.3f, "
+                "\"tiling_key\": %u, \"cores\": %u, \"model_bytes\": %.6e, \"model_flops\": %.6e, "
+                "\"intensity\": %.4f, \"attainable_gflops\": %.3f, \"roofline_pct\": %.2f, \"bound\": \"%s\"}%s\n",
+                r.cfg.metric.c_str(), r.cfg.dtype.c_str(), (long long)r.cfg.n, (long long)r.cfg.m,
+                FormatP(r.cfg.p).c_str(), r.iters, r.medianMs, r.p99Ms, r.meanMs, r.minMs, r.pairsPerSec,
+                r.gbPerSec, r.gflopPerSec, r.tilingKey, r.cores, r.modelBytes, r.modelFlops, r.intensity,
+                r.attainableGflops, r.rooflinePct, r.bound, (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    if (!ParseArgs(argc, argv, opt)) {
+        PrintUsage(argv[0]);
+        return -1;
+    }
+    std::vector<BenchConfig> grid = BuildGrid(opt);
+
+    CHECK_RET(aclInit(nullptr) == ACL_SUCCESS, return -1);
+    CHECK_RET(aclrtSetDevice(opt.deviceId) == ACL_SUCCESS, return -1);
+    aclrtStream stream;
+    CHECK_RET(aclrtCreateStream(&stream) == ACL_SUCCESS, return -1);
+    PlatformPeak peak;
+    QueryPlatformPeak(opt, peak);
+
+    LOG_PRINT("%-10s %-5s %7s %7s %5s %11s %11s %12s %9s %10s %4s %8s %8s %-7s\n", "metric", "dtype", "n", "m", "p",
+              "median(ms)", "p99(ms)", "pairs/s", "GB/s", "GFLOP/s", "key", "FLOP/B", "roof%", "bound");
+    std::vector<BenchResult> results;
+    int failed = 0;
+    for (const BenchConfig& cfg : grid) {
+        BenchResult r;
+        if (!RunConfig(cfg, opt, peak, stream, r)) {
+            LOG_PRINT("[ERROR] %s %s n=%lld m=%lld p=%s failed\n", cfg.metric.c_str(), cfg.dtype.c_str(),
+                      (long long)cfg.n, (long long)cfg.m, FormatP(cfg.p).c_str());
+            failed++;
+            continue;
+        }
+        LOG_PRINT("%-10s %-5s %7lld %7lld %5s %11.4f %11.4f %12.4e %9.2f %10.2f %4u %8.3f %8.2f %-7s\n",
+                  cfg.metric.c_str(), cfg.dtype.c_str(), (long long)cfg.n, (long long)cfg.m, FormatP(cfg.p).c_str(),
+                  r.medianMs, r.p99Ms, r.pairsPerSec, r.gbPerSec, r.gflopPerSec, r.tilingKey, r.intensity,
+                  r.rooflinePct, r.bound);
+        results.push_back(r);
+    }
+
+    if (!opt.csvPath.empty()) {
+        WriteCsv(opt.csvPath, opt, results);
+    }
+    if (!opt.jsonPath.empty()) {
+        WriteJson(opt.jsonPath, opt, peak, results);
+    }
+
+    aclrtDestroyStream(stream);
+    aclrtResetDevice(opt.deviceId);
+    aclFinalize();
+    return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file pdist_golden.h
+ * @brief CPU golden reference and accuracy check for Pdist, shared by the NPU test (main.cpp)
+ *        and the CPU simulation regression test (PdistOp/testcases/cpu_sim)
+ */
+
+#ifndef PDIST_GOLDEN_H
+#define PDIST_GOLDEN_H
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+// =========================================================
+// CPU 参考实现 (Golden Kernel) - 已修复 P=inf 支持
+// =========================================================
+// nan_policy 同 Pdist 属性: 0 = propagate, 1 = ignore-dimension (跳过任一侧非有限的维度),
+// 2 = mark-row (含非有限值的行参与的 pair 为 NaN)
+template <typename T>
+bool cpu_row_finite(T* x, int64_t row, int64_t m) {
+    for (int64_t k = 0; k < m; k++) {
+        if (!std::isfinite(static_cast<double>(x[row * m + k]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void cpu_pdist(T* x, T* y, int64_t n, int64_t m, float p, int nan_policy = 0) {
+    int64_t out_idx = 0;
+    bool is_inf = std::isinf(p); // 检查 p 是否为无穷大
+
+    for (int64_t i = 0; i < n; i++) {
+        for (int64_t j = i + 1; j < n; j++) {
+            double result = 0.0;
+            
+            if (nan_policy == 2 && (!cpu_row_finite(x, i, m) || !cpu_row_finite(x, j, m))) {
+                y[out_idx++] = static_cast<T>(std::numeric_limits<double>::quiet_NaN());
+                continue;
+            }
+            if (is_inf) {
+                // P = inf: 切比雪夫距离 (取最大差值)
+                double max_diff = 0.0;
+                for (int64_t k = 0; k < m; k++) {
+                    if (nan_policy == 1 && (!std::isfinite(static_cast<double>(x[i * m + k])) ||
+                                            !std::isfinite(static_cast<double>(x[j * m + k])))) {
+                        continue;
+                    }
+                    double diff = std::abs(static_cast<double>(x[i * m + k]) - static_cast<double>(x[j * m + k]));
+                    if (diff > max_diff) {
+                        max_diff = diff;
+                    }
+                }
+                result = max_diff;
+            } else {
+                // P = 其他: 闵可夫斯基距离 (累加 pow)
+                double sum = 0.0;
+                for (int64_t k = 0; k < m; k++) {
+                    if (nan_policy == 1 && (!std::isfinite(static_cast<double>(x[i * m + k])) ||
+                                            !std::isfinite(static_cast<double>(x[j * m + k])))) {
+                        continue;
+                    }
+                    double diff = std::abs(static_cast<double>(x[i * m + k]) - static_cast<double>(x[j * m + k]));
+                    sum += std::pow(diff, static_cast<double>(p));
+                }
+                result = std::pow(sum, 1.0 / p);
+            }
+            
+            y[out_idx++] = static_cast<T>(result);
+        }
+    }
+}
+
+// =========================================================
+// 精度校验工具
+// =========================================================
+template <typename T>
+bool check_accuracy(T* expected, T* actual, int64_t len) {
+    // FP16 输出本身只有约 3 位有效数字；FP32 输出跨段为补偿求和，各 p 统一按 1e-5 比较
+    double epsilon = (sizeof(T) == 2) ? 1e-2 : 1e-5;
+
+    double max_err = 0.0;
+    int64_t err_count = 0;
+
+    for (int64_t i = 0; i < len; ++i) {
+        double val1 = static_cast<double>(expected[i]);
+        double val2 = static_cast<double>(actual[i]);
+        double diff = std::abs(val1 - val2);
+        // NaN 只与 NaN 相符 (nan_policy = mark-row 的期望输出)
+        if (std::isnan(val1) || std::isnan(val2)) {
+            if (std::isnan(val1) != std::isnan(val2)) {
+                if (err_count < 5) {
+                    std::cout << "[ERROR] NaN mismatch at index " << i << ": expected " << val1 << ", got " << val2
+                              << std::endl;
+                }
+                err_count++;
+            }
+            continue;
+        }
+        
+        if (diff > epsilon && diff / (std::abs(val1) + 1e-9) > epsilon) {
+            if (err_count < 5) {
+                std::cout << "[ERROR] Mismatch at index " << i 
+                          << ": expected " << val1 << ", got " << val2 
+                          << ", diff " << diff << std::endl;
+            }
+            err_count++;
+        }
+        if (diff > max_err) max_err = diff;
+    }
+
+    std::cout << "[INFO] Max Abs Error: " << max_err << std::endl;
+    
+    if (err_count > 0) {
+        std::cout << "[FAIL] Total " << err_count << " mismatches found." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+#endif // PDIST_GOLDEN_H
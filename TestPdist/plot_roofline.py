@@ -0,0 +1,82 @@
+import json
+import math
+import sys
+
+# =========================================================
+# 读取 pdist_bench --json 的输出，画 roofline 图
+# 用法: python3 plot_roofline.py bench.json [roofline.png]
+# 没有 matplotlib 时只打印表格
+# =========================================================
+
+
+def load(path):
+    with open(path) as f:
+        return json.load(f)
+
+
+def print_table(data):
+    print(f"{'metric':<10} {'dtype':<5} {'n':>7} {'m':>7} {'p':>5} {'key':>4} "
+          f"{'FLOP/B':>8} {'GFLOP/s':>10} {'roof':>10} {'roof%':>7} bound")
+    for r in data["results"]:
+        print(f"{r['metric']:<10} {r['dtype']:<5} {r['n']:>7} {r['m']:>7} {r['p']:>5} {r['tiling_key']:>4} "
+              f"{r['intensity']:>8.3f} {r['model_flops'] / (r['median_ms'] * 1e6):>10.2f} "
+              f"{r['attainable_gflops']:>10.2f} {r['roofline_pct']:>6.1f}% {r['bound']}")
+
+
+def plot(data, out_path):
+    import matplotlib
+    matplotlib.use("Agg")
+    import matplotlib.pyplot as plt
+
+    peak = data["platform"]
+    bw = peak["gm_gbps"]
+    results = data["results"]
+    if bw <= 0 or not results:
+        print("❌ platform peaks missing, nothing to plot")
+        return
+
+    xs = [r["intensity"] for r in results if r["intensity"] > 0]
+    lo = min(xs + [0.01]) / 4
+    hi = max(xs + [100.0]) * 4
+    grid = [lo * (hi / lo) ** (k / 200.0) for k in range(201)]
+
+    fig, ax = plt.subplots(figsize=(8, 6))
+    for name, roof in (("Vector", peak["vector_gflops"]), ("Cube", peak["cube_gflops"])):
+        if roof > 0:
+            ax.plot(grid, [min(roof, x * bw) for x in grid], label=f"{name} roof ({roof:.0f} GFLOP/s)")
+
+    # 每个 tilingKey 一种颜色
+    keys = sorted({r["tiling_key"] for r in results})
+    cmap = plt.get_cmap("tab10")
+    for idx, key in enumerate(keys):
+        pts = [r for r in results if r["tiling_key"] == key and r["intensity"] > 0]
+        ax.scatter([r["intensity"] for r in pts],
+                   [r["model_flops"] / (r["median_ms"] * 1e6) for r in pts],
+                   color=cmap(idx % 10), label=f"tilingKey {key}", zorder=3)
+
+    ax.set_xscale("log")
+    ax.set_yscale("log")
+    ax.set_xlabel("Arithmetic intensity (FLOP / GM byte)")
+    ax.set_ylabel("GFLOP/s")
+    ax.set_title(f"Pdist roofline [{data['tag']}] GM {bw:.0f} GB/s")
+    ax.grid(True, which="both", alpha=0.3)
+    ax.legend()
+    fig.savefig(out_path, dpi=150, bbox_inches="tight")
+    print(f"✅ Roofline saved to {out_path}")
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("Usage: python3 plot_roofline.py bench.json [roofline.png]")
+        sys.exit(1)
+    data = load(sys.argv[1])
+    print_table(data)
+    out_path = sys.argv[2] if len(sys.argv) > 2 else "roofline.png"
+    try:
+        plot(data, out_path)
+    except ImportError:
+        print("matplotlib not found, table only")
+
+
+if __name__ == "__main__":
+    main()